@@ -0,0 +1,782 @@
+/******************************************************************************
+ * File: tds_bench.c
+ * Author: Tiago Barbosa
+ * Description: Benchmark suite of the TDS library.
+ *              Measures throughput (ops/sec) and per-operation latency
+ *              percentiles (p50/p99/p99.9) of every container and mode,
+ *              sweeping element sizes, capacities and thread counts, and
+ *              writes the results as CSV or JSON.
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tds_deque.h"
+#include "tds_hashtable.h"
+#include "tds_heap.h"
+#include "tds_list.h"
+#include "tds_memory.h"
+#include "tds_queue.h"
+#include "tds_ringbuffer.h"
+#include "tds_stack.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define BENCH_MAX_THREADS      16
+#define BENCH_MAX_ELEMENT_SIZE 256
+#define BENCH_BATCH            8      /**< Elements per call in the batch cases */
+#define BENCH_SCRATCH_HALF     (BENCH_BATCH * BENCH_MAX_ELEMENT_SIZE)
+#define BENCH_LATENCY_SAMPLES  100000 /**< Timed operations per thread for the percentiles */
+#define BENCH_LOOKUPS          32     /**< Keys per call in the batched lookup cases */
+#define BENCH_LARGE_TABLE      (UINT32_C(1) << 22) /**< Entries of the tables that do not fit the last-level cache */
+
+/* Typedefs -----------------------------------------------------------------*/
+
+/**
+ * @brief Containers under test. A case uses the handle matching its container.
+ */
+typedef struct {
+    tds_queue_t      queue;
+    tds_stack_t      stack;
+    tds_ringbuffer_t ring;
+    tds_hashtable_t  table;
+    tds_heap_t       heap;
+    tds_list_t       list;
+    tds_pool_t       pool;
+    tds_arena_t      arena;
+    tds_cache_t      cache;
+    tds_deque_t      deques[BENCH_MAX_THREADS]; /**< One per thread, owned by it */
+    uint32_t         element_size;
+    uint32_t         capacity;
+    uint32_t         threads;
+} bench_ctx_t;
+
+/**
+ * @brief One measured operation. scratch holds 2 * BENCH_SCRATCH_HALF bytes owned by the thread
+ * (source data first, destination second).
+ */
+typedef void (*bench_op_fn)(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch);
+
+/**
+ * @brief Creates the containers of a case (and prefills them); false if unsupported.
+ */
+typedef bool (*bench_setup_fn)(bench_ctx_t* ctx);
+
+typedef struct {
+    const char*    container;
+    const char*    mode;
+    const char*    op;
+    bench_setup_fn setup;
+    bench_op_fn    run;
+    bool           threaded; /**< Swept over thread counts, otherwise single-threaded */
+    uint32_t       threads;  /**< Fixed thread count (0 to follow the sweep) */
+    bool           linear;   /**< One operation walks the whole container: iterations scaled down by capacity */
+    uint32_t       capacity; /**< Fixed capacity (0 to follow the sweep) */
+} bench_case_t;
+
+typedef struct {
+    const bench_case_t* bcase;
+    bench_ctx_t*        ctx;
+    pthread_barrier_t*  barrier;
+    uint32_t            thread;
+    uint64_t            iterations;
+    uint32_t*           samples;
+    uint32_t            sample_count;
+    uint64_t            start_ns;
+    uint64_t            end_ns;
+} bench_thread_t;
+
+typedef struct {
+    double   ops_per_sec;
+    uint32_t p50;
+    uint32_t p99;
+    uint32_t p999;
+} bench_result_t;
+
+/* Private Functions --------------------------------------------------------*/
+
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * UINT64_C(1000000000) + (uint64_t) ts.tv_nsec;
+}
+
+static int bench_compare_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*) a;
+    uint32_t y = *(const uint32_t*) b;
+    return (x > y) - (x < y);
+}
+
+static void* bench_thread_main(void* arg) {
+    bench_thread_t* t      = (bench_thread_t*) arg;
+    uint64_t        warmup = t->iterations / 10;
+    bench_op_fn     run    = t->bcase->run;
+    bench_ctx_t*    ctx    = t->ctx;
+    uint8_t         scratch[2 * BENCH_SCRATCH_HALF];
+
+    memset(scratch, (int) t->thread + 1, sizeof(scratch));
+    for (uint64_t i = 0; i < warmup; i++) {
+        run(ctx, t->thread, i, scratch);
+    }
+
+    // Throughput pass: no timer inside the loop
+    pthread_barrier_wait(t->barrier);
+    t->start_ns = bench_now_ns();
+    for (uint64_t i = 0; i < t->iterations; i++) {
+        run(ctx, t->thread, i, scratch);
+    }
+    t->end_ns = bench_now_ns();
+
+    // Latency pass: every operation timed on its own
+    pthread_barrier_wait(t->barrier);
+    for (uint32_t i = 0; i < t->sample_count; i++) {
+        uint64_t begin = bench_now_ns();
+        run(ctx, t->thread, i, scratch);
+        uint64_t elapsed = bench_now_ns() - begin;
+        t->samples[i]    = elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t) elapsed;
+    }
+
+    return NULL;
+}
+
+static bool bench_measure(const bench_case_t* bcase, bench_ctx_t* ctx, uint64_t iterations, bench_result_t* result) {
+    uint32_t          threads      = ctx->threads;
+    uint64_t          per_thread   = iterations / threads;
+    uint32_t          sample_count = per_thread < BENCH_LATENCY_SAMPLES ? (uint32_t) per_thread : BENCH_LATENCY_SAMPLES;
+    uint32_t*         samples      = (uint32_t*) malloc((size_t) threads * sample_count * sizeof(uint32_t));
+    bench_thread_t    state[BENCH_MAX_THREADS];
+    pthread_t         handles[BENCH_MAX_THREADS];
+    pthread_barrier_t barrier;
+
+    if (!samples) {
+        return false;
+    }
+    pthread_barrier_init(&barrier, NULL, threads);
+
+    for (uint32_t i = 0; i < threads; i++) {
+        state[i] = (bench_thread_t) {
+            .bcase        = bcase,
+            .ctx          = ctx,
+            .barrier      = &barrier,
+            .thread       = i,
+            .iterations   = per_thread,
+            .samples      = samples + (size_t) i * sample_count,
+            .sample_count = sample_count,
+        };
+        pthread_create(&handles[i], NULL, bench_thread_main, &state[i]);
+    }
+
+    uint64_t start = UINT64_MAX, end = 0;
+    for (uint32_t i = 0; i < threads; i++) {
+        pthread_join(handles[i], NULL);
+        start = state[i].start_ns < start ? state[i].start_ns : start;
+        end   = state[i].end_ns > end ? state[i].end_ns : end;
+    }
+    pthread_barrier_destroy(&barrier);
+
+    size_t total = (size_t) threads * sample_count;
+    qsort(samples, total, sizeof(uint32_t), bench_compare_u32);
+    result->ops_per_sec = (double) (per_thread * threads) * 1e9 / (double) (end > start ? end - start : 1);
+    result->p50         = total ? samples[total / 2] : 0;
+    result->p99         = total ? samples[(size_t) ((double) total * 0.99)] : 0;
+    result->p999        = total ? samples[(size_t) ((double) total * 0.999)] : 0;
+
+    free(samples);
+    return true;
+}
+
+static void bench_teardown(bench_ctx_t* ctx) {
+    tds_queue_destroy(ctx->queue);
+    tds_stack_destroy(ctx->stack);
+    tds_ringbuffer_destroy(ctx->ring);
+    tds_hashtable_destroy(ctx->table);
+    tds_heap_destroy(ctx->heap);
+    tds_list_destroy(ctx->list);
+    tds_pool_destroy(ctx->pool);
+    tds_arena_destroy(ctx->arena);
+    tds_cache_destroy(ctx->cache);
+    for (uint32_t i = 0; i < BENCH_MAX_THREADS; i++) {
+        tds_deque_destroy(ctx->deques[i]);
+    }
+}
+
+/* Queue ---------------------------------------------------------------------*/
+
+static bool bench_queue_setup(bench_ctx_t* ctx, tds_queue_mode_t mode) {
+    tds_queue_config_t config = TDS_QUEUE_CONFIG_DEFAULT;
+    config.mode               = mode;
+    ctx->queue                = tds_queue_create_ex(ctx->capacity, ctx->element_size, &config);
+    return ctx->queue != NULL;
+}
+
+static bool bench_queue_linked_setup(bench_ctx_t* ctx) {
+    return bench_queue_setup(ctx, TDS_QUEUE_MODE_LINKED);
+}
+
+static bool bench_queue_ring_setup(bench_ctx_t* ctx) {
+    return bench_queue_setup(ctx, TDS_QUEUE_MODE_RING);
+}
+
+static bool bench_queue_mpmc_setup(bench_ctx_t* ctx) {
+    return bench_queue_setup(ctx, TDS_QUEUE_MODE_MPMC);
+}
+
+static void bench_queue_roundtrip(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    (void) i;
+    tds_queue_enqueue(ctx->queue, scratch);
+    tds_queue_dequeue(ctx->queue, scratch + BENCH_SCRATCH_HALF);
+}
+
+static void bench_queue_batch(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    (void) i;
+    tds_queue_enqueue_n(ctx->queue, scratch, BENCH_BATCH);
+    tds_queue_dequeue_n(ctx->queue, scratch + BENCH_SCRATCH_HALF, BENCH_BATCH);
+}
+
+static void bench_queue_threadsafe(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    (void) i;
+    tds_queue_enqueue_threadsafe(ctx->queue, scratch);
+    tds_queue_dequeue_threadsafe(ctx->queue, scratch + BENCH_SCRATCH_HALF);
+}
+
+#if TDS_QUEUE_BLOCKING
+static void bench_queue_wait(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) i;
+    if (thread == 0) {
+        tds_queue_enqueue_wait(ctx->queue, scratch, TDS_QUEUE_WAIT_FOREVER);
+    } else {
+        tds_queue_dequeue_wait(ctx->queue, scratch + BENCH_SCRATCH_HALF, TDS_QUEUE_WAIT_FOREVER);
+    }
+}
+#endif
+
+/* Stack ---------------------------------------------------------------------*/
+
+static bool bench_stack_setup(bench_ctx_t* ctx, tds_stack_mode_t mode) {
+    tds_stack_config_t config = TDS_STACK_CONFIG_DEFAULT;
+    config.mode               = mode;
+    ctx->stack                = tds_stack_create_ex(ctx->capacity, ctx->element_size, &config);
+    return ctx->stack != NULL;
+}
+
+static bool bench_stack_linked_setup(bench_ctx_t* ctx) {
+    return bench_stack_setup(ctx, TDS_STACK_MODE_LINKED);
+}
+
+static bool bench_stack_array_setup(bench_ctx_t* ctx) {
+    return bench_stack_setup(ctx, TDS_STACK_MODE_ARRAY);
+}
+
+static bool bench_stack_lockfree_setup(bench_ctx_t* ctx) {
+    return bench_stack_setup(ctx, TDS_STACK_MODE_LOCKFREE);
+}
+
+static void bench_stack_roundtrip(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    (void) i;
+    tds_stack_push(ctx->stack, scratch);
+    tds_stack_pop(ctx->stack, scratch + BENCH_SCRATCH_HALF);
+}
+
+static void bench_stack_threadsafe(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    (void) i;
+    tds_stack_push_threadsafe(ctx->stack, scratch);
+    tds_stack_pop_threadsafe(ctx->stack, scratch + BENCH_SCRATCH_HALF);
+}
+
+/* Ring buffer ---------------------------------------------------------------*/
+
+static bool bench_ring_setup(bench_ctx_t* ctx) {
+    ctx->ring = tds_ringbuffer_create(ctx->capacity, ctx->element_size);
+    return ctx->ring != NULL;
+}
+
+static void bench_ring_roundtrip(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    (void) i;
+    tds_ringbuffer_try_push(ctx->ring, scratch);
+    tds_ringbuffer_try_pop(ctx->ring, scratch + BENCH_SCRATCH_HALF);
+}
+
+/**
+ * @brief Thread 0 produces and thread 1 consumes; both spin until their element goes through.
+ */
+static void bench_ring_spsc(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) i;
+    if (thread == 0) {
+        while (!tds_ringbuffer_try_push(ctx->ring, scratch)) {
+        }
+    } else {
+        while (!tds_ringbuffer_try_pop(ctx->ring, scratch + BENCH_SCRATCH_HALF)) {
+        }
+    }
+}
+
+/* Deque ---------------------------------------------------------------------*/
+
+static bool bench_deque_setup(bench_ctx_t* ctx) {
+    for (uint32_t i = 0; i < ctx->threads; i++) {
+        ctx->deques[i] = tds_deque_create(ctx->capacity, ctx->element_size);
+        if (!ctx->deques[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Work-stealing pattern: every thread pushes on its own deque and
+ * pops it back, and one operation in eight steals from the next thread
+ * instead (falling back to its own deque when that one is empty).
+ */
+static void bench_deque_steal(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    tds_deque_t own = ctx->deques[thread];
+    tds_deque_push(own, scratch);
+    if (i % 8 == 7 && tds_deque_steal(ctx->deques[(thread + 1) % ctx->threads], scratch + BENCH_SCRATCH_HALF)) {
+        return;
+    }
+    tds_deque_pop(own, scratch + BENCH_SCRATCH_HALF);
+}
+
+/* Hashtable -----------------------------------------------------------------*/
+
+static bool bench_table_create(bench_ctx_t* ctx, bool concurrent, bool prefill) {
+    tds_hashtable_config_t config = TDS_HASHTABLE_CONFIG_DEFAULT;
+    config.concurrent             = concurrent;
+    ctx->table                    = tds_hashtable_create_ex(ctx->capacity, sizeof(uint64_t), ctx->element_size, &config);
+    if (!ctx->table) {
+        return false;
+    }
+
+    uint8_t value[BENCH_MAX_ELEMENT_SIZE] = {0};
+    for (uint64_t key = 0; prefill && key < ctx->capacity; key++) {
+        tds_hashtable_put(ctx->table, &key, value);
+    }
+    return true;
+}
+
+static bool bench_table_setup(bench_ctx_t* ctx) {
+    return bench_table_create(ctx, false, true);
+}
+
+static bool bench_table_empty_setup(bench_ctx_t* ctx) {
+    return bench_table_create(ctx, false, false);
+}
+
+static bool bench_table_concurrent_setup(bench_ctx_t* ctx) {
+    return bench_table_create(ctx, true, true);
+}
+
+/**
+ * @brief Table of BENCH_LARGE_TABLE entries, far beyond the last-level cache.
+ * Only run with 8-byte values, which already make 64 MB of slots.
+ */
+static bool bench_table_large_setup(bench_ctx_t* ctx) {
+    return ctx->element_size <= 8 && bench_table_create(ctx, false, true);
+}
+
+static inline uint64_t bench_table_key(bench_ctx_t* ctx, uint32_t thread, uint64_t i) {
+    return (i * ctx->threads + thread) * UINT64_C(0x9E3779B97F4A7C15) % ctx->capacity;
+}
+
+static void bench_table_get(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    uint64_t key = bench_table_key(ctx, thread, i);
+    tds_hashtable_get(ctx->table, &key, scratch);
+}
+
+static void bench_table_miss(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    uint64_t key = bench_table_key(ctx, thread, i) + ctx->capacity;
+    tds_hashtable_get(ctx->table, &key, scratch);
+}
+
+/**
+ * @brief BENCH_LOOKUPS random hits, one tds_hashtable_get() each: every miss
+ * to memory is paid in turn.
+ */
+static void bench_table_get_loop(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) scratch;
+    uint8_t values[BENCH_LOOKUPS * BENCH_MAX_ELEMENT_SIZE];
+    for (uint32_t b = 0; b < BENCH_LOOKUPS; b++) {
+        uint64_t key = bench_table_key(ctx, thread, i * BENCH_LOOKUPS + b);
+        tds_hashtable_get(ctx->table, &key, values + (size_t) b * ctx->element_size);
+    }
+}
+
+/**
+ * @brief The same BENCH_LOOKUPS hits through tds_hashtable_get_batch(), which
+ * overlaps their misses.
+ */
+static void bench_table_get_batch(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) scratch;
+    uint8_t  values[BENCH_LOOKUPS * BENCH_MAX_ELEMENT_SIZE];
+    uint64_t keys[BENCH_LOOKUPS];
+    uint64_t found;
+    for (uint32_t b = 0; b < BENCH_LOOKUPS; b++) {
+        keys[b] = bench_table_key(ctx, thread, i * BENCH_LOOKUPS + b);
+    }
+    tds_hashtable_get_batch(ctx->table, keys, BENCH_LOOKUPS, values, &found);
+}
+
+/**
+ * @brief Insert then remove a key: keeps the table size stable while exercising both paths.
+ */
+static void bench_table_put_remove(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    uint64_t key = bench_table_key(ctx, thread, i) + ctx->capacity;
+    tds_hashtable_put(ctx->table, &key, scratch);
+    tds_hashtable_remove(ctx->table, &key, NULL);
+}
+
+/**
+ * @brief Grows a fresh table to capacity entries, then starts over: every resize is measured.
+ */
+static void bench_table_fill(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    uint64_t key = i % ctx->capacity;
+    if (key == 0) {
+        tds_hashtable_destroy(ctx->table);
+        ctx->table = tds_hashtable_create(0, sizeof(uint64_t), ctx->element_size);
+    }
+    tds_hashtable_put(ctx->table, &key, scratch);
+}
+
+/**
+ * @brief 90% reads, 10% overwrites spread over every thread.
+ */
+static void bench_table_mixed(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    uint64_t key = bench_table_key(ctx, thread, i);
+    if (i % 10 == 0) {
+        tds_hashtable_put(ctx->table, &key, scratch);
+    } else {
+        tds_hashtable_get(ctx->table, &key, scratch + BENCH_SCRATCH_HALF);
+    }
+}
+
+/* Heap ----------------------------------------------------------------------*/
+
+/**
+ * @brief Orders elements by their first 8 bytes.
+ */
+static int bench_heap_compare(const void* a, const void* b) {
+    uint64_t x, y;
+    memcpy(&x, a, sizeof(x));
+    memcpy(&y, b, sizeof(y));
+    return (x > y) - (x < y);
+}
+
+static uint64_t bench_heap_key(uint64_t i) {
+    return (i + 1) * UINT64_C(0x9E3779B97F4A7C15);
+}
+
+static bool bench_heap_setup(bench_ctx_t* ctx) {
+    ctx->heap = tds_heap_create(ctx->capacity, ctx->element_size, bench_heap_compare);
+    uint8_t* prefill = (uint8_t*) calloc(ctx->capacity, ctx->element_size);
+    if (!ctx->heap || !prefill) {
+        free(prefill);
+        return false;
+    }
+
+    // Half full, so pushes and pops travel the whole depth
+    for (uint32_t i = 0; i < ctx->capacity / 2; i++) {
+        uint64_t key = bench_heap_key(i);
+        memcpy(prefill + (size_t) i * ctx->element_size, &key, sizeof(key));
+    }
+    bool ok = ctx->capacity < 2 || tds_heap_heapify(ctx->heap, prefill, ctx->capacity / 2, NULL);
+    free(prefill);
+    return ok;
+}
+
+static void bench_heap_roundtrip(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    uint64_t key = bench_heap_key(i ^ UINT64_C(0x5555));
+    memcpy(scratch, &key, sizeof(key));
+    tds_heap_push(ctx->heap, scratch, NULL);
+    tds_heap_pop(ctx->heap, scratch + BENCH_SCRATCH_HALF);
+}
+
+/* List ----------------------------------------------------------------------*/
+
+static bool bench_list_setup(bench_ctx_t* ctx) {
+    ctx->list = tds_list_create(ctx->capacity + 1, ctx->element_size);
+    if (!ctx->list) {
+        return false;
+    }
+
+    uint8_t value[BENCH_MAX_ELEMENT_SIZE] = {0};
+    for (uint32_t i = 0; i < ctx->capacity; i++) {
+        tds_list_push_back(ctx->list, value);
+    }
+    return true;
+}
+
+static void bench_list_insert_middle(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    (void) i;
+    tds_list_insert(ctx->list, ctx->capacity / 2, scratch);
+    tds_list_remove(ctx->list, ctx->capacity / 2, NULL);
+}
+
+/**
+ * @brief One full traversal summing the first byte of every element.
+ */
+static void bench_list_scan(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    (void) i;
+    tds_list_iterator_t it  = tds_list_begin(ctx->list);
+    uint32_t            sum = 0, count;
+    uint8_t*            span;
+    while ((span = (uint8_t*) tds_list_next_span(&it, &count)) != NULL) {
+        for (uint32_t e = 0; e < count; e++) {
+            sum += span[(size_t) e * ctx->element_size];
+        }
+    }
+    scratch[0] = (uint8_t) sum;
+}
+
+/* Allocators ----------------------------------------------------------------*/
+
+static bool bench_malloc_setup(bench_ctx_t* ctx) {
+    (void) ctx;
+    return true;
+}
+
+static bool bench_pool_setup(bench_ctx_t* ctx) {
+    ctx->pool = tds_pool_create(ctx->element_size, ctx->capacity);
+    return ctx->pool != NULL;
+}
+
+static bool bench_arena_setup(bench_ctx_t* ctx) {
+    ctx->arena = tds_arena_create((size_t) ctx->element_size * ctx->capacity);
+    return ctx->arena != NULL;
+}
+
+static bool bench_cache_setup(bench_ctx_t* ctx) {
+    ctx->cache = tds_cache_create(ctx->element_size, 0);
+    return ctx->cache != NULL;
+}
+
+static void bench_malloc_roundtrip(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    (void) i;
+    void* block = malloc(ctx->element_size);
+    memcpy(block, scratch, ctx->element_size);
+    free(block);
+}
+
+static void bench_pool_roundtrip(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    (void) i;
+    void* block = tds_pool_alloc(ctx->pool);
+    memcpy(block, scratch, ctx->element_size);
+    tds_pool_free(ctx->pool, block);
+}
+
+/** One allocation per operation; the whole arena is reset every capacity operations. */
+static void bench_arena_alloc(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    void* block = tds_arena_alloc(ctx->arena, ctx->element_size);
+    memcpy(block, scratch, ctx->element_size);
+    if ((i + 1) % ctx->capacity == 0) {
+        tds_arena_reset(ctx->arena);
+    }
+}
+
+/**
+ * @brief BENCH_BATCH allocations then as many frees, from every thread at once.
+ */
+static void bench_malloc_batch(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    (void) i;
+    void* blocks[BENCH_BATCH];
+    for (uint32_t b = 0; b < BENCH_BATCH; b++) {
+        blocks[b] = malloc(ctx->element_size);
+        memcpy(blocks[b], scratch, sizeof(uint64_t));
+    }
+    for (uint32_t b = 0; b < BENCH_BATCH; b++) {
+        free(blocks[b]);
+    }
+}
+
+static void bench_cache_batch(bench_ctx_t* ctx, uint32_t thread, uint64_t i, uint8_t* scratch) {
+    (void) thread;
+    (void) i;
+    void* blocks[BENCH_BATCH];
+    for (uint32_t b = 0; b < BENCH_BATCH; b++) {
+        blocks[b] = tds_cache_alloc(ctx->cache);
+        memcpy(blocks[b], scratch, sizeof(uint64_t));
+    }
+    for (uint32_t b = 0; b < BENCH_BATCH; b++) {
+        tds_cache_free(ctx->cache, blocks[b]);
+    }
+}
+
+/* Case table ----------------------------------------------------------------*/
+
+static const bench_case_t bench_cases[] = {
+    {"queue", "linked", "enqueue+dequeue", bench_queue_linked_setup, bench_queue_roundtrip, false, 0, false, 0},
+    {"queue", "ring", "enqueue+dequeue", bench_queue_ring_setup, bench_queue_roundtrip, false, 0, false, 0},
+    {"queue", "ring", "enqueue_n+dequeue_n (8)", bench_queue_ring_setup, bench_queue_batch, false, 0, false, 0},
+    {"queue", "mpmc", "enqueue+dequeue", bench_queue_mpmc_setup, bench_queue_roundtrip, false, 0, false, 0},
+    {"queue", "mpmc", "threadsafe enqueue+dequeue", bench_queue_mpmc_setup, bench_queue_threadsafe, true, 0, false, 0},
+#if TDS_QUEUE_BLOCKING
+    {"queue", "mpmc", "enqueue_wait/dequeue_wait", bench_queue_mpmc_setup, bench_queue_wait, false, 2, false, 0},
+#endif
+    {"stack", "linked", "push+pop", bench_stack_linked_setup, bench_stack_roundtrip, false, 0, false, 0},
+    {"stack", "array", "push+pop", bench_stack_array_setup, bench_stack_roundtrip, false, 0, false, 0},
+    {"stack", "lockfree", "threadsafe push+pop", bench_stack_lockfree_setup, bench_stack_threadsafe, true, 0, false, 0},
+    {"ringbuffer", "spsc", "try_push+try_pop", bench_ring_setup, bench_ring_roundtrip, false, 0, false, 0},
+    {"ringbuffer", "spsc", "producer/consumer", bench_ring_setup, bench_ring_spsc, false, 2, false, 0},
+    {"deque", "chase-lev", "push+pop (steal 1/8)", bench_deque_setup, bench_deque_steal, true, 0, false, 0},
+    {"hashtable", "single", "get hit", bench_table_setup, bench_table_get, false, 0, false, 0},
+    {"hashtable", "single", "get miss", bench_table_setup, bench_table_miss, false, 0, false, 0},
+    {"hashtable", "single", "put+remove", bench_table_setup, bench_table_put_remove, false, 0, false, 0},
+    {"hashtable", "single", "put growing", bench_table_empty_setup, bench_table_fill, false, 0, false, 0},
+    {"hashtable", "single", "get x32 loop", bench_table_setup, bench_table_get_loop, false, 0, false, 0},
+    {"hashtable", "single", "get_batch x32", bench_table_setup, bench_table_get_batch, false, 0, false, 0},
+    {"hashtable", "single", "get x32 loop", bench_table_large_setup, bench_table_get_loop, false, 0, false, BENCH_LARGE_TABLE},
+    {"hashtable", "single", "get_batch x32", bench_table_large_setup, bench_table_get_batch, false, 0, false, BENCH_LARGE_TABLE},
+    {"hashtable", "concurrent", "get hit", bench_table_concurrent_setup, bench_table_get, true, 0, false, 0},
+    {"hashtable", "concurrent", "90% get 10% put", bench_table_concurrent_setup, bench_table_mixed, true, 0, false, 0},
+    {"heap", "d-ary", "push+pop", bench_heap_setup, bench_heap_roundtrip, false, 0, false, 0},
+    {"list", "unrolled", "insert+remove middle", bench_list_setup, bench_list_insert_middle, false, 0, true, 0},
+    {"list", "unrolled", "full scan", bench_list_setup, bench_list_scan, false, 0, true, 0},
+    {"allocator", "malloc", "alloc+free", bench_malloc_setup, bench_malloc_roundtrip, false, 0, false, 0},
+    {"allocator", "pool", "alloc+free", bench_pool_setup, bench_pool_roundtrip, false, 0, false, 0},
+    {"allocator", "malloc", "threadsafe 8 alloc+8 free", bench_malloc_setup, bench_malloc_batch, true, 0, false, 0},
+    {"allocator", "cache", "threadsafe 8 alloc+8 free", bench_cache_setup, bench_cache_batch, true, 0, false, 0},
+    {"allocator", "arena", "alloc (reset per capacity)", bench_arena_setup, bench_arena_alloc, false, 0, false, 0},
+};
+
+/* Output --------------------------------------------------------------------*/
+
+typedef enum {
+    BENCH_FORMAT_CSV,
+    BENCH_FORMAT_JSON,
+} bench_format_t;
+
+static void bench_print(FILE* out, bench_format_t format, const bench_case_t* bcase, const bench_ctx_t* ctx, const bench_result_t* r, bool first) {
+    if (format == BENCH_FORMAT_CSV) {
+        fprintf(out, "%s,%s,%s,%u,%u,%u,%.0f,%u,%u,%u\n", bcase->container, bcase->mode, bcase->op, ctx->element_size, ctx->capacity, ctx->threads,
+                r->ops_per_sec, r->p50, r->p99, r->p999);
+    } else {
+        fprintf(out,
+                "%s  {\"container\": \"%s\", \"mode\": \"%s\", \"op\": \"%s\", \"element_size\": %u, \"capacity\": %u, \"threads\": %u, "
+                "\"ops_per_sec\": %.0f, \"p50_ns\": %u, \"p99_ns\": %u, \"p999_ns\": %u}",
+                first ? "" : ",\n", bcase->container, bcase->mode, bcase->op, ctx->element_size, ctx->capacity, ctx->threads, r->ops_per_sec,
+                r->p50, r->p99, r->p999);
+    }
+    fflush(out);
+}
+
+static void bench_usage(const char* name) {
+    fprintf(stderr,
+            "Usage: %s [--csv | --json] [--quick] [--iterations N] [--filter TEXT] [--output FILE]\n"
+            "  --csv           CSV output (default)\n"
+            "  --json          JSON array output\n"
+            "  --quick         Smaller sweep and fewer iterations (smoke run)\n"
+            "  --iterations N  Measured operations per case (default 1000000)\n"
+            "  --filter TEXT   Only run cases whose container or mode contains TEXT\n"
+            "  --output FILE   Write results to FILE instead of stdout\n",
+            name);
+}
+
+/* Main ----------------------------------------------------------------------*/
+
+int main(int argc, char** argv) {
+    bench_format_t format     = BENCH_FORMAT_CSV;
+    uint64_t       iterations = 1000000;
+    bool           quick      = false;
+    const char*    filter     = NULL;
+    FILE*          out        = stdout;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            format = BENCH_FORMAT_CSV;
+        } else if (strcmp(argv[i], "--json") == 0) {
+            format = BENCH_FORMAT_JSON;
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            quick      = true;
+            iterations = 20000;
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            out = fopen(argv[++i], "w");
+            if (!out) {
+                perror("fopen");
+                return 1;
+            }
+        } else {
+            bench_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    const uint32_t element_sizes[] = {8, 64, 256};
+    const uint32_t capacities[]    = {1024, 65536};
+    const uint32_t thread_counts[] = {1, 2, 4, 8, 16};
+    const size_t   size_count      = quick ? 1 : sizeof(element_sizes) / sizeof(element_sizes[0]);
+    const size_t   capacity_count  = quick ? 1 : sizeof(capacities) / sizeof(capacities[0]);
+    const size_t   thread_sweep    = quick ? 3 : sizeof(thread_counts) / sizeof(thread_counts[0]);
+    bool           first           = true;
+
+    if (format == BENCH_FORMAT_CSV) {
+        fprintf(out, "container,mode,op,element_size,capacity,threads,ops_per_sec,p50_ns,p99_ns,p999_ns\n");
+    } else {
+        fprintf(out, "[\n");
+    }
+
+    for (size_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]); c++) {
+        const bench_case_t* bcase = &bench_cases[c];
+        if (filter && !strstr(bcase->container, filter) && !strstr(bcase->mode, filter)) {
+            continue;
+        }
+
+        for (size_t s = 0; s < size_count; s++) {
+            for (size_t k = 0; k < (bcase->capacity ? 1 : capacity_count); k++) {
+                size_t sweep = bcase->threaded ? thread_sweep : 1;
+                for (size_t t = 0; t < sweep; t++) {
+                    bench_ctx_t ctx = {0};
+                    ctx.element_size = element_sizes[s];
+                    ctx.capacity     = bcase->capacity ? bcase->capacity : capacities[k];
+                    ctx.threads      = bcase->threads ? bcase->threads : (bcase->threaded ? thread_counts[t] : 1);
+
+                    uint64_t case_iterations = iterations;
+                    if (bcase->linear) {
+                        case_iterations = iterations * 64 / ctx.capacity;
+                        case_iterations = case_iterations < 100 ? 100 : case_iterations;
+                    }
+
+                    bench_result_t result;
+                    if (bcase->setup(&ctx) && bench_measure(bcase, &ctx, case_iterations, &result)) {
+                        bench_print(out, format, bcase, &ctx, &result, first);
+                        first = false;
+                    } else {
+                        fprintf(stderr, "Skipped %s/%s/%s (element %u, capacity %u)\n", bcase->container, bcase->mode, bcase->op, ctx.element_size,
+                                ctx.capacity);
+                    }
+                    bench_teardown(&ctx);
+                }
+            }
+        }
+    }
+
+    if (format == BENCH_FORMAT_JSON) {
+        fprintf(out, "\n]\n");
+    }
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,208 @@
+/******************************************************************************
+ * File: thread_pool.c
+ * Author: Tiago Barbosa
+ * Description: Reference work-stealing thread pool built on tds_deque.
+ *              Every worker owns a deque: it pushes the tasks it spawns and
+ *              pops them back (newest first, still hot in cache), and only
+ *              when its deque runs dry it steals the oldest task of another
+ *              worker. The demo sums a range by recursive splitting and
+ *              checks the result against a serial loop.
+ *
+ *              Usage: tds_thread_pool [workers] [log2 of the range]
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+/* Includes -----------------------------------------------------------------*/
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "tds_config.h"
+#include "tds_deque.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define POOL_MAX_WORKERS 64
+#define POOL_GRAIN       4096 /**< Range size below which a task stops splitting */
+
+/* Typedefs -----------------------------------------------------------------*/
+typedef struct pool_t pool_t;
+
+/**
+ * @brief A unit of work, copied by value into the deques.
+ */
+typedef struct {
+    void (*run)(pool_t* pool, uint32_t worker, uint64_t lo, uint64_t hi);
+    uint64_t lo;
+    uint64_t hi;
+} task_t;
+
+/**
+ * @brief Per-worker state, one cache line apart so the counters do not false-share.
+ */
+typedef struct {
+    _Alignas(TDS_CACHE_LINE_SIZE) tds_deque_t deque;
+    pthread_t thread;
+    pool_t*   pool;
+    uint32_t  id;
+    uint32_t  seed;     /**< Victim selection */
+    uint64_t  sum;      /**< Partial result of the demo */
+    uint64_t  executed; /**< Tasks run by this worker */
+    uint64_t  stolen;   /**< Of which taken from another worker */
+} worker_t;
+
+struct pool_t {
+    worker_t         workers[POOL_MAX_WORKERS];
+    uint32_t         count;
+    _Atomic uint64_t pending; /**< Tasks spawned and not yet finished */
+};
+
+/* Pool ---------------------------------------------------------------------*/
+
+/**
+ * @brief Queues a task on the deque of the calling worker (its owner).
+ */
+static void pool_spawn(pool_t* pool, uint32_t worker, task_t task) {
+    atomic_fetch_add_explicit(&pool->pending, 1, memory_order_relaxed);
+    if (!tds_deque_push(pool->workers[worker].deque, &task)) {
+        // Out of memory: run it inline instead of dropping it
+        task.run(pool, worker, task.lo, task.hi);
+        atomic_fetch_sub_explicit(&pool->pending, 1, memory_order_release);
+    }
+}
+
+/**
+ * @brief Takes the next task: own deque first, then one steal attempt per other worker.
+ */
+static bool pool_next(pool_t* pool, worker_t* self, task_t* task) {
+    if (tds_deque_pop(self->deque, task)) {
+        return true;
+    }
+
+    self->seed ^= self->seed << 13;
+    self->seed ^= self->seed >> 17;
+    self->seed ^= self->seed << 5;
+    for (uint32_t i = 0; i < pool->count; i++) {
+        uint32_t victim = (self->seed + i) % pool->count;
+        if (victim != self->id && tds_deque_steal(pool->workers[victim].deque, task)) {
+            self->stolen++;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void* pool_worker(void* arg) {
+    worker_t* self = (worker_t*) arg;
+    pool_t*   pool = self->pool;
+    task_t    task;
+
+    for (;;) {
+        if (pool_next(pool, self, &task)) {
+            task.run(pool, self->id, task.lo, task.hi);
+            self->executed++;
+            atomic_fetch_sub_explicit(&pool->pending, 1, memory_order_release);
+        } else if (atomic_load_explicit(&pool->pending, memory_order_acquire) == 0) {
+            return NULL;
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+/* Demo workload ------------------------------------------------------------*/
+
+static inline uint64_t work_item(uint64_t i) {
+    uint64_t x = i * UINT64_C(0x9E3779B97F4A7C15);
+    x ^= x >> 29;
+    x *= UINT64_C(0xBF58476D1CE4E5B9);
+    return x ^ (x >> 32);
+}
+
+/**
+ * @brief Splits its range until it is small enough, keeping the left half and
+ * spawning the right one, then sums the leaf.
+ */
+static void sum_range(pool_t* pool, uint32_t worker, uint64_t lo, uint64_t hi) {
+    while (hi - lo > POOL_GRAIN) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        pool_spawn(pool, worker, (task_t) {sum_range, mid, hi});
+        hi = mid;
+    }
+
+    uint64_t sum = 0;
+    for (uint64_t i = lo; i < hi; i++) {
+        sum += work_item(i);
+    }
+    pool->workers[worker].sum += sum;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/* Main ----------------------------------------------------------------------*/
+
+int main(int argc, char** argv) {
+    static pool_t pool;
+    uint32_t      count = argc > 1 ? (uint32_t) strtoul(argv[1], NULL, 10) : 4;
+    uint32_t      bits  = argc > 2 ? (uint32_t) strtoul(argv[2], NULL, 10) : 24;
+    uint64_t      range = UINT64_C(1) << (bits < 40 ? bits : 40);
+
+    if (count == 0 || count > POOL_MAX_WORKERS) {
+        fprintf(stderr, "Usage: %s [workers (1-%d)] [log2 of the range]\n", argv[0], POOL_MAX_WORKERS);
+        return 1;
+    }
+
+    pool.count = count;
+    atomic_init(&pool.pending, 0);
+    for (uint32_t i = 0; i < count; i++) {
+        pool.workers[i].deque = tds_deque_create(64, sizeof(task_t));
+        pool.workers[i].pool  = &pool;
+        pool.workers[i].id    = i;
+        pool.workers[i].seed  = 2463534242u + i;
+        if (!pool.workers[i].deque) {
+            fprintf(stderr, "Failed to create the deques\n");
+            return 1;
+        }
+    }
+
+    // The root task is queued on worker 0 before its thread exists, which
+    // pthread_create orders before any access by that thread
+    pool_spawn(&pool, 0, (task_t) {sum_range, 0, range});
+
+    double start = now_seconds();
+    for (uint32_t i = 0; i < count; i++) {
+        pthread_create(&pool.workers[i].thread, NULL, pool_worker, &pool.workers[i]);
+    }
+
+    uint64_t sum = 0, executed = 0, stolen = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        pthread_join(pool.workers[i].thread, NULL);
+        sum += pool.workers[i].sum;
+        executed += pool.workers[i].executed;
+        stolen += pool.workers[i].stolen;
+    }
+    double elapsed = now_seconds() - start;
+
+    // Only once every worker is gone: a late thief may still probe any deque
+    for (uint32_t i = 0; i < count; i++) {
+        tds_deque_destroy(pool.workers[i].deque);
+    }
+
+    uint64_t expected = 0;
+    for (uint64_t i = 0; i < range; i++) {
+        expected += work_item(i);
+    }
+
+    printf("workers=%u items=%llu tasks=%llu stolen=%llu time=%.3fs items/s=%.0f %s\n", count, (unsigned long long) range,
+           (unsigned long long) executed, (unsigned long long) stolen, elapsed, (double) range / elapsed, sum == expected ? "OK" : "MISMATCH");
+    return sum == expected ? 0 : 1;
+}
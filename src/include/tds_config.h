@@ -0,0 +1,253 @@
+/******************************************************************************
+ * File: tds_config.h
+ * Author: Tiago Barbosa
+ * Description: Compile-time configuration of the TDS library.
+ *              Every option can be overridden from the build system
+ *              (e.g. -DTDS_CACHE_LINE_SIZE=32) before this header is included.
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+/* Defines ------------------------------------------------------------------*/
+/**
+ * @brief Size in bytes of a data cache line on the target.
+ *
+ * Used to keep data written by different threads on separate lines and avoid
+ * false sharing. 64 bytes matches most x86 and ARM application cores.
+ */
+#ifndef TDS_CACHE_LINE_SIZE
+#define TDS_CACHE_LINE_SIZE 64
+#endif
+
+/**
+ * @brief Per-instance statistics (see tds_stats.h and the tds_*_get_stats() functions).
+ *
+ * 0 (default) compiles every counter out: no extra fields, no extra
+ * instructions. 1 adds relaxed atomic counters updated on the hot paths.
+ * Must have the same value for the library and the code including its
+ * headers, since it changes the layout of tds_stack_instance_t.
+ */
+#ifndef TDS_ENABLE_STATS
+#define TDS_ENABLE_STATS 0
+#endif
+
+/**
+ * @brief Builds the library without any call to the C library heap.
+ *
+ * With 1, TDS_MALLOC/TDS_REALLOC always fail and TDS_FREE does nothing: the
+ * tds_*_create functions return NULL and containers are built in caller
+ * memory with the tds_*_init_static functions, taking their nodes from a
+ * static tds_pool_t or tds_arena_t allocator.
+ */
+#ifndef TDS_NO_MALLOC
+#define TDS_NO_MALLOC 0
+#endif
+
+/**
+ * @brief System heap used for instances and their storage.
+ *
+ * Can be redirected from the build system (define all three), e.g. to an
+ * RTOS heap. Container nodes go through tds_allocator_t instead.
+ */
+#ifndef TDS_MALLOC
+#if TDS_NO_MALLOC
+#define TDS_MALLOC(size)       ((void) (size), (void*) 0)
+#define TDS_REALLOC(ptr, size) ((void) (ptr), (void) (size), (void*) 0)
+#define TDS_FREE(ptr)          ((void) (ptr))
+#else
+#include <stdlib.h>
+#define TDS_MALLOC(size)       malloc(size)
+#define TDS_REALLOC(ptr, size) realloc((ptr), (size))
+#define TDS_FREE(ptr)          free(ptr)
+#endif
+#endif
+
+/**
+ * @brief Hint for the CPU inside spin-wait loops.
+ */
+#ifndef TDS_CPU_RELAX
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#define TDS_CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define TDS_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+#define TDS_CPU_RELAX() ((void) 0)
+#endif
+#endif
+
+/**
+ * @brief How tds_queue_enqueue_wait()/tds_queue_dequeue_wait() park a thread.
+ *
+ * 1 parks on a Linux futex, 2 on a pthread mutex/condition variable (other
+ * POSIX systems), 0 leaves the blocking functions out (bare-metal targets).
+ */
+#ifndef TDS_QUEUE_BLOCKING
+#if defined(__linux__)
+#define TDS_QUEUE_BLOCKING 1
+#elif defined(__unix__) || defined(__APPLE__)
+#define TDS_QUEUE_BLOCKING 2
+#else
+#define TDS_QUEUE_BLOCKING 0
+#endif
+#endif
+
+/**
+ * @brief Failed attempts a blocking queue call spins on before parking.
+ *
+ * Covers the common case of a peer that is about to publish, so the thread
+ * only sleeps when the queue stays empty (or full) for a while.
+ */
+#ifndef TDS_QUEUE_SPIN_COUNT
+#define TDS_QUEUE_SPIN_COUNT 100
+#endif
+
+/**
+ * @brief Builds tds_ringbuffer_create_mapped()/tds_ringbuffer_attach().
+ *
+ * Needs POSIX mmap/ftruncate: on by default on unix and Apple systems, 0
+ * leaves the file-backed mode out.
+ */
+#ifndef TDS_RINGBUFFER_MMAP
+#if defined(__unix__) || defined(__APPLE__)
+#define TDS_RINGBUFFER_MMAP 1
+#else
+#define TDS_RINGBUFFER_MMAP 0
+#endif
+#endif
+
+/**
+ * @brief Builds the tds_*_snapshot()/tds_*_load() functions (tds_snapshot.h).
+ *
+ * Needs POSIX write/mmap and heap allocation: on by default on unix and
+ * Apple systems unless TDS_NO_MALLOC is set.
+ */
+#ifndef TDS_SNAPSHOT
+#if (defined(__unix__) || defined(__APPLE__)) && !TDS_NO_MALLOC
+#define TDS_SNAPSHOT 1
+#else
+#define TDS_SNAPSHOT 0
+#endif
+#endif
+
+/**
+ * @brief Bytes a snapshot writer gathers on the stack before calling write().
+ *
+ * Only small pieces (list nodes, sparse hashtable groups) go through it;
+ * contiguous arrays larger than the buffer are written directly.
+ */
+#ifndef TDS_SNAPSHOT_BUFFER_SIZE
+#define TDS_SNAPSHOT_BUFFER_SIZE 16384
+#endif
+
+/**
+ * @brief Hint to start loading the cache line holding addr (no-op when unsupported).
+ */
+#ifndef TDS_PREFETCH
+#if defined(__GNUC__) || defined(__clang__)
+#define TDS_PREFETCH(addr) __builtin_prefetch(addr)
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#define TDS_PREFETCH(addr) _mm_prefetch((const char*) (addr), _MM_HINT_T0)
+#else
+#define TDS_PREFETCH(addr) ((void) 0)
+#endif
+#endif
+
+/**
+ * @brief Enables SSE2 group probing in tds_hashtable.
+ *
+ * Defaults to on when the compiler targets SSE2; set to 0 to force the
+ * portable scalar probe (e.g. to compare both paths on a PC).
+ */
+#ifndef TDS_HASHTABLE_USE_SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TDS_HASHTABLE_USE_SSE2 1
+#else
+#define TDS_HASHTABLE_USE_SSE2 0
+#endif
+#endif
+
+/**
+ * @brief Default maximum load factor of tds_hashtable (full + deleted slots / total slots).
+ */
+#ifndef TDS_HASHTABLE_DEFAULT_LOAD_FACTOR
+#define TDS_HASHTABLE_DEFAULT_LOAD_FACTOR 0.875f
+#endif
+
+/**
+ * @brief Probe groups (16 slots each) a tds_hashtable operation moves from the
+ * old to the new slot array while an incremental resize is in progress.
+ *
+ * Bounds the extra work of a single put/get/remove; must be at least 1 so a
+ * resize always completes before the new array fills up.
+ */
+#ifndef TDS_HASHTABLE_MIGRATE_GROUPS
+#define TDS_HASHTABLE_MIGRATE_GROUPS 2
+#endif
+
+/**
+ * @brief Keys tds_hashtable_get_batch() hashes and prefetches before probing them.
+ *
+ * Enough misses to keep the memory system busy (about 10 to 20 line fill
+ * buffers per core) while the window's hashes stay on the stack.
+ */
+#ifndef TDS_HASHTABLE_BATCH_WINDOW
+#define TDS_HASHTABLE_BATCH_WINDOW 16
+#endif
+
+/**
+ * @brief Number of writer lock stripes of a concurrent tds_hashtable (max 64).
+ *
+ * Probe group g is guarded by stripe g % TDS_HASHTABLE_LOCK_STRIPES.
+ */
+#ifndef TDS_HASHTABLE_LOCK_STRIPES
+#define TDS_HASHTABLE_LOCK_STRIPES 64
+#endif
+
+/**
+ * @brief Default number of children per node of a tds_heap (2 to 16).
+ *
+ * 4 halves the depth of a binary heap while the children compared by a
+ * sift-down still share one or two cache lines for small elements.
+ */
+#ifndef TDS_HEAP_ARITY
+#define TDS_HEAP_ARITY 4
+#endif
+
+/**
+ * @brief Default number of blocks per magazine of a tds_cache.
+ *
+ * A thread goes to the shared depot at most once every magazine of
+ * allocations (or frees); larger magazines mean fewer depot trips but more
+ * blocks parked in each thread.
+ */
+#ifndef TDS_CACHE_MAGAZINE_SIZE
+#define TDS_CACHE_MAGAZINE_SIZE 32
+#endif
+
+/**
+ * @brief Thread-local lookup slots for tds_cache instances (power of two).
+ *
+ * A thread finds its magazines for a cache in one of these slots, picked by
+ * the cache id; using more caches at once than slots from the same thread
+ * still works but may take the depot lock to find them again.
+ */
+#ifndef TDS_CACHE_THREAD_SLOTS
+#define TDS_CACHE_THREAD_SLOTS 8
+#endif
+
+/**
+ * @brief Target size in bytes of a tds_list node (header + packed elements).
+ *
+ * Two 64-byte cache lines by default: small elements get several dozen per
+ * node, and a node never holds less than one element.
+ */
+#ifndef TDS_LIST_NODE_BYTES
+#define TDS_LIST_NODE_BYTES 128
+#endif
+
+#endif  // CONFIG_H
@@ -0,0 +1,141 @@
+/******************************************************************************
+ * File: tds_deque.h
+ * Author: Tiago Barbosa
+ * Description: Lock-free work-stealing deque (Chase-Lev). The owner thread
+ *              pushes and pops at the bottom without locks, any other thread
+ *              steals from the top with a single CAS. The circular array
+ *              grows without blocking the thieves.
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef DEQUE_H
+#define DEQUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include <stdbool.h>  // For boolean type (true/false)
+#include <stddef.h>   // For size_t
+#include <stdint.h>   // For data types like uint8_t, int32_t, etc.
+
+#include "tds_stats.h"
+
+/* Typedefs -----------------------------------------------------------------*/
+/**
+ * @brief Opaque type for deque instance.
+ *
+ * This type is used to handle the deque instance without exposing its internals.
+ */
+typedef struct tds_deque_instance_t* tds_deque_t;
+
+/* Function Prototypes ------------------------------------------------------*/
+
+/**
+ * @brief Creates a new work-stealing deque.
+ *
+ * The thread that pushes and pops (the owner) is fixed by the caller; every
+ * other thread may only steal. The initial capacity is rounded up to a power
+ * of two and doubles whenever a push finds the array full (up to 2^30
+ * elements). Replaced arrays stay allocated, because a thief may still be
+ * reading them, and are freed by tds_deque_destroy(): the memory held is at
+ * most twice the largest array.
+ *
+ * @param capacity Initial number of elements (at least 1).
+ * @param element_size The size of each element in bytes.
+ * @return tds_deque_t A handle to the created deque, or NULL on failure.
+ */
+tds_deque_t tds_deque_create(uint32_t capacity, size_t element_size);
+
+/**
+ * @brief Pushes an element at the bottom. Owner thread only.
+ *
+ * @param instance The deque instance.
+ * @param data Pointer to the element to copy in.
+ * @return true If the element was stored.
+ * @return false If the array had to grow and the allocation failed.
+ */
+bool tds_deque_push(tds_deque_t instance, const void* data);
+
+/**
+ * @brief Pops the newest element from the bottom (LIFO). Owner thread only.
+ *
+ * Only the last element is contended with thieves, through one CAS.
+ *
+ * @param instance The deque instance.
+ * @param data Pointer where the element will be copied.
+ * @return true If an element was retrieved.
+ * @return false If the deque is empty (or a thief took the last element).
+ */
+bool tds_deque_pop(tds_deque_t instance, void* data);
+
+/**
+ * @brief Steals the oldest element from the top (FIFO). Any thread.
+ *
+ * Lost races against other thieves or the owner are retried while the deque
+ * holds elements. data may be written even when false is returned.
+ *
+ * @param instance The deque instance.
+ * @param data Pointer where the element will be copied.
+ * @return true If an element was retrieved.
+ * @return false If the deque is empty.
+ */
+bool tds_deque_steal(tds_deque_t instance, void* data);
+
+/**
+ * @brief Returns the number of stored elements.
+ *
+ * The value is a snapshot and may be stale when called concurrently.
+ *
+ * @param instance The deque instance.
+ * @return uint32_t Number of elements, 0 if the deque is not initialized.
+ */
+uint32_t tds_deque_size(tds_deque_t instance);
+
+/**
+ * @brief Checks if the deque is empty (snapshot, see tds_deque_size()).
+ *
+ * @param instance The deque instance.
+ * @return true If the deque is empty or not initialized.
+ * @return false If the deque holds elements.
+ */
+bool tds_deque_empty(tds_deque_t instance);
+
+/**
+ * @brief Returns the number of slots of the current array.
+ *
+ * @param instance The deque instance.
+ * @return uint32_t Capacity before the next growth, 0 if the deque is not initialized.
+ */
+uint32_t tds_deque_capacity(tds_deque_t instance);
+
+/**
+ * @brief Reads the statistics counters of the deque.
+ *
+ * retries counts the CAS races lost by thieves.
+ *
+ * @param instance The deque instance.
+ * @param stats Pointer where the counters will be stored (zeroed when disabled).
+ * @return true If the library was built with TDS_ENABLE_STATS.
+ * @return false If statistics are disabled or an argument is NULL.
+ */
+bool tds_deque_get_stats(tds_deque_t instance, tds_stats_t* stats);
+
+/**
+ * @brief Destroys the deque and frees every array it used.
+ *
+ * No thread may be using the deque anymore.
+ *
+ * @param instance The deque instance.
+ * @return true If the deque was destroyed.
+ * @return false If the deque is not initialized.
+ */
+bool tds_deque_destroy(tds_deque_t instance);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // DEQUE_H
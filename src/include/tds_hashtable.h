@@ -0,0 +1,311 @@
+/******************************************************************************
+ * File: tds_hashtable.h
+ * Author: Tiago Barbosa
+ * Description: Open-addressing hashtable for embedded systems.
+ *              Keys and values are fixed-size byte blobs stored inline in a
+ *              flat slot array, with one control byte per slot probed 16 at
+ *              a time (SSE2 when available, portable scalar otherwise).
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef HASHTABLE_H
+#define HASHTABLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include <stdbool.h>  // For boolean type (true/false)
+#include <stddef.h>   // For size_t
+#include <stdint.h>   // For data types like uint8_t, int32_t, etc.
+
+#include "tds_memory.h"
+#include "tds_stats.h"
+
+/* Defines ------------------------------------------------------------------*/
+/**
+ * @brief Default configuration used by tds_hashtable_create().
+ */
+#define TDS_HASHTABLE_CONFIG_DEFAULT { .hash = NULL, .equal = NULL, .max_load_factor = 0.0f, .allocator = NULL, .concurrent = false }
+
+/**
+ * @brief Upper bound of the hashtable instance size (checked when the library is built).
+ *
+ * Storage needed by tds_hashtable_init_static().
+ */
+#define TDS_HASHTABLE_INSTANCE_SIZE (192 + TDS_STATS_SIZE)
+
+/* Typedefs -----------------------------------------------------------------*/
+/**
+ * @brief Opaque type for hashtable instance.
+ *
+ * This type is used to handle the hashtable instance without exposing its internals.
+ */
+typedef struct tds_hashtable_instance_t* tds_hashtable_t;
+
+/**
+ * @brief Hash callback. All 64 bits should be well mixed: the low 7 bits tag
+ * the slot and the remaining bits select the probe group.
+ */
+typedef uint64_t (*tds_hashtable_hash_fn)(const void* key, size_t key_size);
+
+/**
+ * @brief Key equality callback.
+ */
+typedef bool (*tds_hashtable_equal_fn)(const void* a, const void* b, size_t key_size);
+
+/**
+ * @brief Creation parameters for tds_hashtable_create_ex().
+ */
+typedef struct {
+    tds_hashtable_hash_fn  hash;            /**< Key hash, NULL for tds_hashtable_hash_bytes() */
+    tds_hashtable_equal_fn equal;           /**< Key comparison, NULL for memcmp */
+    float                  max_load_factor; /**< Used + deleted slots ratio that triggers a rehash, 0 for TDS_HASHTABLE_DEFAULT_LOAD_FACTOR */
+    const tds_allocator_t* allocator;       /**< Allocator for the slot storage, NULL for malloc/free */
+    bool                   concurrent;      /**< Allow concurrent readers and writers (see below) */
+} tds_hashtable_config_t;
+
+/* Function Prototypes ------------------------------------------------------*/
+
+/**
+ * @brief Creates a new hashtable.
+ *
+ * The table is sized so that capacity entries fit under the load factor, and
+ * grows by doubling when more are inserted.
+ *
+ * Growing is incremental: the new slot array is allocated and the old one is
+ * kept next to it, then every put, get and remove moves at most
+ * TDS_HASHTABLE_MIGRATE_GROUPS * 16 entries across before doing its own work
+ * (lookups probe both arrays meanwhile). The worst case of a single call is
+ * therefore one allocation plus one memset of the new control bytes (one
+ * byte per slot) and a bounded number of entry moves, instead of a rehash of
+ * the whole table. Use tds_hashtable_reserve() to take the resize up front.
+ * A concurrent hashtable (see tds_hashtable_create_ex()) resizes at once.
+ *
+ * @param capacity The number of entries expected.
+ * @param key_size The size of each key in bytes.
+ * @param value_size The size of each value in bytes (may be 0 for a set).
+ * @return tds_hashtable_t A handle to the created hashtable, or NULL on failure.
+ */
+tds_hashtable_t tds_hashtable_create(uint32_t capacity, size_t key_size, size_t value_size);
+
+/**
+ * @brief Creates a new hashtable with an explicit configuration.
+ *
+ * With config->concurrent set, every function may be called from any thread.
+ * Readers take no lock: each probe group carries a sequence counter and a
+ * read is retried when a writer touched the group meanwhile. Writers lock
+ * only the stripes (see TDS_HASHTABLE_LOCK_STRIPES) of the groups on their
+ * probe path. A resize locks every stripe but never blocks readers, which
+ * keep using the previous table until the new one is published; retired
+ * tables are released by tds_hashtable_destroy(). Only growth retires a
+ * table, so together they hold fewer slots than the current one. Dropping
+ * tombstones without growing rewrites the table in place (readers retry)
+ * and keeps nothing. The hash and equality
+ * callbacks may then see a key being overwritten; the result is discarded
+ * and the read retried, so they must not crash on arbitrary key bytes.
+ *
+ * @param capacity The number of entries expected.
+ * @param key_size The size of each key in bytes.
+ * @param value_size The size of each value in bytes (may be 0 for a set).
+ * @param config Hashtable configuration, or NULL for TDS_HASHTABLE_CONFIG_DEFAULT.
+ * @return tds_hashtable_t A handle to the created hashtable, or NULL on failure.
+ */
+tds_hashtable_t tds_hashtable_create_ex(uint32_t capacity, size_t key_size, size_t value_size, const tds_hashtable_config_t* config);
+
+/**
+ * @brief Builds a hashtable instance inside caller-provided storage.
+ *
+ * Only the instance lives in storage; the tables still come from
+ * config->allocator, which is mandatory here. A tds_arena_t suits it: every
+ * resize allocates a new table and the arena keeps the old ones until it is
+ * reset. Concurrent mode is not available for static instances.
+ *
+ * @param storage Memory aligned to max_align_t, valid until the hashtable is destroyed.
+ * @param storage_size Size of storage, at least TDS_HASHTABLE_INSTANCE_SIZE.
+ * @param capacity The number of entries expected.
+ * @param key_size The size of each key in bytes.
+ * @param value_size The size of each value in bytes (may be 0 for a set).
+ * @param config Hashtable configuration with a non-NULL allocator and concurrent unset.
+ * @return tds_hashtable_t A handle to the hashtable (pointing into storage), or NULL on failure.
+ */
+tds_hashtable_t tds_hashtable_init_static(void* storage, size_t storage_size, uint32_t capacity, size_t key_size, size_t value_size,
+                                          const tds_hashtable_config_t* config);
+
+/**
+ * @brief Inserts a key or overwrites the value of an existing key.
+ *
+ * @param instance The hashtable instance.
+ * @param key Pointer to the key.
+ * @param value Pointer to the value (ignored when value_size is 0).
+ * @return true If the entry was stored.
+ * @return false On invalid arguments or allocation failure while growing.
+ */
+bool tds_hashtable_put(tds_hashtable_t instance, const void* key, const void* value);
+
+/**
+ * @brief Looks up a key.
+ *
+ * @param instance The hashtable instance.
+ * @param key Pointer to the key.
+ * @param value Pointer where the value will be copied, or NULL.
+ * @return true If the key was found.
+ * @return false If the key is not present.
+ */
+bool tds_hashtable_get(tds_hashtable_t instance, const void* key, void* value);
+
+/**
+ * @brief Checks whether a key is present.
+ *
+ * @param instance The hashtable instance.
+ * @param key Pointer to the key.
+ * @return true If the key was found.
+ * @return false If the key is not present.
+ */
+bool tds_hashtable_contains(tds_hashtable_t instance, const void* key);
+
+/**
+ * @brief Looks up count keys at once.
+ *
+ * Keys are handled in windows of TDS_HASHTABLE_BATCH_WINDOW: all keys of a
+ * window are hashed and the control bytes of their first probe group are
+ * prefetched, then the slots of the first candidate of each key, and only
+ * then each key is probed. The cache misses of a window therefore overlap
+ * instead of being paid one after the other, which pays off once the table
+ * no longer fits the cache. Results are the same as count calls to
+ * tds_hashtable_get(), including in the concurrent mode.
+ *
+ * @param instance The hashtable instance.
+ * @param keys Array of count keys (key_size bytes each).
+ * @param count Number of keys.
+ * @param values Array of count values where the values found are copied, or NULL.
+ *               The values of missing keys are left untouched.
+ * @param found Bit mask of (count + 63) / 64 words, bit i set if key i was found, or NULL.
+ * @return uint32_t Number of keys found.
+ */
+uint32_t tds_hashtable_get_batch(tds_hashtable_t instance, const void* keys, uint32_t count, void* values, uint64_t* found);
+
+/**
+ * @brief Removes a key.
+ *
+ * @param instance The hashtable instance.
+ * @param key Pointer to the key.
+ * @param value Pointer where the removed value will be copied, or NULL.
+ * @return true If the key was removed.
+ * @return false If the key is not present.
+ */
+bool tds_hashtable_remove(tds_hashtable_t instance, const void* key, void* value);
+
+/**
+ * @brief Returns the number of stored entries.
+ *
+ * @param instance The hashtable instance.
+ * @return int Number of entries, or -1 if the hashtable is not initialized.
+ */
+int tds_hashtable_size(tds_hashtable_t instance);
+
+/**
+ * @brief Returns the number of slots currently allocated.
+ *
+ * @param instance The hashtable instance.
+ * @return int Number of slots, or -1 if the hashtable is not initialized.
+ */
+int tds_hashtable_capacity(tds_hashtable_t instance);
+
+/**
+ * @brief Pre-sizes the hashtable for a number of entries.
+ *
+ * Grows the table at once (not incrementally) so that entries keys can be
+ * inserted without any further resize, and finishes an incremental resize in
+ * progress. Removals leave tombstones, so a table with heavy churn may still
+ * be rebuilt at the same size later. Never shrinks the table.
+ *
+ * @param instance The hashtable instance.
+ * @param entries The number of entries to make room for.
+ * @return true If the hashtable can hold entries entries.
+ * @return false If it is not initialized, entries is too large or allocation failed.
+ */
+bool tds_hashtable_reserve(tds_hashtable_t instance, uint32_t entries);
+
+/**
+ * @brief Removes every entry, keeping the slot storage.
+ *
+ * @param instance The hashtable instance.
+ * @return true If the hashtable was cleared.
+ * @return false If the hashtable is not initialized.
+ */
+bool tds_hashtable_clear(tds_hashtable_t instance);
+
+/**
+ * @brief Reads the statistics counters of the hashtable.
+ *
+ * In concurrent mode, retries counts seqlock read retries, stripe lock spins
+ * and writer restarts.
+ *
+ * @param instance The hashtable instance.
+ * @param stats Pointer where the counters will be stored (zeroed when disabled).
+ * @return true If the library was built with TDS_ENABLE_STATS.
+ * @return false If statistics are disabled or an argument is NULL.
+ */
+bool tds_hashtable_get_stats(tds_hashtable_t instance, tds_stats_t* stats);
+
+/**
+ * @brief Destroys the hashtable and frees all allocated memory.
+ *
+ * @param instance The hashtable instance.
+ * @return true If the hashtable was destroyed.
+ * @return false If the hashtable is not initialized.
+ */
+bool tds_hashtable_destroy(tds_hashtable_t instance);
+
+#if TDS_SNAPSHOT
+/**
+ * @brief Saves the hashtable to a file (see tds_snapshot.h).
+ *
+ * The slot array is written as it is laid out in memory, control bytes
+ * first, so loading it back needs no rehash. An incremental resize in
+ * progress is finished first. In concurrent mode readers may keep running,
+ * but no thread may write during the call. fd is neither synced nor closed.
+ *
+ * @param instance The hashtable instance.
+ * @param fd File descriptor opened for writing, positioned at the start of an empty file.
+ * @return true If the snapshot was written.
+ * @return false On invalid arguments or a write error.
+ */
+bool tds_hashtable_snapshot(tds_hashtable_t instance, int fd);
+
+/**
+ * @brief Creates a hashtable holding the entries saved by tds_hashtable_snapshot().
+ *
+ * The file is mapped and its control bytes and slots are copied into a new
+ * table of the same size with two memcpy: startup costs one pass over the
+ * file instead of one insert per entry. Since entries are not rehashed,
+ * config must use the same hash function as the saved hashtable; a sample
+ * of the entries is checked against it and the load fails on a mismatch.
+ * Key and value sizes come from the file.
+ *
+ * @param path Path of the snapshot file.
+ * @param config Configuration of the new hashtable (hash, equal, allocator, load factor, concurrent), or NULL for the defaults.
+ * @return tds_hashtable_t A handle to the new hashtable, or NULL if the file is invalid or does not match config.
+ */
+tds_hashtable_t tds_hashtable_load(const char* path, const tds_hashtable_config_t* config);
+#endif
+
+/**
+ * @brief Default hash: a 64-bit multiply/xor mix over the key bytes.
+ *
+ * Deterministic across runs and platforms of the same endianness.
+ *
+ * @param key Pointer to the key.
+ * @param key_size The size of the key in bytes.
+ * @return uint64_t Hash of the key.
+ */
+uint64_t tds_hashtable_hash_bytes(const void* key, size_t key_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // HASHTABLE_H
@@ -0,0 +1,243 @@
+/******************************************************************************
+ * File: tds_heap.h
+ * Author: Tiago Barbosa
+ * Description: Priority queue for embedded systems, stored as a d-ary heap
+ *              in one contiguous array. Elements are ordered by a user
+ *              comparator and can be re-prioritized through stable handles.
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef HEAP_H
+#define HEAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include <stdbool.h>  // For boolean type (true/false)
+#include <stddef.h>   // For size_t
+#include <stdint.h>   // For data types like uint8_t, int32_t, etc.
+
+#include "tds_memory.h"
+#include "tds_stats.h"
+
+/* Defines ------------------------------------------------------------------*/
+/**
+ * @brief Handle value that never refers to an element.
+ */
+#define TDS_HEAP_INVALID_HANDLE UINT32_MAX
+
+/**
+ * @brief Upper bound of the heap instance size (checked when the library is built).
+ */
+#define TDS_HEAP_INSTANCE_SIZE (64 + TDS_STATS_SIZE)
+
+/**
+ * @brief Bytes of storage tds_heap_init_static() needs.
+ *
+ * One spare element slot is used as scratch by the sift loops, plus two
+ * 32-bit entries per element for the handle table.
+ */
+#define TDS_HEAP_STORAGE_SIZE(capacity, element_size) \
+    (TDS_MEMORY_ROUND(TDS_HEAP_INSTANCE_SIZE) + TDS_MEMORY_ROUND(((size_t) (capacity) + 1) * (size_t) (element_size)) + \
+     2 * (size_t) (capacity) * sizeof(uint32_t))
+
+/* Typedefs -----------------------------------------------------------------*/
+/**
+ * @brief Opaque type for heap instance.
+ *
+ * This type is used to handle the heap instance without exposing its internals.
+ */
+typedef struct tds_heap_instance_t* tds_heap_t;
+
+/**
+ * @brief Stable reference to an element held by a heap.
+ *
+ * Returned by tds_heap_push() and tds_heap_heapify(); stays valid while the
+ * element moves inside the heap and is released when it is popped, removed
+ * or the heap is cleared (it may then be handed out again).
+ */
+typedef uint32_t tds_heap_handle_t;
+
+/**
+ * @brief Element comparison callback.
+ *
+ * @return A negative value if a must leave the heap before b, zero if either
+ *         may leave first, a positive value otherwise (a min-heap on "<").
+ */
+typedef int (*tds_heap_compare_fn)(const void* a, const void* b);
+
+/**
+ * @brief Creation parameters for tds_heap_create_ex().
+ */
+typedef struct {
+    tds_heap_compare_fn compare; /**< Element order, mandatory */
+    uint32_t            arity;   /**< Children per node (2 to 16), 0 for TDS_HEAP_ARITY */
+} tds_heap_config_t;
+
+/* Function Prototypes ------------------------------------------------------*/
+
+/**
+ * @brief Creates a new heap with TDS_HEAP_ARITY children per node.
+ *
+ * @param capacity The maximum number of elements the heap can hold.
+ * @param element_size The size of each element in bytes.
+ * @param compare Element order; the smallest element is at the top.
+ * @return tds_heap_t A handle to the created heap, or NULL on failure.
+ */
+tds_heap_t tds_heap_create(uint32_t capacity, size_t element_size, tds_heap_compare_fn compare);
+
+/**
+ * @brief Creates a new heap with an explicit configuration.
+ *
+ * All storage is allocated here: the elements live in one array in heap
+ * order, the children of slot i being slots arity * i + 1 to arity * i + arity.
+ * With the default arity of 4 the tree is half as deep as a binary heap and
+ * the children compared at each level of a sift-down are adjacent in memory,
+ * so push is O(log n / log arity) and pop O(arity * log n / log arity) with
+ * few cache misses. Sifts move a hole instead of swapping, so every level
+ * costs one element copy.
+ *
+ * @param capacity The maximum number of elements the heap can hold.
+ * @param element_size The size of each element in bytes.
+ * @param config Heap configuration with a non-NULL compare.
+ * @return tds_heap_t A handle to the created heap, or NULL on failure.
+ */
+tds_heap_t tds_heap_create_ex(uint32_t capacity, size_t element_size, const tds_heap_config_t* config);
+
+/**
+ * @brief Builds a heap inside caller-provided storage, without calling TDS_MALLOC.
+ *
+ * @param storage Memory aligned to max_align_t, valid until the heap is destroyed.
+ * @param storage_size Size of storage, at least TDS_HEAP_STORAGE_SIZE(capacity, element_size).
+ * @param capacity The maximum number of elements the heap can hold.
+ * @param element_size The size of each element in bytes.
+ * @param config Heap configuration with a non-NULL compare.
+ * @return tds_heap_t A handle to the heap (pointing into storage), or NULL on failure.
+ */
+tds_heap_t tds_heap_init_static(void* storage, size_t storage_size, uint32_t capacity, size_t element_size, const tds_heap_config_t* config);
+
+/**
+ * @brief Inserts an element.
+ *
+ * @param instance The heap instance.
+ * @param data Pointer to the element to copy in.
+ * @param handle Where to store the handle of the element, or NULL.
+ * @return true If the element was inserted.
+ * @return false If the heap is full or an argument is invalid.
+ */
+bool tds_heap_push(tds_heap_t instance, const void* data, tds_heap_handle_t* handle);
+
+/**
+ * @brief Removes the top (smallest) element.
+ *
+ * @param instance The heap instance.
+ * @param data Pointer where the element will be copied, or NULL to discard it.
+ * @return true If an element was removed.
+ * @return false If the heap is empty.
+ */
+bool tds_heap_pop(tds_heap_t instance, void* data);
+
+/**
+ * @brief Copies the top (smallest) element without removing it.
+ *
+ * @param instance The heap instance.
+ * @param data Pointer where the element will be copied.
+ * @return true If an element was copied.
+ * @return false If the heap is empty.
+ */
+bool tds_heap_peek(tds_heap_t instance, void* data);
+
+/**
+ * @brief Inserts count elements at once.
+ *
+ * The elements are appended and heap order is restored bottom-up (Floyd),
+ * which costs O(size + count) instead of O(count * log size) for as many
+ * pushes.
+ *
+ * @param instance The heap instance.
+ * @param data Pointer to an array of count elements.
+ * @param count Number of elements to insert.
+ * @param handles Array of count handles to fill, or NULL.
+ * @return true If all elements were inserted.
+ * @return false If they do not fit (nothing is inserted) or an argument is invalid.
+ */
+bool tds_heap_heapify(tds_heap_t instance, const void* data, uint32_t count, tds_heap_handle_t* handles);
+
+/**
+ * @brief Replaces the element referred to by handle and restores heap order.
+ *
+ * Works for both directions: a smaller element (decrease-key) moves up, a
+ * larger one moves down. The handle stays valid.
+ *
+ * @param instance The heap instance.
+ * @param handle Handle of an element held by the heap.
+ * @param data Pointer to the new element.
+ * @return true If the element was updated.
+ * @return false If the handle does not refer to an element of the heap.
+ */
+bool tds_heap_update(tds_heap_t instance, tds_heap_handle_t handle, const void* data);
+
+/**
+ * @brief Removes the element referred to by handle, wherever it is.
+ *
+ * @param instance The heap instance.
+ * @param handle Handle of an element held by the heap.
+ * @param data Pointer where the element will be copied, or NULL to discard it.
+ * @return true If the element was removed.
+ * @return false If the handle does not refer to an element of the heap.
+ */
+bool tds_heap_remove(tds_heap_t instance, tds_heap_handle_t handle, void* data);
+
+/**
+ * @brief Returns the current number of elements in the heap.
+ *
+ * @param instance The heap instance.
+ * @return uint32_t Number of elements, 0 if the heap is not initialized.
+ */
+uint32_t tds_heap_size(tds_heap_t instance);
+
+/**
+ * @brief Checks if the heap is empty.
+ *
+ * @param instance The heap instance.
+ * @return true If the heap is empty or not initialized.
+ * @return false If the heap holds elements.
+ */
+bool tds_heap_empty(tds_heap_t instance);
+
+/**
+ * @brief Removes every element and releases all handles, keeping the storage.
+ *
+ * @param instance The heap instance.
+ * @return true If the heap was cleared.
+ * @return false If the heap is not initialized.
+ */
+bool tds_heap_clear(tds_heap_t instance);
+
+/**
+ * @brief Reads the statistics counters of the heap.
+ *
+ * @param instance The heap instance.
+ * @param stats Pointer where the counters will be stored (zeroed when disabled).
+ * @return true If the library was built with TDS_ENABLE_STATS.
+ * @return false If statistics are disabled or an argument is NULL.
+ */
+bool tds_heap_get_stats(tds_heap_t instance, tds_stats_t* stats);
+
+/**
+ * @brief Destroys the heap and frees its storage (if it owns any).
+ *
+ * @param instance The heap instance.
+ * @return true If the heap was destroyed.
+ * @return false If the heap is not initialized.
+ */
+bool tds_heap_destroy(tds_heap_t instance);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // HEAP_H
@@ -0,0 +1,445 @@
+/******************************************************************************
+ * File: tds_list.h
+ * Author: Tiago Barbosa
+ * Description: Linked lists for embedded systems.
+ *              tds_list_t is an unrolled list: each node packs a small array
+ *              of elements sized to one or two cache lines, so scans walk
+ *              mostly contiguous memory while inserting in the middle only
+ *              shifts the elements of one node. The header-only intrusive
+ *              lists (tds_list_link_t, tds_slist_link_t) link objects that
+ *              embed the link themselves and never allocate.
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef LIST_H
+#define LIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include <stdbool.h>  // For boolean type (true/false)
+#include <stddef.h>   // For size_t
+#include <stdint.h>   // For data types like uint8_t, int32_t, etc.
+
+#include "tds_memory.h"
+
+/* Defines ------------------------------------------------------------------*/
+/**
+ * @brief Default configuration used by tds_list_create().
+ */
+#define TDS_LIST_CONFIG_DEFAULT { .allocator = NULL }
+
+/**
+ * @brief Upper bound of the list instance size (checked when the library is built).
+ *
+ * Storage needed by tds_list_init_static().
+ */
+#define TDS_LIST_INSTANCE_SIZE (64 + TDS_STATS_SIZE)
+
+/**
+ * @brief Pointer to the structure of type type whose member member is at ptr.
+ */
+#define TDS_CONTAINER_OF(ptr, type, member) ((type*) ((char*) (ptr) - offsetof(type, member)))
+
+/**
+ * @brief Iterates over the links of an intrusive doubly linked list.
+ *
+ * pos must not be removed inside the loop; use TDS_LIST_FOREACH_SAFE for that.
+ */
+#define TDS_LIST_FOREACH(pos, head) for ((pos) = (head)->next; (pos) != (head); (pos) = (pos)->next)
+
+/**
+ * @brief Iterates over an intrusive doubly linked list; pos may be removed
+ * (and reused) inside the loop. tmp holds the next link.
+ */
+#define TDS_LIST_FOREACH_SAFE(pos, tmp, head)                                                      \
+    for ((pos) = (head)->next, (tmp) = (pos)->next; (pos) != (head); (pos) = (tmp), (tmp) = (pos)->next)
+
+/**
+ * @brief Iterates over the objects of an intrusive doubly linked list.
+ *
+ * entry is a type* set to each object whose member link is on the list.
+ */
+#define TDS_LIST_FOREACH_ENTRY(entry, head, type, member)                                          \
+    for ((entry) = TDS_CONTAINER_OF((head)->next, type, member); &(entry)->member != (head);       \
+         (entry) = TDS_CONTAINER_OF((entry)->member.next, type, member))
+
+/**
+ * @brief Iterates over the objects of an intrusive doubly linked list; entry
+ * may be removed inside the loop. tmp is a second type* holding the next object.
+ */
+#define TDS_LIST_FOREACH_ENTRY_SAFE(entry, tmp, head, type, member)                                \
+    for ((entry) = TDS_CONTAINER_OF((head)->next, type, member),                                   \
+        (tmp)    = TDS_CONTAINER_OF((entry)->member.next, type, member);                           \
+         &(entry)->member != (head);                                                               \
+         (entry) = (tmp), (tmp) = TDS_CONTAINER_OF((tmp)->member.next, type, member))
+
+/**
+ * @brief Iterates over an intrusive singly linked list.
+ *
+ * prev trails pos by one link. Calling tds_slist_remove_after(prev) removes
+ * pos, and the loop then continues with the link that followed it.
+ */
+#define TDS_SLIST_FOREACH_SAFE(prev, pos, head)                                                    \
+    for ((prev) = (head); ((pos) = (prev)->next) != NULL; (prev) = ((prev)->next == (pos)) ? (pos) : (prev))
+
+/* Typedefs -----------------------------------------------------------------*/
+/**
+ * @brief Opaque type for list instance.
+ *
+ * This type is used to handle the list instance without exposing its internals.
+ */
+typedef struct tds_list_instance_t* tds_list_t;
+
+/**
+ * @brief Creation parameters for tds_list_create_ex().
+ */
+typedef struct {
+    const tds_allocator_t* allocator; /**< Allocator for the list nodes, NULL for malloc/free */
+} tds_list_config_t;
+
+/**
+ * @brief Link of an intrusive doubly linked list, embedded in the listed object.
+ *
+ * A list is a circular chain through a head link owned by the user (not
+ * embedded in any object); an empty list is a head pointing to itself.
+ */
+typedef struct tds_list_link {
+    struct tds_list_link* next;
+    struct tds_list_link* prev;
+} tds_list_link_t;
+
+/**
+ * @brief Link of an intrusive singly linked list, embedded in the listed object.
+ *
+ * The list head is a link owned by the user; the chain ends with NULL.
+ */
+typedef struct tds_slist_link {
+    struct tds_slist_link* next;
+} tds_slist_link_t;
+
+/**
+ * @brief Forward iterator over a list, obtained from tds_list_begin().
+ *
+ * Any insert or remove invalidates the iterators of the list.
+ */
+typedef struct {
+    struct tds_list_node_t* node;     /**< Node of the next element, NULL at the end */
+    uint32_t                index;    /**< Position of the next element inside node */
+    uint32_t                elements; /**< Size of a single element in bytes */
+} tds_list_iterator_t;
+
+/* Function Prototypes ------------------------------------------------------*/
+
+/**
+ * @brief Creates a new unrolled list.
+ *
+ * @param capacity The maximum number of elements the list can hold.
+ * @param element_size The size of each element in bytes.
+ * @return tds_list_t A handle to the created list, or NULL on failure.
+ */
+tds_list_t tds_list_create(uint32_t capacity, size_t element_size);
+
+/**
+ * @brief Creates a new unrolled list with an explicit configuration.
+ *
+ * Nodes are TDS_LIST_NODE_BYTES long (see tds_config.h) and hold as many
+ * elements as fit after the node header, at least one. A full node is split
+ * in two when an element is inserted in its middle; a node left less than
+ * half full by a removal absorbs its successor when both fit in one node,
+ * or else is merged into its predecessor when those two fit.
+ * Every node comes from the configured allocator, so a tds_pool_t of
+ * tds_list_node_size() blocks keeps the list off the system heap.
+ *
+ * @param capacity The maximum number of elements the list can hold.
+ * @param element_size The size of each element in bytes.
+ * @param config List configuration, or NULL for TDS_LIST_CONFIG_DEFAULT.
+ * @return tds_list_t A handle to the created list, or NULL on failure.
+ */
+tds_list_t tds_list_create_ex(uint32_t capacity, size_t element_size, const tds_list_config_t* config);
+
+/**
+ * @brief Builds a list instance inside caller-provided storage.
+ *
+ * Only the instance lives in storage; the nodes still come from
+ * config->allocator, which is mandatory here (e.g. a static tds_pool_t of
+ * tds_list_node_size() blocks). tds_list_destroy() releases the nodes only.
+ *
+ * @param storage Memory aligned to max_align_t, valid until the list is destroyed.
+ * @param storage_size Size of storage, at least TDS_LIST_INSTANCE_SIZE.
+ * @param capacity The maximum number of elements the list can hold.
+ * @param element_size The size of each element in bytes.
+ * @param config List configuration with a non-NULL allocator.
+ * @return tds_list_t A handle to the list (pointing into storage), or NULL on failure.
+ */
+tds_list_t tds_list_init_static(void* storage, size_t storage_size, uint32_t capacity, size_t element_size, const tds_list_config_t* config);
+
+/**
+ * @brief Returns the size of one list node for an element size.
+ *
+ * @param element_size The size of each element in bytes.
+ * @return size_t Bytes requested from the allocator per node.
+ */
+size_t tds_list_node_size(size_t element_size);
+
+/**
+ * @brief Inserts an element so that it ends at position index.
+ *
+ * Finding the position walks the nodes (from the nearer end), not the
+ * elements; the insert itself shifts at most one node's elements.
+ *
+ * @param instance The list instance.
+ * @param index Position of the new element, from 0 to tds_list_size().
+ * @param data Pointer to the element.
+ * @return true If the element was inserted.
+ * @return false If the list is full, index is out of range or allocation failed.
+ */
+bool tds_list_insert(tds_list_t instance, uint32_t index, const void* data);
+
+/**
+ * @brief Appends an element at the end of the list.
+ *
+ * @param instance The list instance.
+ * @param data Pointer to the element.
+ * @return true If the element was appended.
+ * @return false If the list is full or allocation failed.
+ */
+bool tds_list_push_back(tds_list_t instance, const void* data);
+
+/**
+ * @brief Inserts an element at the front of the list.
+ *
+ * @param instance The list instance.
+ * @param data Pointer to the element.
+ * @return true If the element was inserted.
+ * @return false If the list is full or allocation failed.
+ */
+bool tds_list_push_front(tds_list_t instance, const void* data);
+
+/**
+ * @brief Removes the element at position index.
+ *
+ * @param instance The list instance.
+ * @param index Position of the element.
+ * @param data Pointer where the removed element will be copied, or NULL.
+ * @return true If the element was removed.
+ * @return false If index is out of range.
+ */
+bool tds_list_remove(tds_list_t instance, uint32_t index, void* data);
+
+/**
+ * @brief Copies the element at position index.
+ *
+ * @param instance The list instance.
+ * @param index Position of the element.
+ * @param data Pointer where the element will be copied.
+ * @return true If the element was copied.
+ * @return false If index is out of range.
+ */
+bool tds_list_get(tds_list_t instance, uint32_t index, void* data);
+
+/**
+ * @brief Finds the first element equal (memcmp) to data.
+ *
+ * Every call counts as one operation in the statistics, whether or not the
+ * element is found.
+ *
+ * @param instance The list instance.
+ * @param data Pointer to the element to look for.
+ * @return int Position of the element, or -1 if it is not present.
+ */
+int tds_list_find(tds_list_t instance, const void* data);
+
+/**
+ * @brief Returns the number of elements in the list.
+ *
+ * @param instance The list instance.
+ * @return int Number of elements, or -1 if the list is not initialized.
+ */
+int tds_list_size(tds_list_t instance);
+
+/**
+ * @brief Checks if the list is empty.
+ *
+ * @param instance The list instance.
+ * @return true If the list is empty or not initialized.
+ * @return false If the list has one or more elements.
+ */
+bool tds_list_empty(tds_list_t instance);
+
+/**
+ * @brief Removes every element and frees the nodes.
+ *
+ * @param instance The list instance.
+ * @return true If the list was cleared.
+ * @return false If the list is not initialized.
+ */
+bool tds_list_clear(tds_list_t instance);
+
+/**
+ * @brief Reads the statistics counters of the list.
+ *
+ * @param instance The list instance.
+ * @param stats Pointer where the counters will be stored (zeroed when disabled).
+ * @return true If the library was built with TDS_ENABLE_STATS.
+ * @return false If statistics are disabled or an argument is NULL.
+ */
+bool tds_list_get_stats(tds_list_t instance, tds_stats_t* stats);
+
+/**
+ * @brief Destroys the list and frees all allocated memory.
+ *
+ * @param instance The list instance.
+ * @return true If the list was destroyed.
+ * @return false If the list is not initialized.
+ */
+bool tds_list_destroy(tds_list_t instance);
+
+/**
+ * @brief Returns an iterator positioned on the first element.
+ *
+ * @param instance The list instance.
+ * @return tds_list_iterator_t Iterator (already at the end for an empty list).
+ */
+tds_list_iterator_t tds_list_begin(tds_list_t instance);
+
+/**
+ * @brief Returns the next element and advances the iterator.
+ *
+ * @param it The iterator.
+ * @return void* Pointer to the element inside the list, or NULL at the end.
+ */
+void* tds_list_next(tds_list_iterator_t* it);
+
+/**
+ * @brief Returns the remaining elements of the current node and moves to the next node.
+ *
+ * The elements are contiguous, so a scan can process each span as a plain
+ * array; this is the fastest way to traverse the list.
+ *
+ * @param it The iterator.
+ * @param count Receives the number of elements in the span.
+ * @return void* Pointer to the first element of the span, or NULL at the end.
+ */
+void* tds_list_next_span(tds_list_iterator_t* it, uint32_t* count);
+
+/* Intrusive Lists ----------------------------------------------------------*/
+
+/**
+ * @brief Initializes a list head (or an unlinked link) to point to itself.
+ */
+static inline void tds_list_link_init(tds_list_link_t* link) {
+    link->next = link;
+    link->prev = link;
+}
+
+/**
+ * @brief Checks whether the list of head has no links.
+ */
+static inline bool tds_list_link_empty(const tds_list_link_t* head) {
+    return head->next == head;
+}
+
+/**
+ * @brief Checks whether a link removed with tds_list_link_remove() (or only
+ * initialized) is currently on a list.
+ */
+static inline bool tds_list_link_linked(const tds_list_link_t* link) {
+    return link->next != link;
+}
+
+/**
+ * @brief Inserts link right after pos (pos may be the head: push to the front).
+ */
+static inline void tds_list_link_insert_after(tds_list_link_t* pos, tds_list_link_t* link) {
+    link->next      = pos->next;
+    link->prev      = pos;
+    pos->next->prev = link;
+    pos->next       = link;
+}
+
+/**
+ * @brief Inserts link right before pos (pos may be the head: push to the back).
+ */
+static inline void tds_list_link_insert_before(tds_list_link_t* pos, tds_list_link_t* link) {
+    tds_list_link_insert_after(pos->prev, link);
+}
+
+static inline void tds_list_link_push_front(tds_list_link_t* head, tds_list_link_t* link) {
+    tds_list_link_insert_after(head, link);
+}
+
+static inline void tds_list_link_push_back(tds_list_link_t* head, tds_list_link_t* link) {
+    tds_list_link_insert_before(head, link);
+}
+
+/**
+ * @brief Unlinks link from its list and leaves it pointing to itself.
+ */
+static inline void tds_list_link_remove(tds_list_link_t* link) {
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    tds_list_link_init(link);
+}
+
+/**
+ * @brief First link of the list of head, or NULL if it is empty.
+ */
+static inline tds_list_link_t* tds_list_link_first(const tds_list_link_t* head) {
+    return head->next != head ? head->next : NULL;
+}
+
+/**
+ * @brief Last link of the list of head, or NULL if it is empty.
+ */
+static inline tds_list_link_t* tds_list_link_last(const tds_list_link_t* head) {
+    return head->prev != head ? head->prev : NULL;
+}
+
+/**
+ * @brief Initializes a singly linked list head.
+ */
+static inline void tds_slist_init(tds_slist_link_t* head) {
+    head->next = NULL;
+}
+
+static inline bool tds_slist_empty(const tds_slist_link_t* head) {
+    return head->next == NULL;
+}
+
+/**
+ * @brief Inserts link right after pos (pos may be the head: push to the front).
+ */
+static inline void tds_slist_insert_after(tds_slist_link_t* pos, tds_slist_link_t* link) {
+    link->next = pos->next;
+    pos->next  = link;
+}
+
+static inline void tds_slist_push_front(tds_slist_link_t* head, tds_slist_link_t* link) {
+    tds_slist_insert_after(head, link);
+}
+
+/**
+ * @brief Unlinks and returns the link following pos, or NULL if pos is the last one.
+ */
+static inline tds_slist_link_t* tds_slist_remove_after(tds_slist_link_t* pos) {
+    tds_slist_link_t* link = pos->next;
+    if (link) {
+        pos->next  = link->next;
+        link->next = NULL;
+    }
+    return link;
+}
+
+static inline tds_slist_link_t* tds_slist_pop_front(tds_slist_link_t* head) {
+    return tds_slist_remove_after(head);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIST_H
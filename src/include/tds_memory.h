@@ -0,0 +1,401 @@
+/******************************************************************************
+ * File: tds_memory.h
+ * Author: Tiago Barbosa
+ * Description: Memory management helpers for embedded systems.
+ *              Provides the allocator interface used by the TDS containers,
+ *              a fixed-size block pool with O(1) allocation and release,
+ *              a bump-pointer arena released all at once and a thread-caching
+ *              block allocator (per-thread magazines over a shared depot).
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include <stdbool.h>  // For boolean type (true/false)
+#include <stddef.h>   // For size_t, max_align_t
+#include <stdint.h>   // For data types like uint8_t, int32_t, etc.
+
+#include "tds_stats.h"
+
+/* Defines ------------------------------------------------------------------*/
+/**
+ * @brief Granularity of pool blocks, arena allocations and the regions the
+ * storage size macros reserve for each part of a static instance.
+ */
+#define TDS_MEMORY_ALIGN (_Alignof(max_align_t))
+
+/**
+ * @brief Rounds size up to a multiple of TDS_MEMORY_ALIGN.
+ */
+#define TDS_MEMORY_ROUND(size) (((size_t) (size) + TDS_MEMORY_ALIGN - 1) & ~(size_t) (TDS_MEMORY_ALIGN - 1))
+
+/**
+ * @brief Upper bound of the pool instance size (checked when the library is built).
+ */
+#define TDS_POOL_INSTANCE_SIZE (48 + TDS_STATS_SIZE)
+
+/**
+ * @brief Bytes of storage tds_pool_init_static() needs for block_count blocks.
+ */
+#define TDS_POOL_STORAGE_SIZE(block_size, block_count) \
+    (TDS_MEMORY_ROUND(TDS_POOL_INSTANCE_SIZE) +         \
+     (size_t) (block_count) * TDS_MEMORY_ROUND((size_t) (block_size) < sizeof(void*) ? sizeof(void*) : (size_t) (block_size)))
+
+/**
+ * @brief Upper bound of the arena instance size (checked when the library is built).
+ */
+#define TDS_ARENA_INSTANCE_SIZE (64 + TDS_STATS_SIZE)
+
+/**
+ * @brief Bytes of storage tds_arena_init_static() needs to serve bytes bytes of allocations.
+ */
+#define TDS_ARENA_STORAGE_SIZE(bytes) \
+    (TDS_MEMORY_ROUND(TDS_ARENA_INSTANCE_SIZE) + TDS_MEMORY_ROUND(2 * sizeof(size_t)) + TDS_MEMORY_ROUND(bytes))
+
+/* Typedefs -----------------------------------------------------------------*/
+/**
+ * @brief Allocator interface used by the containers for their nodes.
+ *
+ * The structure is copied into the container at create time, so it does not
+ * need to outlive the create call. The context is passed back untouched to
+ * both callbacks.
+ *
+ * free may be NULL for region allocators such as tds_arena_allocator(): the
+ * containers then never release single blocks and their destroy skips the
+ * walk over the nodes, leaving the memory to the region.
+ */
+typedef struct {
+    void* (*alloc)(void* context, size_t size); /**< Returns a block of at least size bytes, or NULL */
+    void (*free)(void* context, void* ptr);     /**< Releases a block returned by alloc, or NULL */
+    void* context;                              /**< User data forwarded to the callbacks */
+} tds_allocator_t;
+
+/**
+ * @brief Opaque type for memory pool instance.
+ *
+ * This type is used to handle the pool instance without exposing its internals.
+ */
+typedef struct tds_pool_instance_t* tds_pool_t;
+
+/**
+ * @brief Opaque type for arena instance.
+ *
+ * This type is used to handle the arena instance without exposing its internals.
+ */
+typedef struct tds_arena_instance_t* tds_arena_t;
+
+/**
+ * @brief Opaque type for block cache instance.
+ *
+ * This type is used to handle the cache instance without exposing its internals.
+ */
+typedef struct tds_cache_instance_t* tds_cache_t;
+
+/* Inline Functions ---------------------------------------------------------*/
+
+/**
+ * @brief Releases a block through an allocator, doing nothing when it has no free.
+ */
+static inline void tds_allocator_release(const tds_allocator_t* allocator, void* ptr) {
+    if (allocator->free) {
+        allocator->free(allocator->context, ptr);
+    }
+}
+
+/* Function Prototypes ------------------------------------------------------*/
+
+/**
+ * @brief Returns the allocator backed by the C library malloc/free.
+ *
+ * @return const tds_allocator_t* Pointer to a static allocator, never NULL.
+ */
+const tds_allocator_t* tds_allocator_default(void);
+
+/**
+ * @brief Creates a pool of fixed-size blocks.
+ *
+ * All blocks are carved from a single allocation made here, so later
+ * allocations and releases never reach the system heap. Block size is rounded
+ * up to the platform's maximum fundamental alignment.
+ *
+ * @param block_size The size of each block in bytes.
+ * @param block_count The number of blocks in the pool.
+ * @return tds_pool_t A handle to the created pool, or NULL on failure.
+ */
+tds_pool_t tds_pool_create(size_t block_size, uint32_t block_count);
+
+/**
+ * @brief Builds a pool inside caller-provided storage, without touching the heap.
+ *
+ * @param storage Memory aligned to max_align_t that holds the instance and
+ *                the blocks until the pool is destroyed.
+ * @param storage_size Size of storage, at least TDS_POOL_STORAGE_SIZE(block_size, block_count).
+ * @param block_size The size of each block in bytes.
+ * @param block_count The number of blocks in the pool.
+ * @return tds_pool_t A handle to the pool (pointing into storage), or NULL on failure.
+ */
+tds_pool_t tds_pool_init_static(void* storage, size_t storage_size, size_t block_size, uint32_t block_count);
+
+/**
+ * @brief Takes a block from the pool in O(1).
+ *
+ * @param pool The pool instance.
+ * @return void* Pointer to the block, or NULL if the pool is exhausted.
+ */
+void* tds_pool_alloc(tds_pool_t pool);
+
+/**
+ * @brief Returns a block to the pool in O(1).
+ *
+ * @param pool The pool instance.
+ * @param block Pointer previously returned by tds_pool_alloc().
+ * @return true If the block was returned to the pool.
+ * @return false If the pointer does not belong to the pool.
+ */
+bool tds_pool_free(tds_pool_t pool, void* block);
+
+/**
+ * @brief Returns the number of blocks still available in the pool.
+ *
+ * @param pool The pool instance.
+ * @return int Free block count, or -1 if the pool is not initialized.
+ */
+int tds_pool_available(tds_pool_t pool);
+
+/**
+ * @brief Returns the usable size of each block (after alignment rounding).
+ *
+ * @param pool The pool instance.
+ * @return size_t Block size in bytes, or 0 if the pool is not initialized.
+ */
+size_t tds_pool_block_size(tds_pool_t pool);
+
+/**
+ * @brief Builds an allocator that serves requests from the pool.
+ *
+ * Requests larger than the pool block size fail. The pool must outlive every
+ * container using the returned allocator.
+ *
+ * @param pool The pool instance.
+ * @return tds_allocator_t Allocator bound to the pool.
+ */
+tds_allocator_t tds_pool_allocator(tds_pool_t pool);
+
+/**
+ * @brief Reads the statistics counters of the pool.
+ *
+ * operations counts block allocations and frees, failed_empty the allocations
+ * refused because every block was in use, high_water the most blocks in use.
+ *
+ * @param pool The pool instance.
+ * @param stats Pointer where the counters will be stored (zeroed when disabled).
+ * @return true If the library was built with TDS_ENABLE_STATS.
+ * @return false If statistics are disabled or an argument is NULL.
+ */
+bool tds_pool_get_stats(tds_pool_t pool, tds_stats_t* stats);
+
+/**
+ * @brief Destroys the pool and its storage.
+ *
+ * Blocks still in use become invalid.
+ *
+ * @param pool The pool instance.
+ * @return true If the pool was destroyed.
+ * @return false If the pool was not initialized.
+ */
+bool tds_pool_destroy(tds_pool_t pool);
+
+/**
+ * @brief Creates an arena that hands out memory by bumping a pointer.
+ *
+ * Memory comes from blocks of at least block_size bytes; a request that does
+ * not fit the current block moves to the next one, allocated on first use and
+ * kept for later frames. Not thread-safe.
+ *
+ * @param block_size The size of each block in bytes (a larger request gets its own block).
+ * @return tds_arena_t A handle to the created arena, or NULL on failure.
+ */
+tds_arena_t tds_arena_create(size_t block_size);
+
+/**
+ * @brief Builds a fixed-size arena inside caller-provided storage.
+ *
+ * The arena never grows: requests that no longer fit fail until the next
+ * reset.
+ *
+ * @param storage Memory aligned to max_align_t that holds the instance and
+ *                the allocations until the arena is destroyed.
+ * @param storage_size Size of storage, e.g. TDS_ARENA_STORAGE_SIZE(bytes).
+ * @return tds_arena_t A handle to the arena (pointing into storage), or NULL on failure.
+ */
+tds_arena_t tds_arena_init_static(void* storage, size_t storage_size);
+
+/**
+ * @brief Takes size bytes from the arena, aligned to max_align_t.
+ *
+ * @param arena The arena instance.
+ * @param size Number of bytes requested.
+ * @return void* Pointer to the memory, valid until the next reset, or NULL on failure.
+ */
+void* tds_arena_alloc(tds_arena_t arena, size_t size);
+
+/**
+ * @brief Releases everything allocated from the arena in O(1).
+ *
+ * The blocks are kept and reused, so a steady frame stops reaching the
+ * system heap. Containers allocating from the arena must be destroyed first.
+ *
+ * @param arena The arena instance.
+ * @return true If the arena was reset.
+ * @return false If the arena is not initialized.
+ */
+bool tds_arena_reset(tds_arena_t arena);
+
+/**
+ * @brief Returns the bytes handed out since the last reset (after alignment).
+ *
+ * @param arena The arena instance.
+ * @return size_t Bytes in use, or 0 if the arena is not initialized.
+ */
+size_t tds_arena_used(tds_arena_t arena);
+
+/**
+ * @brief Builds an allocator that serves requests from the arena.
+ *
+ * Its free callback is NULL: containers using it never release single nodes
+ * and their destroy takes constant time. The arena must outlive every
+ * container using the returned allocator.
+ *
+ * @param arena The arena instance.
+ * @return tds_allocator_t Allocator bound to the arena.
+ */
+tds_allocator_t tds_arena_allocator(tds_arena_t arena);
+
+/**
+ * @brief Reads the statistics counters of the arena.
+ *
+ * operations counts allocations, failed_full the requests no block could
+ * serve, allocations the blocks taken from the system and high_water the most
+ * bytes in use between two resets.
+ *
+ * @param arena The arena instance.
+ * @param stats Pointer where the counters will be stored (zeroed when disabled).
+ * @return true If the library was built with TDS_ENABLE_STATS.
+ * @return false If statistics are disabled or an argument is NULL.
+ */
+bool tds_arena_get_stats(tds_arena_t arena, tds_stats_t* stats);
+
+/**
+ * @brief Destroys the arena and all of its blocks.
+ *
+ * @param arena The arena instance.
+ * @return true If the arena was destroyed.
+ * @return false If the arena was not initialized.
+ */
+bool tds_arena_destroy(tds_arena_t arena);
+
+/**
+ * @brief Creates a thread-safe cache of fixed-size blocks.
+ *
+ * Each thread keeps two magazines (stacks of up to magazine_size free
+ * blocks) and allocates and frees through them without locks or atomics.
+ * Only when both are empty (or full) does it trade a whole magazine with the
+ * shared depot under a short lock, so a thread reaches the depot at most once
+ * every magazine_size operations. Blocks are interchangeable: a block freed
+ * by another thread than the one that allocated it simply joins the freeing
+ * thread's magazine. New blocks are carved from slabs of 4 * magazine_size
+ * blocks taken from TDS_MALLOC and only returned by tds_cache_destroy().
+ *
+ * @param block_size The size of each block in bytes.
+ * @param magazine_size Blocks per magazine, 0 for TDS_CACHE_MAGAZINE_SIZE.
+ * @return tds_cache_t A handle to the created cache, or NULL on failure.
+ */
+tds_cache_t tds_cache_create(size_t block_size, uint32_t magazine_size);
+
+/**
+ * @brief Takes a block, from the calling thread's magazines when possible.
+ *
+ * @param cache The cache instance.
+ * @return void* Pointer to the block, or NULL if memory is exhausted.
+ */
+void* tds_cache_alloc(tds_cache_t cache);
+
+/**
+ * @brief Returns a block to the calling thread's magazines (any thread may free any block).
+ *
+ * @param cache The cache instance.
+ * @param block Pointer previously returned by tds_cache_alloc() on the same cache.
+ * @return true If the block was released.
+ * @return false If an argument is NULL.
+ */
+bool tds_cache_free(tds_cache_t cache, void* block);
+
+/**
+ * @brief Hands the calling thread's magazines back to the depot.
+ *
+ * Call it before a thread that used the cache exits, so its free blocks
+ * become available to the other threads. The thread may keep using the
+ * cache afterwards.
+ *
+ * @param cache The cache instance.
+ * @return true If the magazines were returned (or the thread held none).
+ * @return false If the cache is not initialized.
+ */
+bool tds_cache_flush(tds_cache_t cache);
+
+/**
+ * @brief Returns the usable size of each block (after alignment rounding).
+ *
+ * @param cache The cache instance.
+ * @return size_t Block size in bytes, or 0 if the cache is not initialized.
+ */
+size_t tds_cache_block_size(tds_cache_t cache);
+
+/**
+ * @brief Builds an allocator that serves requests from the cache.
+ *
+ * Requests larger than the cache block size fail. The cache must outlive
+ * every container using the returned allocator.
+ *
+ * @param cache The cache instance.
+ * @return tds_allocator_t Allocator bound to the cache.
+ */
+tds_allocator_t tds_cache_allocator(tds_cache_t cache);
+
+/**
+ * @brief Reads the statistics counters of the cache.
+ *
+ * operations counts block allocations and frees, allocations the slabs,
+ * magazines and thread records taken from the system, high_water the blocks
+ * carved from slabs and retries the spins on the depot lock.
+ *
+ * @param cache The cache instance.
+ * @param stats Pointer where the counters will be stored (zeroed when disabled).
+ * @return true If the library was built with TDS_ENABLE_STATS.
+ * @return false If statistics are disabled or an argument is NULL.
+ */
+bool tds_cache_get_stats(tds_cache_t cache, tds_stats_t* stats);
+
+/**
+ * @brief Destroys the cache with all of its slabs and magazines.
+ *
+ * No thread may be using the cache anymore; blocks still in use become invalid.
+ *
+ * @param cache The cache instance.
+ * @return true If the cache was destroyed.
+ * @return false If the cache was not initialized.
+ */
+bool tds_cache_destroy(tds_cache_t cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MEMORY_H
@@ -22,7 +22,51 @@ extern "C" {
 #include <stdlib.h>  // For malloc, free
 #include <string.h>  // For memcpy, memmove
 
+#include "tds_memory.h"
+#include "tds_stats.h"
+
 /* Defines ------------------------------------------------------------------*/
+/**
+ * @brief Default configuration used by tds_queue_create().
+ */
+#define TDS_QUEUE_CONFIG_DEFAULT { .mode = TDS_QUEUE_MODE_LINKED, .allocator = NULL }
+
+/**
+ * @brief Timeout of tds_queue_enqueue_wait()/tds_queue_dequeue_wait() that never expires.
+ */
+#define TDS_QUEUE_WAIT_FOREVER UINT32_MAX
+
+/**
+ * @brief Upper bound of the parking state embedded in a queue instance.
+ */
+#if TDS_QUEUE_BLOCKING == 2
+#define TDS_QUEUE_WAIT_SIZE 256
+#elif TDS_QUEUE_BLOCKING
+#define TDS_QUEUE_WAIT_SIZE 16
+#else
+#define TDS_QUEUE_WAIT_SIZE 0
+#endif
+
+/**
+ * @brief Upper bound of the queue instance size (checked when the library is built).
+ *
+ * Storage of a linked-mode queue built with tds_queue_init_static().
+ */
+#define TDS_QUEUE_INSTANCE_SIZE (3 * TDS_CACHE_LINE_SIZE + 128 + TDS_QUEUE_WAIT_SIZE + TDS_STATS_SIZE)
+
+/**
+ * @brief Bytes of storage tds_queue_init_static() needs in TDS_QUEUE_MODE_RING.
+ */
+#define TDS_QUEUE_STORAGE_SIZE(capacity, element_size) \
+    (TDS_MEMORY_ROUND(TDS_QUEUE_INSTANCE_SIZE) + (size_t) (capacity) * (size_t) (element_size))
+
+/**
+ * @brief Bytes of storage tds_queue_init_static() needs in TDS_QUEUE_MODE_MPMC.
+ *
+ * capacity must be a power of two here, since the MPMC mode rounds it up.
+ */
+#define TDS_QUEUE_MPMC_STORAGE_SIZE(capacity, element_size) \
+    (TDS_MEMORY_ROUND(TDS_QUEUE_INSTANCE_SIZE) + (size_t) (capacity) * (((size_t) (element_size) + 7) & ~(size_t) 3))
 
 /* Typedefs -----------------------------------------------------------------*/
 /**
@@ -33,10 +77,70 @@ extern "C" {
  */
 typedef struct tds_queue_instance_t* tds_queue_t;
 
+/**
+ * @brief Storage engine used by a queue instance.
+ */
+typedef enum {
+    TDS_QUEUE_MODE_LINKED = 0, /**< One heap node per element, memory grows with the queue */
+    TDS_QUEUE_MODE_RING,       /**< Single contiguous buffer of capacity * element_size bytes */
+    TDS_QUEUE_MODE_MPMC,       /**< Lock-free bounded multi-producer/multi-consumer ring, capacity rounded up to a power of two */
+} tds_queue_mode_t;
 
+/**
+ * @brief Creation parameters for tds_queue_create_ex().
+ */
+typedef struct {
+    tds_queue_mode_t       mode;      /**< Storage engine for the queue elements */
+    const tds_allocator_t* allocator; /**< Allocator for linked nodes, NULL for malloc/free */
+} tds_queue_config_t;
 
+/* Function Prototypes ------------------------------------------------------*/
 
 tds_queue_t tds_queue_create(uint32_t capacity, size_t element_size);
+
+/**
+ * @brief Creates a new queue instance with an explicit configuration.
+ *
+ * In TDS_QUEUE_MODE_RING the whole storage is allocated up front, so enqueue
+ * and dequeue never touch the heap and reduce to a bounds check plus a memcpy.
+ * TDS_QUEUE_MODE_MPMC uses the same contiguous layout with a sequence number
+ * per slot and is the only mode accepted by the *_threadsafe functions.
+ *
+ * @param capacity The maximum number of elements the queue can hold.
+ * @param element_size The size of each element in bytes.
+ * @param config Queue configuration, or NULL for TDS_QUEUE_CONFIG_DEFAULT.
+ * @return tds_queue_t A handle to the created queue, or NULL on failure.
+ */
+tds_queue_t tds_queue_create_ex(uint32_t capacity, size_t element_size, const tds_queue_config_t* config);
+
+/**
+ * @brief Builds a queue inside caller-provided storage, without touching the heap.
+ *
+ * The instance and, in ring and MPMC modes, the element storage are carved
+ * from storage; tds_queue_destroy() then releases nothing but the remaining
+ * linked nodes. A linked-mode queue must be given an allocator for its nodes
+ * (e.g. a static tds_pool_t or tds_arena_t).
+ *
+ * @param storage Memory aligned to max_align_t, valid until the queue is destroyed.
+ * @param storage_size Size of storage: TDS_QUEUE_STORAGE_SIZE(), TDS_QUEUE_MPMC_STORAGE_SIZE()
+ *                     or TDS_QUEUE_INSTANCE_SIZE depending on the mode.
+ * @param capacity The maximum number of elements the queue can hold.
+ * @param element_size The size of each element in bytes.
+ * @param config Queue configuration, or NULL for TDS_QUEUE_MODE_RING.
+ * @return tds_queue_t A handle to the queue (pointing into storage), or NULL on failure.
+ */
+tds_queue_t tds_queue_init_static(void* storage, size_t storage_size, uint32_t capacity, size_t element_size, const tds_queue_config_t* config);
+
+/**
+ * @brief Returns the size of one linked-mode node holding an element.
+ *
+ * Use it as the block size of a tds_pool_t serving a queue allocator.
+ *
+ * @param element_size The size of each element in bytes.
+ * @return size_t Bytes requested from the allocator per enqueued element.
+ */
+size_t tds_queue_node_size(size_t element_size);
+
 bool tds_queue_enqueue(tds_queue_t instance, const void* data);
 bool tds_queue_dequeue(tds_queue_t instance, void* data);
 bool tds_queue_empty(tds_queue_t instance);
@@ -44,6 +148,172 @@ bool tds_queue_peek(tds_queue_t instance, void *data);
 int  tds_queue_size(tds_queue_t instance);
 bool tds_queue_destroy(tds_queue_t instance);
 
+/**
+ * @brief Enqueues up to count elements from a contiguous array.
+ *
+ * Argument and capacity checks run once per call. In TDS_QUEUE_MODE_RING the
+ * span is copied with at most two memcpy calls; in TDS_QUEUE_MODE_MPMC the
+ * slots are claimed with a single compare-and-swap, so the call is also
+ * thread-safe in that mode.
+ *
+ * @param instance The queue instance.
+ * @param data Pointer to an array of count elements.
+ * @param count Number of elements to enqueue.
+ * @return uint32_t Number of elements enqueued, stopping early when the queue is full.
+ */
+uint32_t tds_queue_enqueue_n(tds_queue_t instance, const void* data, uint32_t count);
+
+/**
+ * @brief Dequeues up to count elements into a contiguous array, oldest first.
+ *
+ * @param instance The queue instance.
+ * @param data Pointer to an array with room for count elements.
+ * @param count Maximum number of elements to dequeue.
+ * @return uint32_t Number of elements dequeued, stopping early when the queue is empty.
+ */
+uint32_t tds_queue_dequeue_n(tds_queue_t instance, void* data, uint32_t count);
+
+/**
+ * @brief Reserves contiguous free slots for in-place writing (TDS_QUEUE_MODE_RING only).
+ *
+ * The returned span never wraps, so fewer than count slots may be granted.
+ * The slots become visible to dequeue/peek only after tds_queue_commit().
+ * A new reservation replaces a pending one, and any enqueue before the
+ * commit cancels it (the enqueue may have used the reserved slots): the
+ * commit then fails and the in-place writes are dropped.
+ *
+ * @param instance The queue instance.
+ * @param count Number of slots wanted.
+ * @param reserved Output: number of slots actually granted.
+ * @return void* Pointer to the first granted slot, or NULL if none is available.
+ */
+void* tds_queue_reserve(tds_queue_t instance, uint32_t count, uint32_t* reserved);
+
+/**
+ * @brief Publishes the first count slots of the last reservation.
+ *
+ * @param instance The queue instance.
+ * @param count Number of slots written, at most the number granted.
+ * @return true If the elements were published.
+ * @return false If count exceeds the pending reservation, or it was cancelled by an enqueue.
+ */
+bool tds_queue_commit(tds_queue_t instance, uint32_t count);
+
+/**
+ * @brief Exposes the oldest queued elements in place (TDS_QUEUE_MODE_RING only).
+ *
+ * The span never wraps; call again after tds_queue_consume() to reach the rest.
+ *
+ * @param instance The queue instance.
+ * @param count Output: number of contiguous elements readable at the returned pointer.
+ * @return const void* Pointer to the oldest element, or NULL if the queue is empty.
+ */
+const void* tds_queue_peek_span(tds_queue_t instance, uint32_t* count);
+
+/**
+ * @brief Releases the count oldest elements after reading them in place.
+ *
+ * @param instance The queue instance.
+ * @param count Number of elements to drop.
+ * @return uint32_t Number of elements actually released.
+ */
+uint32_t tds_queue_consume(tds_queue_t instance, uint32_t count);
+
+/**
+ * @brief Enqueues an element from any thread without taking a lock.
+ *
+ * Producers claim a slot with a single compare-and-swap on the enqueue
+ * position, then publish it through the slot's sequence number, so
+ * producers and consumers only contend on their own position counter.
+ *
+ * @param instance A queue created in TDS_QUEUE_MODE_MPMC.
+ * @param data Pointer to the data to be enqueued.
+ * @return true If the element was enqueued.
+ * @return false If the queue is full, or not in TDS_QUEUE_MODE_MPMC.
+ */
+bool tds_queue_enqueue_threadsafe(tds_queue_t instance, const void* data);
+
+/**
+ * @brief Dequeues an element from any thread without taking a lock.
+ *
+ * @param instance A queue created in TDS_QUEUE_MODE_MPMC.
+ * @param data Pointer where the dequeued element will be stored.
+ * @return true If an element was dequeued.
+ * @return false If the queue is empty, or not in TDS_QUEUE_MODE_MPMC.
+ */
+bool tds_queue_dequeue_threadsafe(tds_queue_t instance, void* data);
+
+#if TDS_QUEUE_BLOCKING
+/**
+ * @brief Enqueues an element, waiting up to timeout_ms for a free slot.
+ *
+ * The caller first retries TDS_QUEUE_SPIN_COUNT times, then parks (futex or
+ * condition variable, see TDS_QUEUE_BLOCKING) until a consumer frees a slot.
+ * Consumers only issue a wake system call while some producer is parked, so
+ * queues without waiters pay one extra load per operation.
+ *
+ * @param instance A queue created in TDS_QUEUE_MODE_MPMC.
+ * @param data Pointer to the data to be enqueued.
+ * @param timeout_ms Milliseconds to wait, 0 to try once, TDS_QUEUE_WAIT_FOREVER to never give up.
+ * @return true If the element was enqueued.
+ * @return false On timeout, invalid arguments, or if the queue is not in TDS_QUEUE_MODE_MPMC.
+ */
+bool tds_queue_enqueue_wait(tds_queue_t instance, const void* data, uint32_t timeout_ms);
+
+/**
+ * @brief Dequeues an element, waiting up to timeout_ms for one to arrive.
+ *
+ * Same spin-then-park scheme as tds_queue_enqueue_wait(); every MPMC
+ * enqueue function (plain, _n, _threadsafe, _wait) wakes parked consumers.
+ *
+ * @param instance A queue created in TDS_QUEUE_MODE_MPMC.
+ * @param data Pointer where the dequeued element will be stored.
+ * @param timeout_ms Milliseconds to wait, 0 to try once, TDS_QUEUE_WAIT_FOREVER to never give up.
+ * @return true If an element was dequeued.
+ * @return false On timeout, invalid arguments, or if the queue is not in TDS_QUEUE_MODE_MPMC.
+ */
+bool tds_queue_dequeue_wait(tds_queue_t instance, void* data, uint32_t timeout_ms);
+#endif
+
+/**
+ * @brief Reads the statistics counters of the queue.
+ *
+ * @param instance The queue instance.
+ * @param stats Pointer where the counters will be stored (zeroed when disabled).
+ * @return true If the library was built with TDS_ENABLE_STATS.
+ * @return false If statistics are disabled or an argument is NULL.
+ */
+bool tds_queue_get_stats(tds_queue_t instance, tds_stats_t* stats);
+
+#if TDS_SNAPSHOT
+/**
+ * @brief Saves the elements of the queue to a file (see tds_snapshot.h).
+ *
+ * The elements are written oldest first as one array, together with the
+ * mode, capacity and element size. No other thread may use the queue during
+ * the call. The queue is left unchanged; fd is neither synced nor closed.
+ *
+ * @param instance The queue instance.
+ * @param fd File descriptor opened for writing, positioned at the start of an empty file.
+ * @return true If the snapshot was written.
+ * @return false On invalid arguments or a write error.
+ */
+bool tds_queue_snapshot(tds_queue_t instance, int fd);
+
+/**
+ * @brief Creates a queue holding the elements saved by tds_queue_snapshot().
+ *
+ * The file is mapped and its elements copied in bulk (one or two memcpy in
+ * ring mode, one per cell in MPMC mode); only the linked mode allocates a
+ * node per element.
+ *
+ * @param path Path of the snapshot file.
+ * @param config Configuration of the new queue, or NULL for the saved mode with malloc/free.
+ * @return tds_queue_t A handle to the new queue, or NULL if the file is invalid or the elements do not fit.
+ */
+tds_queue_t tds_queue_load(const char* path, const tds_queue_config_t* config);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
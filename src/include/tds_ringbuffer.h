@@ -0,0 +1,377 @@
+/******************************************************************************
+ * File: tds_ringbuffer.h
+ * Author: Tiago Barbosa
+ * Description: Lock-free single-producer/single-consumer ring buffer for
+ *              embedded systems. One thread (or ISR) pushes and one thread
+ *              pops without locks and without allocating after creation.
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include <stdbool.h>  // For boolean type (true/false)
+#include <stddef.h>   // For size_t
+#include <stdint.h>   // For data types like uint8_t, int32_t, etc.
+
+#include "tds_config.h"
+#include "tds_memory.h"
+#include "tds_stats.h"
+
+/* Defines ------------------------------------------------------------------*/
+/**
+ * @brief Upper bound of the ring buffer instance size (checked when the library is built).
+ */
+#define TDS_RINGBUFFER_INSTANCE_SIZE (3 * TDS_CACHE_LINE_SIZE + 64 + TDS_STATS_SIZE)
+
+/**
+ * @brief Maximum number of consumers of a broadcast ring buffer.
+ */
+#define TDS_RINGBUFFER_MAX_CONSUMERS 32
+
+/**
+ * @brief Bytes of storage tds_ringbuffer_init_static() needs.
+ *
+ * capacity must be a power of two here, since it cannot be rounded up.
+ */
+#define TDS_RINGBUFFER_STORAGE_SIZE(capacity, element_size) \
+    (TDS_MEMORY_ROUND(TDS_RINGBUFFER_INSTANCE_SIZE) + (size_t) (capacity) * (size_t) (element_size))
+
+/* Typedefs -----------------------------------------------------------------*/
+/**
+ * @brief Opaque type for ring buffer instance.
+ *
+ * This type is used to handle the ring buffer instance without exposing its
+ * internals.
+ */
+typedef struct tds_ringbuffer_instance_t* tds_ringbuffer_t;
+
+/* Function Prototypes ------------------------------------------------------*/
+
+/**
+ * @brief Creates a new SPSC ring buffer.
+ *
+ * The capacity is rounded up to the next power of two so positions wrap with
+ * a mask. All storage is allocated here.
+ *
+ * @param capacity The minimum number of elements the ring buffer can hold (at most 2^30).
+ * @param element_size The size of each element in bytes.
+ * @return tds_ringbuffer_t A handle to the created ring buffer, or NULL on failure.
+ */
+tds_ringbuffer_t tds_ringbuffer_create(uint32_t capacity, size_t element_size);
+
+/**
+ * @brief Builds an SPSC ring buffer inside caller-provided storage.
+ *
+ * Instance and slots are carved from storage, so nothing is allocated and
+ * tds_ringbuffer_destroy() releases nothing.
+ *
+ * @param storage Memory aligned to max_align_t, valid until the ring buffer is destroyed.
+ * @param storage_size Size of storage, at least TDS_RINGBUFFER_STORAGE_SIZE(capacity, element_size).
+ * @param capacity The number of elements the ring buffer can hold, a power of two (at most 2^30).
+ * @param element_size The size of each element in bytes.
+ * @return tds_ringbuffer_t A handle to the ring buffer (pointing into storage), or NULL on failure.
+ */
+tds_ringbuffer_t tds_ringbuffer_init_static(void* storage, size_t storage_size, uint32_t capacity, size_t element_size);
+
+#if TDS_RINGBUFFER_MMAP
+/**
+ * @brief Creates an SPSC ring buffer stored in a file, mapped twice back to back.
+ *
+ * fd (a regular file, a memfd or a shm_open object, opened read/write) is
+ * resized to one page of header plus the slots, and its previous content is
+ * discarded. The slots are mapped a second time right after themselves, so
+ * bulk copies, reserve and peek_span never split at the end of the buffer:
+ * every span up to the number of free or stored elements is contiguous.
+ *
+ * Positions live in the file too, so another process can use the same ring
+ * buffer through tds_ringbuffer_attach() (one producer and one consumer in
+ * total), and a restarted process finds the unread elements where it left
+ * them. The capacity is rounded up to a power of two, and further until the
+ * slots fill whole pages. fd may be closed once this returns.
+ *
+ * @param fd File descriptor of the backing file.
+ * @param capacity The minimum number of elements the ring buffer can hold (at most 2^30).
+ * @param element_size The size of each element in bytes.
+ * @return tds_ringbuffer_t A handle to the mapped ring buffer, or NULL on failure.
+ */
+tds_ringbuffer_t tds_ringbuffer_create_mapped(int fd, uint32_t capacity, size_t element_size);
+
+/**
+ * @brief Maps a ring buffer built by tds_ringbuffer_create_mapped() on the same file.
+ *
+ * Nothing is reset: elements, positions and counters are taken as found, so
+ * the caller resumes the producer or consumer role it (or a crashed
+ * predecessor) had. A reservation left uncommitted by a crashed producer is
+ * simply dropped. The file must come from a build with the same
+ * TDS_ENABLE_STATS and TDS_CACHE_LINE_SIZE and the same page size.
+ *
+ * @param fd File descriptor of the backing file, opened read/write.
+ * @return tds_ringbuffer_t A handle to the mapped ring buffer, or NULL if the file does not hold a compatible one.
+ */
+tds_ringbuffer_t tds_ringbuffer_attach(int fd);
+#endif
+
+/**
+ * @brief Creates a broadcast ring buffer: one producer, every element read by
+ * each of consumers consumers.
+ *
+ * The data is written once and each consumer reads it in place through its
+ * own cursor (consumer index), on its own cache line, so consumers never
+ * write a shared line. A slot is reused once every consumer has released it:
+ * the producer only looks at the slowest cursor, and only when its cached
+ * view says the buffer is full.
+ *
+ * depends[i] is a bit mask of the consumers that must release an element
+ * before consumer i sees it, which chains processing stages over the same
+ * data (e.g. a journaling and a replication stage, then a business logic
+ * stage with depends = 0x3). A consumer may only depend on lower indices, so
+ * the stages form an acyclic graph; the producer waits only for the
+ * consumers nobody depends on.
+ *
+ * tds_ringbuffer_try_push(), the bulk and reserve/commit calls work as for an
+ * SPSC ring buffer; the consumer calls of the SPSC API act on consumer 0.
+ * tds_ringbuffer_size() counts the elements not released by the slowest
+ * consumer.
+ *
+ * @param capacity The minimum number of elements the ring buffer can hold (at most 2^30).
+ * @param element_size The size of each element in bytes.
+ * @param consumers Number of consumers (1 to TDS_RINGBUFFER_MAX_CONSUMERS).
+ * @param depends Array of consumers dependency masks, or NULL for independent consumers.
+ * @return tds_ringbuffer_t A handle to the created ring buffer, or NULL on failure.
+ */
+tds_ringbuffer_t tds_ringbuffer_create_broadcast(uint32_t capacity, size_t element_size, uint32_t consumers, const uint32_t* depends);
+
+/**
+ * @brief Pushes one element. Producer side only.
+ *
+ * @param instance The ring buffer instance.
+ * @param data Pointer to the element to copy in.
+ * @return true If the element was stored.
+ * @return false If the ring buffer is full.
+ */
+bool tds_ringbuffer_try_push(tds_ringbuffer_t instance, const void* data);
+
+/**
+ * @brief Pops one element. Consumer side only.
+ *
+ * @param instance The ring buffer instance.
+ * @param data Pointer where the element will be copied.
+ * @return true If an element was retrieved.
+ * @return false If the ring buffer is empty.
+ */
+bool tds_ringbuffer_try_pop(tds_ringbuffer_t instance, void* data);
+
+/**
+ * @brief Pushes up to count contiguous elements. Producer side only.
+ *
+ * The elements are copied with at most two memcpy calls and published with a
+ * single store.
+ *
+ * @param instance The ring buffer instance.
+ * @param data Pointer to an array of count elements.
+ * @param count Number of elements to push.
+ * @return uint32_t Number of elements actually pushed (0 if full).
+ */
+uint32_t tds_ringbuffer_push_bulk(tds_ringbuffer_t instance, const void* data, uint32_t count);
+
+/**
+ * @brief Pops up to count elements into a contiguous array. Consumer side only.
+ *
+ * @param instance The ring buffer instance.
+ * @param data Pointer to an array with room for count elements.
+ * @param count Maximum number of elements to pop.
+ * @return uint32_t Number of elements actually popped (0 if empty).
+ */
+uint32_t tds_ringbuffer_pop_bulk(tds_ringbuffer_t instance, void* data, uint32_t count);
+
+/**
+ * @brief Reserves contiguous free slots for in-place writing. Producer side only.
+ *
+ * The returned span does not wrap (unless the buffer is mapped twice, see
+ * tds_ringbuffer_create_mapped()), so fewer than count slots may be granted.
+ * Nothing is visible to the consumer until tds_ringbuffer_commit().
+ *
+ * @param instance The ring buffer instance.
+ * @param count Number of slots wanted.
+ * @param reserved Output: number of slots actually granted.
+ * @return void* Pointer to the first granted slot, or NULL if the ring buffer is full.
+ */
+void* tds_ringbuffer_reserve(tds_ringbuffer_t instance, uint32_t count, uint32_t* reserved);
+
+/**
+ * @brief Publishes the first count slots of the last reservation. Producer side only.
+ *
+ * @param instance The ring buffer instance.
+ * @param count Number of slots written, at most the number granted.
+ * @return true If the elements were published.
+ * @return false If count exceeds the pending reservation.
+ */
+bool tds_ringbuffer_commit(tds_ringbuffer_t instance, uint32_t count);
+
+/**
+ * @brief Exposes the oldest elements in place. Consumer side only.
+ *
+ * The span does not wrap (unless the buffer is mapped twice, see
+ * tds_ringbuffer_create_mapped()) and stays valid until tds_ringbuffer_consume().
+ *
+ * @param instance The ring buffer instance.
+ * @param count Output: number of contiguous elements readable at the returned pointer.
+ * @return const void* Pointer to the oldest element, or NULL if the ring buffer is empty.
+ */
+const void* tds_ringbuffer_peek_span(tds_ringbuffer_t instance, uint32_t* count);
+
+/**
+ * @brief Releases the count oldest elements after reading them in place. Consumer side only.
+ *
+ * @param instance The ring buffer instance.
+ * @param count Number of elements to drop.
+ * @return uint32_t Number of elements actually released.
+ */
+uint32_t tds_ringbuffer_consume(tds_ringbuffer_t instance, uint32_t count);
+
+/**
+ * @brief Copies the oldest element without removing it. Consumer side only.
+ *
+ * @param instance The ring buffer instance.
+ * @param data Pointer where the element will be copied.
+ * @return true If an element was retrieved.
+ * @return false If the ring buffer is empty.
+ */
+bool tds_ringbuffer_peek(tds_ringbuffer_t instance, void* data);
+
+/**
+ * @brief Pops one element for a consumer of a broadcast ring buffer. That consumer's thread only.
+ *
+ * @param instance The ring buffer instance.
+ * @param consumer Index of the consumer.
+ * @param data Pointer where the element will be copied.
+ * @return true If an element was retrieved.
+ * @return false If no element is visible to this consumer yet, or an argument is invalid.
+ */
+bool tds_ringbuffer_broadcast_pop(tds_ringbuffer_t instance, uint32_t consumer, void* data);
+
+/**
+ * @brief Exposes the elements visible to a consumer of a broadcast ring buffer, in place.
+ *
+ * Same contract as tds_ringbuffer_peek_span(): the elements stay valid and
+ * unmodified until the consumer releases them with
+ * tds_ringbuffer_broadcast_consume(). Other consumers may be reading the same
+ * slots concurrently, so they must not be written.
+ *
+ * @param instance The ring buffer instance.
+ * @param consumer Index of the consumer.
+ * @param count Where to store the number of contiguous elements.
+ * @return const void* First element, or NULL if none is visible or an argument is invalid.
+ */
+const void* tds_ringbuffer_broadcast_peek_span(tds_ringbuffer_t instance, uint32_t consumer, uint32_t* count);
+
+/**
+ * @brief Releases count elements of a consumer of a broadcast ring buffer.
+ *
+ * @param instance The ring buffer instance.
+ * @param consumer Index of the consumer.
+ * @param count Number of elements to release.
+ * @return uint32_t Number of elements released (at most the visible ones).
+ */
+uint32_t tds_ringbuffer_broadcast_consume(tds_ringbuffer_t instance, uint32_t consumer, uint32_t count);
+
+/**
+ * @brief Returns the number of stored elements.
+ *
+ * The value is a snapshot and may be stale when called concurrently.
+ *
+ * @param instance The ring buffer instance.
+ * @return int Number of elements, or -1 if the ring buffer is not initialized.
+ */
+int tds_ringbuffer_size(tds_ringbuffer_t instance);
+
+/**
+ * @brief Returns the capacity after power-of-two rounding.
+ *
+ * @param instance The ring buffer instance.
+ * @return int Capacity, or -1 if the ring buffer is not initialized.
+ */
+int tds_ringbuffer_capacity(tds_ringbuffer_t instance);
+
+/**
+ * @brief Checks if the ring buffer is empty.
+ *
+ * @param instance The ring buffer instance.
+ * @return true If empty or not initialized.
+ * @return false If it holds one or more elements.
+ */
+bool tds_ringbuffer_empty(tds_ringbuffer_t instance);
+
+/**
+ * @brief Checks if the ring buffer is full.
+ *
+ * @param instance The ring buffer instance.
+ * @return true If full or not initialized.
+ * @return false If at least one slot is free.
+ */
+bool tds_ringbuffer_full(tds_ringbuffer_t instance);
+
+/**
+ * @brief Reads the statistics counters of the ring buffer.
+ *
+ * @param instance The ring buffer instance.
+ * @param stats Pointer where the counters will be stored (zeroed when disabled).
+ * @return true If the library was built with TDS_ENABLE_STATS.
+ * @return false If statistics are disabled or an argument is NULL.
+ */
+bool tds_ringbuffer_get_stats(tds_ringbuffer_t instance, tds_stats_t* stats);
+
+#if TDS_SNAPSHOT
+/**
+ * @brief Saves the unreleased elements of the ring buffer to a file (see tds_snapshot.h).
+ *
+ * Writes the elements not yet released by the slowest consumer, oldest
+ * first, plus the dependencies and read position of every consumer. Neither
+ * side may use the ring buffer during the call. fd is neither synced nor
+ * closed. A ring buffer that must survive restarts without any copy can
+ * instead live in a file with tds_ringbuffer_create_mapped().
+ *
+ * @param instance The ring buffer instance.
+ * @param fd File descriptor opened for writing, positioned at the start of an empty file.
+ * @return true If the snapshot was written.
+ * @return false On invalid arguments or a write error.
+ */
+bool tds_ringbuffer_snapshot(tds_ringbuffer_t instance, int fd);
+
+/**
+ * @brief Creates a ring buffer holding the elements saved by tds_ringbuffer_snapshot().
+ *
+ * The file is mapped and the elements copied with one memcpy; every consumer
+ * resumes at its saved position. The result is an SPSC ring buffer, or a
+ * broadcast one with the saved consumers and dependencies.
+ *
+ * @param path Path of the snapshot file.
+ * @return tds_ringbuffer_t A handle to the new ring buffer, or NULL if the file is invalid.
+ */
+tds_ringbuffer_t tds_ringbuffer_load(const char* path);
+#endif
+
+/**
+ * @brief Destroys the ring buffer and frees its storage (if it owns any).
+ *
+ * Neither side may be using the ring buffer anymore. A mapped ring buffer is
+ * only unmapped from this process; the file and its content are kept.
+ *
+ * @param instance The ring buffer instance.
+ * @return true If the ring buffer was destroyed.
+ * @return false If the ring buffer was not initialized.
+ */
+bool tds_ringbuffer_destroy(tds_ringbuffer_t instance);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RINGBUFFER_H
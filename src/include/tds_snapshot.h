@@ -0,0 +1,90 @@
+/******************************************************************************
+ * File: tds_snapshot.h
+ * Author: Tiago Barbosa
+ * Description: Binary snapshot format shared by the containers that can be
+ *              saved to a file and loaded back (tds_queue_snapshot(),
+ *              tds_ringbuffer_snapshot(), tds_hashtable_snapshot() and the
+ *              matching tds_*_load()). The writer and loader they use are
+ *              private to the library (src/tds_snapshot_internal.h).
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include <stdbool.h>  // For boolean type (true/false)
+#include <stddef.h>   // For size_t
+#include <stdint.h>   // For data types like uint8_t, int32_t, etc.
+
+#include "tds_config.h"
+
+#if TDS_SNAPSHOT
+
+/* Defines ------------------------------------------------------------------*/
+#define TDS_SNAPSHOT_MAGIC      UINT32_C(0x53534454) /**< "TDSS" */
+#define TDS_SNAPSHOT_VERSION    1
+#define TDS_SNAPSHOT_BYTE_ORDER UINT32_C(0x01020304) /**< Read back differently by a host of the other byte order */
+
+/* Typedefs -----------------------------------------------------------------*/
+/**
+ * @brief Container stored in a snapshot file.
+ */
+typedef enum {
+    TDS_SNAPSHOT_QUEUE = 1,
+    TDS_SNAPSHOT_RINGBUFFER,
+    TDS_SNAPSHOT_HASHTABLE,
+} tds_snapshot_kind_t;
+
+/**
+ * @brief First 64 bytes of a snapshot file.
+ *
+ * The data follows at data_offset and holds no pointer: arrays of fixed-size
+ * elements in the host byte order, laid out so a loader copies each array
+ * with one memcpy (or uses it in place from a mapping). A file is only
+ * loaded by a build with the same version and byte order.
+ *
+ * Each kind owns its own fields; the fields of the other kinds and reserved
+ * are zero, and a file of another kind is rejected before any is read.
+ * Data of each kind:
+ * - queue: count elements, oldest first.
+ * - ring buffer: consumers pairs of uint32_t {depends, pending} where
+ *   pending is how many of the count elements that consumer has not read
+ *   yet, then the count elements from the oldest unreleased one.
+ * - hashtable: capacity control bytes, then capacity slots of slot_size
+ *   bytes; count entries and tombstones deleted slots. Slots that are not
+ *   full are zeroed. The hash function is not stored: the loader rehashes a
+ *   sample of the keys and rejects the file if their control bytes differ.
+ */
+typedef struct {
+    uint32_t magic;        /**< TDS_SNAPSHOT_MAGIC */
+    uint16_t version;      /**< TDS_SNAPSHOT_VERSION */
+    uint16_t kind;         /**< tds_snapshot_kind_t */
+    uint32_t byte_order;   /**< TDS_SNAPSHOT_BYTE_ORDER */
+    uint32_t element_size; /**< Element size (hashtable: value size) */
+    uint32_t capacity;     /**< Capacity (hashtable: slot count) */
+    uint32_t count;        /**< Number of elements stored */
+    uint32_t queue_mode;   /**< Queue: tds_queue_mode_t it was saved from */
+    uint32_t consumers;    /**< Ring buffer: number of consumers */
+    uint32_t key_size;     /**< Hashtable: key size */
+    uint32_t slot_size;    /**< Hashtable: bytes per slot (key, value and padding) */
+    uint32_t tombstones;   /**< Hashtable: deleted slots */
+    uint32_t reserved;     /**< Zero */
+    uint64_t data_offset;  /**< Bytes from the start of the file to the data */
+    uint64_t data_size;    /**< Bytes of data */
+} tds_snapshot_header_t;
+
+_Static_assert(sizeof(tds_snapshot_header_t) == 64, "snapshot header must stay 64 bytes");
+
+#endif  // TDS_SNAPSHOT
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SNAPSHOT_H
@@ -22,9 +22,46 @@ extern "C" {
 #include <stdlib.h>  // For malloc, free
 #include <string.h>  // For memcpy, memmove
 
+#include "tds_memory.h"
+#include "tds_stats.h"
+
 /* Defines ------------------------------------------------------------------*/
 // #define STACK_MAX_SIZE 100  // Maximum size of the stack (adjust as necessary)
 
+/**
+ * @brief Default configuration used by tds_stack_create().
+ */
+#define TDS_STACK_CONFIG_DEFAULT { .mode = TDS_STACK_MODE_LINKED, .allocator = NULL, .chunk = 0 }
+
+/**
+ * @brief Storage of a linked-mode stack built with tds_stack_init_static().
+ */
+#define TDS_STACK_INSTANCE_SIZE TDS_MEMORY_ROUND(sizeof(struct tds_stack_instance_t))
+
+/**
+ * @brief Bytes of storage tds_stack_init_static() needs in TDS_STACK_MODE_ARRAY.
+ */
+#define TDS_STACK_STORAGE_SIZE(capacity, element_size) \
+    (TDS_STACK_INSTANCE_SIZE + (size_t) (capacity) * (size_t) (element_size))
+
+/**
+ * @brief Upper bound of the lock-free state size (checked when the library is built).
+ */
+#define TDS_STACK_LOCKFREE_STATE_SIZE (2 * TDS_CACHE_LINE_SIZE + 64)
+
+/**
+ * @brief Bytes of one lock-free node: index header plus element, aligned to max_align_t.
+ */
+#define TDS_STACK_LOCKFREE_NODE_SIZE(element_size) \
+    ((2 * _Alignof(max_align_t) + (size_t) (element_size) - 1) & ~(size_t) (_Alignof(max_align_t) - 1))
+
+/**
+ * @brief Bytes of storage tds_stack_init_static() needs in TDS_STACK_MODE_LOCKFREE.
+ */
+#define TDS_STACK_LOCKFREE_STORAGE_SIZE(capacity, element_size) \
+    (TDS_STACK_INSTANCE_SIZE + TDS_MEMORY_ROUND(TDS_STACK_LOCKFREE_STATE_SIZE) + \
+     (size_t) (capacity) * TDS_STACK_LOCKFREE_NODE_SIZE(element_size))
+
 /* Typedefs -----------------------------------------------------------------*/
 /**
  * @brief Opaque type for stack instance.
@@ -33,6 +70,24 @@ extern "C" {
  */
 typedef struct tds_stack_instance_t* tds_stack_t;
 
+/**
+ * @brief Storage engine used by a stack instance.
+ */
+typedef enum {
+    TDS_STACK_MODE_LINKED = 0, /**< One node per element from the configured allocator */
+    TDS_STACK_MODE_ARRAY,      /**< Contiguous element array, allocated up front or grown by chunks */
+    TDS_STACK_MODE_LOCKFREE,   /**< Treiber stack over preallocated nodes, safe for concurrent push/pop */
+} tds_stack_mode_t;
+
+/**
+ * @brief Creation parameters for tds_stack_create_ex().
+ */
+typedef struct {
+    tds_stack_mode_t       mode;      /**< Storage engine for the stack elements */
+    const tds_allocator_t* allocator; /**< Allocator for linked nodes, NULL for malloc/free */
+    uint32_t               chunk;     /**< Array mode: growth step in elements, 0 to allocate the full capacity at creation */
+} tds_stack_config_t;
+
 /* Function Prototypes ------------------------------------------------------*/
 
 /**
@@ -42,20 +97,30 @@ typedef struct tds_stack_instance_t* tds_stack_t;
  * and the pointer to the top of the stack (which is a linked list node).
  */
 struct tds_stack_instance_t {
-    struct tds_stack_node_t* top;       /**< Points to the top node of the stack */
-    uint32_t                 capacity;  /**< Maximum capacity of the stack */
-    uint32_t                 elements;  /**< Size of a single element in bytes */
-    uint32_t                 size;      /**< Current number of elements in the stack */
+    tds_stack_mode_t             mode;
+    struct tds_stack_node_t*     top;       /**< Linked mode: points to the top node of the stack */
+    tds_allocator_t              allocator; /**< Linked mode: allocator used for the nodes */
+    uint8_t*                     buffer;    /**< Array mode: allocated * elements bytes, bottom element first */
+    uint32_t                     allocated; /**< Array mode: element slots currently allocated */
+    uint32_t                     chunk;     /**< Array mode: growth step in elements */
+    struct tds_stack_lockfree_t* lockfree;  /**< Lock-free mode state, NULL otherwise */
+    uint32_t                     capacity;  /**< Maximum capacity of the stack */
+    uint32_t                     elements;  /**< Size of a single element in bytes */
+    uint32_t                     size;      /**< Current number of elements in the stack (unused in lock-free mode) */
+    bool                         is_static; /**< Instance and storage live in caller memory (tds_stack_init_static) */
+
+    TDS_STATS_FIELD /**< Counters, present only with TDS_ENABLE_STATS */
 };
 
 /**
  * @brief Structure representing a node in the stack.
  * 
- * Each node contains a pointer to the stored data and a pointer to the next node.
+ * Each node contains a pointer to the next node followed by the stored data,
+ * so a push costs a single allocation.
  */
 struct tds_stack_node_t {
-    void*                    data;  /**< Stores the generic data */
-    struct tds_stack_node_t* next;  /**< Pointer to the next node in the stack */
+    struct tds_stack_node_t*      next;    /**< Pointer to the next node in the stack */
+    _Alignas(max_align_t) uint8_t data[];  /**< Stores the generic data inline */
 };
 
 /**
@@ -70,6 +135,55 @@ struct tds_stack_node_t {
  */
 tds_stack_t tds_stack_create(uint32_t capacity, size_t element_size);
 
+/**
+ * @brief Creates a new stack instance with an explicit configuration.
+ *
+ * In TDS_STACK_MODE_LINKED the configured allocator serves every node, so
+ * pairing it with a tds_pool_t of tds_stack_node_size() blocks keeps push/pop
+ * off the system heap. TDS_STACK_MODE_ARRAY stores the elements in one array,
+ * so push and pop reduce to a bounds check plus a memcpy; with config->chunk
+ * set, the array starts at chunk elements and is reallocated chunk elements
+ * larger whenever it fills up, never beyond capacity. TDS_STACK_MODE_LOCKFREE
+ * preallocates capacity nodes and links them through 32-bit indices; the top
+ * and free-list heads pair the index with a generation tag updated by every
+ * compare-and-swap, which rules out ABA. It is the only mode accepted by the
+ * *_threadsafe functions, and its other functions are safe to call
+ * concurrently too (tds_stack_destroy() excepted).
+ *
+ * @param capacity The maximum number of elements the stack can hold.
+ * @param element_size The size of each element in bytes.
+ * @param config Stack configuration, or NULL for TDS_STACK_CONFIG_DEFAULT.
+ * @return tds_stack_t A handle to the created stack instance, or NULL on failure.
+ */
+tds_stack_t tds_stack_create_ex(uint32_t capacity, size_t element_size, const tds_stack_config_t* config);
+
+/**
+ * @brief Builds a stack inside caller-provided storage, without touching the heap.
+ *
+ * The instance and, in array and lock-free modes, every element slot are
+ * carved from storage; config->chunk is ignored since the array cannot grow.
+ * A linked-mode stack must be given an allocator for its nodes (e.g. a static
+ * tds_pool_t or tds_arena_t). tds_stack_destroy() releases nothing but the
+ * remaining linked nodes.
+ *
+ * @param storage Memory aligned to max_align_t, valid until the stack is destroyed.
+ * @param storage_size Size of storage: TDS_STACK_STORAGE_SIZE(), TDS_STACK_LOCKFREE_STORAGE_SIZE()
+ *                     or TDS_STACK_INSTANCE_SIZE depending on the mode.
+ * @param capacity The maximum number of elements the stack can hold.
+ * @param element_size The size of each element in bytes.
+ * @param config Stack configuration, or NULL for TDS_STACK_MODE_ARRAY.
+ * @return tds_stack_t A handle to the stack (pointing into storage), or NULL on failure.
+ */
+tds_stack_t tds_stack_init_static(void* storage, size_t storage_size, uint32_t capacity, size_t element_size, const tds_stack_config_t* config);
+
+/**
+ * @brief Returns the size of one stack node holding an element.
+ *
+ * @param element_size The size of each element in bytes.
+ * @return size_t Bytes requested from the allocator per pushed element.
+ */
+size_t tds_stack_node_size(size_t element_size);
+
 /**
  * @brief Pushes a new element onto the stack.
  * 
@@ -118,6 +232,64 @@ bool tds_stack_peek(tds_stack_t instance, void* data);
  */
 bool tds_stack_pop(tds_stack_t instance, void* data);
 
+/**
+ * @brief Pushes up to count elements from a contiguous array.
+ *
+ * Elements are pushed in array order, so the last element ends on top.
+ * Argument and capacity checks run once per call.
+ *
+ * @param instance The stack instance.
+ * @param data Pointer to an array of count elements.
+ * @param count Number of elements to push.
+ * @return uint32_t Number of elements pushed, stopping early when the stack is full.
+ */
+uint32_t tds_stack_push_n(tds_stack_t instance, const void* data, uint32_t count);
+
+/**
+ * @brief Pops up to count elements into a contiguous array.
+ *
+ * The popped elements are written in the order they were pushed (the former
+ * top element is last), so tds_stack_pop_n() exactly undoes tds_stack_push_n().
+ *
+ * @param instance The stack instance.
+ * @param data Pointer to an array with room for count elements.
+ * @param count Maximum number of elements to pop.
+ * @return uint32_t Number of elements popped, stopping early when the stack is empty.
+ */
+uint32_t tds_stack_pop_n(tds_stack_t instance, void* data, uint32_t count);
+
+/**
+ * @brief Pushes an element from any thread (lock-free mode only).
+ *
+ * @param instance The stack instance, created with TDS_STACK_MODE_LOCKFREE.
+ * @param data Pointer to the data to be pushed onto the stack.
+ * @return true If the element was pushed.
+ * @return false If the stack is full, or not in lock-free mode.
+ */
+bool tds_stack_push_threadsafe(tds_stack_t instance, const void* data);
+
+/**
+ * @brief Pops the top element from any thread (lock-free mode only).
+ *
+ * @param instance The stack instance, created with TDS_STACK_MODE_LOCKFREE.
+ * @param data Pointer where the popped element's data will be stored.
+ * @return true If an element was popped.
+ * @return false If the stack is empty, or not in lock-free mode.
+ */
+bool tds_stack_pop_threadsafe(tds_stack_t instance, void* data);
+
+/**
+ * @brief Reads the statistics counters of the stack.
+ *
+ * The lock-free mode keeps no element count, so its high_water stays 0.
+ *
+ * @param instance The stack instance.
+ * @param stats Pointer where the counters will be stored (zeroed when disabled).
+ * @return true If the library was built with TDS_ENABLE_STATS.
+ * @return false If statistics are disabled or an argument is NULL.
+ */
+bool tds_stack_get_stats(tds_stack_t instance, tds_stats_t* stats);
+
 /**
  * @brief Destroys the stack and frees all allocated memory.
  * 
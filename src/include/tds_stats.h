@@ -0,0 +1,117 @@
+/******************************************************************************
+ * File: tds_stats.h
+ * Author: Tiago Barbosa
+ * Description: Per-instance statistics of the TDS containers.
+ *              Counters exist only when the library is built with
+ *              TDS_ENABLE_STATS (see tds_config.h); otherwise every hook
+ *              below expands to nothing and the instances carry no extra
+ *              fields.
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef STATS_H
+#define STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include <stdbool.h>  // For boolean type (true/false)
+#include <stdint.h>   // For data types like uint8_t, int32_t, etc.
+#include <string.h>   // For memset
+
+#include "tds_config.h"
+
+/* Typedefs -----------------------------------------------------------------*/
+/**
+ * @brief Snapshot of the counters of one instance, filled by tds_*_get_stats().
+ *
+ * Counters are read one by one with relaxed loads, so a snapshot taken while
+ * other threads operate is not atomic as a whole.
+ */
+typedef struct {
+    uint64_t operations;      /**< Successful inserts, removals and lookups */
+    uint64_t failed_full;     /**< Inserts rejected because the instance was full */
+    uint64_t failed_empty;    /**< Removals/peeks/lookups that found nothing */
+    uint64_t allocations;     /**< Calls to the allocator (nodes, storage, tables) */
+    uint64_t allocated_bytes; /**< Bytes requested by those calls */
+    uint64_t high_water;      /**< Largest number of elements held at once */
+    uint64_t retries;         /**< CAS retries, lock spins and read retries of the concurrent variants */
+} tds_stats_t;
+
+/* Library-internal hooks -----------------------------------------------------*/
+/*
+ * Containers embed TDS_STATS_FIELD in their instance and update it through
+ * the macros below; with TDS_ENABLE_STATS off the arguments are not even
+ * evaluated.
+ */
+#if TDS_ENABLE_STATS
+
+#include <stdatomic.h>  // For the relaxed counters
+
+typedef struct {
+    _Atomic uint64_t operations;
+    _Atomic uint64_t failed_full;
+    _Atomic uint64_t failed_empty;
+    _Atomic uint64_t allocations;
+    _Atomic uint64_t allocated_bytes;
+    _Atomic uint64_t high_water;
+    _Atomic uint64_t retries;
+} tds_stats_counters_t;
+
+static inline void tds_stats_counters_init(tds_stats_counters_t* c) {
+    atomic_init(&c->operations, 0);
+    atomic_init(&c->failed_full, 0);
+    atomic_init(&c->failed_empty, 0);
+    atomic_init(&c->allocations, 0);
+    atomic_init(&c->allocated_bytes, 0);
+    atomic_init(&c->high_water, 0);
+    atomic_init(&c->retries, 0);
+}
+
+static inline void tds_stats_counters_max(_Atomic uint64_t* counter, uint64_t value) {
+    uint64_t seen = atomic_load_explicit(counter, memory_order_relaxed);
+    while (value > seen && !atomic_compare_exchange_weak_explicit(counter, &seen, value, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static inline bool tds_stats_counters_read(tds_stats_counters_t* c, tds_stats_t* out) {
+    out->operations      = atomic_load_explicit(&c->operations, memory_order_relaxed);
+    out->failed_full     = atomic_load_explicit(&c->failed_full, memory_order_relaxed);
+    out->failed_empty    = atomic_load_explicit(&c->failed_empty, memory_order_relaxed);
+    out->allocations     = atomic_load_explicit(&c->allocations, memory_order_relaxed);
+    out->allocated_bytes = atomic_load_explicit(&c->allocated_bytes, memory_order_relaxed);
+    out->high_water      = atomic_load_explicit(&c->high_water, memory_order_relaxed);
+    out->retries         = atomic_load_explicit(&c->retries, memory_order_relaxed);
+    return true;
+}
+
+_Static_assert(sizeof(tds_stats_counters_t) <= 64, "TDS_STATS_SIZE too small");
+
+#define TDS_STATS_SIZE              64 /**< Upper bound of TDS_STATS_FIELD, used by the storage size macros */
+#define TDS_STATS_FIELD             tds_stats_counters_t stats;
+#define TDS_STATS_INIT(inst)        tds_stats_counters_init(&(inst)->stats)
+#define TDS_STATS_ADD(inst, f, n)   atomic_fetch_add_explicit(&(inst)->stats.f, (uint64_t) (n), memory_order_relaxed)
+#define TDS_STATS_MAX(inst, f, v)   tds_stats_counters_max(&(inst)->stats.f, (uint64_t) (v))
+#define TDS_STATS_ALLOC(inst, size) (TDS_STATS_ADD(inst, allocations, 1), TDS_STATS_ADD(inst, allocated_bytes, size))
+#define TDS_STATS_READ(inst, out)   tds_stats_counters_read(&(inst)->stats, (out))
+
+#else
+
+#define TDS_STATS_SIZE              0
+#define TDS_STATS_FIELD
+#define TDS_STATS_INIT(inst)        ((void) 0)
+#define TDS_STATS_ADD(inst, f, n)   ((void) 0)
+#define TDS_STATS_MAX(inst, f, v)   ((void) 0)
+#define TDS_STATS_ALLOC(inst, size) ((void) 0)
+#define TDS_STATS_READ(inst, out)   (memset((out), 0, sizeof(tds_stats_t)), false)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // STATS_H
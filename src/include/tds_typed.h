@@ -0,0 +1,434 @@
+/******************************************************************************
+ * File: tds_typed.h
+ * Author: Tiago Barbosa
+ * Description: Header-only generators of typed containers.
+ *              Each TDS_DEFINE_* macro emits a struct and static inline
+ *              functions specialized for one element type, so copies are
+ *              plain assignments the compiler can inline and vectorize.
+ *              The void* containers (tds_queue.h, tds_stack.h,
+ *              tds_hashtable.h) remain the generic, ABI-stable API.
+ *              Memory comes from TDS_MALLOC/TDS_FREE; with TDS_NO_MALLOC
+ *              the _create functions return NULL and _init builds the
+ *              container in caller storage.
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef TYPED_H
+#define TYPED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include <stdbool.h>  // For boolean type (true/false)
+#include <stdint.h>   // For data types like uint8_t, int32_t, etc.
+#include <string.h>   // For memset
+
+#include "tds_config.h"
+
+/* Defines ------------------------------------------------------------------*/
+
+/**
+ * @brief Rounds ptr up to a multiple of align (a power of two).
+ *
+ * TDS_MALLOC only guarantees max_align_t, so element arrays of over-aligned types
+ * get align - 1 bytes of slack and start at the first boundary inside it.
+ */
+#define TDS_TYPED_ALIGN_UP(ptr, align) ((void*) (((uintptr_t) (ptr) + (align) - 1) & ~(uintptr_t) ((align) - 1)))
+
+/**
+ * @brief Generates a typed bounded FIFO queue named name##_t holding T.
+ *
+ * Generated API (all static inline):
+ *   bool     name_init(name_t* self, T* storage, uint32_t capacity);
+ *   name_t*  name_create(uint32_t capacity);
+ *   void     name_destroy(name_t* self);
+ *   bool     name_enqueue(name_t* self, T value);
+ *   bool     name_dequeue(name_t* self, T* out);
+ *   bool     name_peek(const name_t* self, T* out);
+ *   uint32_t name_size(const name_t* self);
+ *   bool     name_empty(const name_t* self);
+ *   bool     name_full(const name_t* self);
+ */
+#define TDS_DEFINE_QUEUE(name, T)                                                                  \
+    typedef struct {                                                                               \
+        T*       items;                                                                            \
+        uint32_t capacity;                                                                         \
+        uint32_t read;                                                                             \
+        uint32_t size;                                                                             \
+    } name##_t;                                                                                    \
+                                                                                                   \
+    static inline bool name##_init(name##_t* self, T* storage, uint32_t capacity) {                \
+        if (!self || !storage || capacity == 0) {                                                  \
+            return false;                                                                          \
+        }                                                                                          \
+        self->items    = storage;                                                                  \
+        self->capacity = capacity;                                                                 \
+        self->read     = 0;                                                                        \
+        self->size     = 0;                                                                        \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline name##_t* name##_create(uint32_t capacity) {                                     \
+        size_t header = sizeof(name##_t) + _Alignof(T) - 1;                                        \
+        if (capacity == 0 || sizeof(T) > (SIZE_MAX - header) / capacity) {                         \
+            return NULL;                                                                           \
+        }                                                                                          \
+        name##_t* self = (name##_t*) TDS_MALLOC(header + (size_t) capacity * sizeof(T));           \
+        if (self) {                                                                                \
+            name##_init(self, (T*) TDS_TYPED_ALIGN_UP(self + 1, _Alignof(T)), capacity);           \
+        }                                                                                          \
+        return self;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline void name##_destroy(name##_t* self) {                                            \
+        TDS_FREE(self);                                                                            \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_enqueue(name##_t* self, T value) {                                   \
+        if (self->size == self->capacity) {                                                        \
+            return false;                                                                          \
+        }                                                                                          \
+        uint32_t slot = self->read + self->size;                                                   \
+        if (slot >= self->capacity) {                                                              \
+            slot -= self->capacity;                                                                \
+        }                                                                                          \
+        self->items[slot] = value;                                                                 \
+        self->size++;                                                                              \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_dequeue(name##_t* self, T* out) {                                    \
+        if (self->size == 0) {                                                                     \
+            return false;                                                                          \
+        }                                                                                          \
+        *out = self->items[self->read];                                                            \
+        if (++self->read == self->capacity) {                                                      \
+            self->read = 0;                                                                        \
+        }                                                                                          \
+        self->size--;                                                                              \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_peek(const name##_t* self, T* out) {                                 \
+        if (self->size == 0) {                                                                     \
+            return false;                                                                          \
+        }                                                                                          \
+        *out = self->items[self->read];                                                            \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline uint32_t name##_size(const name##_t* self) {                                     \
+        return self->size;                                                                         \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_empty(const name##_t* self) {                                        \
+        return self->size == 0;                                                                    \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_full(const name##_t* self) {                                         \
+        return self->size == self->capacity;                                                       \
+    }
+
+/**
+ * @brief Generates a typed bounded LIFO stack named name##_t holding T.
+ *
+ * Generated API (all static inline):
+ *   bool     name_init(name_t* self, T* storage, uint32_t capacity);
+ *   name_t*  name_create(uint32_t capacity);
+ *   void     name_destroy(name_t* self);
+ *   bool     name_push(name_t* self, T value);
+ *   bool     name_pop(name_t* self, T* out);
+ *   bool     name_peek(const name_t* self, T* out);
+ *   uint32_t name_size(const name_t* self);
+ *   bool     name_empty(const name_t* self);
+ *   bool     name_full(const name_t* self);
+ */
+#define TDS_DEFINE_STACK(name, T)                                                                  \
+    typedef struct {                                                                               \
+        T*       items;                                                                            \
+        uint32_t capacity;                                                                         \
+        uint32_t size;                                                                             \
+    } name##_t;                                                                                    \
+                                                                                                   \
+    static inline bool name##_init(name##_t* self, T* storage, uint32_t capacity) {                \
+        if (!self || !storage || capacity == 0) {                                                  \
+            return false;                                                                          \
+        }                                                                                          \
+        self->items    = storage;                                                                  \
+        self->capacity = capacity;                                                                 \
+        self->size     = 0;                                                                        \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline name##_t* name##_create(uint32_t capacity) {                                     \
+        size_t header = sizeof(name##_t) + _Alignof(T) - 1;                                        \
+        if (capacity == 0 || sizeof(T) > (SIZE_MAX - header) / capacity) {                         \
+            return NULL;                                                                           \
+        }                                                                                          \
+        name##_t* self = (name##_t*) TDS_MALLOC(header + (size_t) capacity * sizeof(T));           \
+        if (self) {                                                                                \
+            name##_init(self, (T*) TDS_TYPED_ALIGN_UP(self + 1, _Alignof(T)), capacity);           \
+        }                                                                                          \
+        return self;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline void name##_destroy(name##_t* self) {                                            \
+        TDS_FREE(self);                                                                            \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_push(name##_t* self, T value) {                                      \
+        if (self->size == self->capacity) {                                                        \
+            return false;                                                                          \
+        }                                                                                          \
+        self->items[self->size++] = value;                                                         \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_pop(name##_t* self, T* out) {                                        \
+        if (self->size == 0) {                                                                     \
+            return false;                                                                          \
+        }                                                                                          \
+        *out = self->items[--self->size];                                                          \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_peek(const name##_t* self, T* out) {                                 \
+        if (self->size == 0) {                                                                     \
+            return false;                                                                          \
+        }                                                                                          \
+        *out = self->items[self->size - 1];                                                        \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline uint32_t name##_size(const name##_t* self) {                                     \
+        return self->size;                                                                         \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_empty(const name##_t* self) {                                        \
+        return self->size == 0;                                                                    \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_full(const name##_t* self) {                                         \
+        return self->size == self->capacity;                                                       \
+    }
+
+/**
+ * @brief Generates a typed open-addressing hashtable named name##_t mapping K to V.
+ *
+ * hash is called as uint64_t hash(K key) and eq as bool eq(K a, K b); both
+ * may be macros or static inline functions so they inline into the probe.
+ * Slots are probed linearly with one control byte each (same encoding as
+ * tds_hashtable: low 7 hash bits when full, 0x80 empty, 0xFE deleted). When
+ * full plus deleted slots exceed 7/8, the table doubles if at least 7/16 of
+ * it is full and drops its tombstones in place otherwise. name_init() builds
+ * the table in caller storage (count slots, a power of two, and count
+ * control bytes); it never grows, so put fails once the live entries reach
+ * 7/8 of the slots, and it is not passed to name_destroy().
+ *
+ * Generated API (all static inline):
+ *   bool     name_init(name_t* self, name_slot_t* slots, uint8_t* ctrl, uint32_t count);
+ *   name_t*  name_create(uint32_t capacity);
+ *   void     name_destroy(name_t* self);
+ *   bool     name_put(name_t* self, K key, V value);
+ *   bool     name_get(const name_t* self, K key, V* out);
+ *   bool     name_remove(name_t* self, K key);
+ *   uint32_t name_size(const name_t* self);
+ */
+#define TDS_DEFINE_HASHTABLE(name, K, V, hash, eq)                                                 \
+    typedef struct {                                                                               \
+        K key;                                                                                     \
+        V value;                                                                                   \
+    } name##_slot_t;                                                                               \
+                                                                                                   \
+    typedef struct {                                                                               \
+        void*          block; /* Allocation holding slots and ctrl, NULL for caller storage */     \
+        uint8_t*       ctrl;                                                                       \
+        name##_slot_t* slots;                                                                      \
+        uint32_t       mask;                                                                       \
+        uint32_t       used;                                                                       \
+        uint32_t       deleted;                                                                    \
+    } name##_t;                                                                                    \
+                                                                                                   \
+    static inline bool name##_init(name##_t* self, name##_slot_t* slots, uint8_t* ctrl, uint32_t count) {\
+        if (!self || !slots || !ctrl || count < 2 || (count & (count - 1))) {                      \
+            return false;                                                                          \
+        }                                                                                          \
+        self->block   = NULL;                                                                      \
+        self->slots   = slots;                                                                     \
+        self->ctrl    = ctrl;                                                                      \
+        self->mask    = count - 1;                                                                 \
+        self->used    = 0;                                                                         \
+        self->deleted = 0;                                                                         \
+        memset(ctrl, 0x80, count);                                                                 \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_alloc_slots(name##_t* self, uint32_t slots) {                        \
+        size_t align = _Alignof(name##_slot_t);                                                    \
+        if ((size_t) slots > (SIZE_MAX - slots - align) / sizeof(name##_slot_t)) {                 \
+            return false;                                                                          \
+        }                                                                                          \
+        void* block = TDS_MALLOC((size_t) slots * sizeof(name##_slot_t) + slots + align - 1);      \
+        if (!block) {                                                                              \
+            return false;                                                                          \
+        }                                                                                          \
+        name##_slot_t* storage = (name##_slot_t*) TDS_TYPED_ALIGN_UP(block, align);                \
+        name##_init(self, storage, (uint8_t*) (storage + slots), slots);                           \
+        self->block = block;                                                                       \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline name##_t* name##_create(uint32_t capacity) {                                     \
+        uint32_t slots = 16;                                                                       \
+        while (slots < (UINT32_C(1) << 30) && (uint64_t) slots * 7 < (uint64_t) capacity * 8 + 8) {\
+            slots <<= 1;                                                                           \
+        }                                                                                          \
+        name##_t* self = (name##_t*) TDS_MALLOC(sizeof(name##_t));                                 \
+        if (self && !name##_alloc_slots(self, slots)) {                                            \
+            TDS_FREE(self);                                                                        \
+            self = NULL;                                                                           \
+        }                                                                                          \
+        return self;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline void name##_destroy(name##_t* self) {                                            \
+        if (self) {                                                                                \
+            TDS_FREE(self->block);                                                                 \
+            TDS_FREE(self);                                                                        \
+        }                                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    static inline uint32_t name##_find(const name##_t* self, K key, uint64_t hv) {                 \
+        uint8_t  tag = (uint8_t) (hv & 0x7F);                                                      \
+        uint32_t i   = (uint32_t) (hv >> 7) & self->mask;                                          \
+        for (uint32_t n = 0; n <= self->mask; n++, i = (i + 1) & self->mask) {                     \
+            uint8_t c = self->ctrl[i];                                                             \
+            if (c == tag && eq(self->slots[i].key, key)) {                                         \
+                return i;                                                                          \
+            }                                                                                      \
+            if (c == 0x80) {                                                                       \
+                break;                                                                             \
+            }                                                                                      \
+        }                                                                                          \
+        return UINT32_MAX;                                                                         \
+    }                                                                                              \
+                                                                                                   \
+    static inline uint32_t name##_find_free(const name##_t* self, uint64_t hv) {                   \
+        uint32_t i = (uint32_t) (hv >> 7) & self->mask;                                            \
+        while (!(self->ctrl[i] & 0x80)) {                                                          \
+            i = (i + 1) & self->mask;                                                              \
+        }                                                                                          \
+        return i;                                                                                  \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_rehash(name##_t* self, uint32_t slots) {                             \
+        name##_t fresh;                                                                            \
+        if (!name##_alloc_slots(&fresh, slots)) {                                                  \
+            return false;                                                                          \
+        }                                                                                          \
+        for (uint32_t i = 0; i <= self->mask; i++) {                                               \
+            if (!(self->ctrl[i] & 0x80)) {                                                         \
+                uint32_t j     = name##_find_free(&fresh, hash(self->slots[i].key));               \
+                fresh.ctrl[j]  = self->ctrl[i];                                                    \
+                fresh.slots[j] = self->slots[i];                                                   \
+                fresh.used++;                                                                      \
+            }                                                                                      \
+        }                                                                                          \
+        TDS_FREE(self->block);                                                                     \
+        *self = fresh;                                                                             \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    /* Re-places every entry from a slot that was empty, so no probe path wraps past the scan */  \
+    static inline void name##_purge(name##_t* self) {                                              \
+        uint32_t start = 0;                                                                        \
+        while (self->ctrl[start] != 0x80) {                                                        \
+            start++;                                                                               \
+        }                                                                                          \
+        for (uint32_t i = 0; i <= self->mask; i++) {                                               \
+            if (self->ctrl[i] == 0xFE) {                                                           \
+                self->ctrl[i] = 0x80;                                                              \
+            }                                                                                      \
+        }                                                                                          \
+        for (uint32_t n = 1; n <= self->mask; n++) {                                               \
+            uint32_t i = (start + n) & self->mask;                                                 \
+            if (self->ctrl[i] & 0x80) {                                                            \
+                continue;                                                                          \
+            }                                                                                      \
+            uint8_t       tag  = self->ctrl[i];                                                    \
+            name##_slot_t item = self->slots[i];                                                   \
+            self->ctrl[i]      = 0x80;                                                             \
+            uint32_t j         = name##_find_free(self, hash(item.key));                           \
+            self->ctrl[j]      = tag;                                                              \
+            self->slots[j]     = item;                                                             \
+        }                                                                                          \
+        self->deleted = 0;                                                                         \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_put(name##_t* self, K key, V value) {                                \
+        uint64_t hv = hash(key);                                                                   \
+        uint32_t i  = name##_find(self, key, hv);                                                  \
+        if (i != UINT32_MAX) {                                                                     \
+            self->slots[i].value = value;                                                          \
+            return true;                                                                           \
+        }                                                                                          \
+        uint64_t slots = (uint64_t) self->mask + 1;                                                \
+        if ((uint64_t) (self->used + self->deleted + 1) * 8 > slots * 7) {                         \
+            bool grow = (uint64_t) self->used * 16 >= slots * 7;                                   \
+            if (!grow || !self->block || slots >= (UINT32_C(1) << 30) ||                           \
+                !name##_rehash(self, (uint32_t) slots << 1)) {                                     \
+                if (self->deleted) {                                                               \
+                    name##_purge(self);                                                            \
+                }                                                                                  \
+                if ((uint64_t) (self->used + 1) * 8 > slots * 7) {                                 \
+                    return false;                                                                  \
+                }                                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+        i = name##_find_free(self, hv);                                                            \
+        if (self->ctrl[i] == 0xFE) {                                                               \
+            self->deleted--;                                                                       \
+        }                                                                                          \
+        self->ctrl[i]        = (uint8_t) (hv & 0x7F);                                              \
+        self->slots[i].key   = key;                                                                \
+        self->slots[i].value = value;                                                              \
+        self->used++;                                                                              \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_get(const name##_t* self, K key, V* out) {                           \
+        uint32_t i = name##_find(self, key, hash(key));                                            \
+        if (i == UINT32_MAX) {                                                                     \
+            return false;                                                                          \
+        }                                                                                          \
+        *out = self->slots[i].value;                                                               \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_remove(name##_t* self, K key) {                                      \
+        uint32_t i = name##_find(self, key, hash(key));                                            \
+        if (i == UINT32_MAX) {                                                                     \
+            return false;                                                                          \
+        }                                                                                          \
+        if (self->ctrl[(i + 1) & self->mask] == 0x80) {                                            \
+            self->ctrl[i] = 0x80;                                                                  \
+        } else {                                                                                   \
+            self->ctrl[i] = 0xFE;                                                                  \
+            self->deleted++;                                                                       \
+        }                                                                                          \
+        self->used--;                                                                              \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline uint32_t name##_size(const name##_t* self) {                                     \
+        return self->used;                                                                         \
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TYPED_H
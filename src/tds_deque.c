@@ -0,0 +1,286 @@
+/******************************************************************************
+ * File: tds_deque.c
+ * Author: Tiago Barbosa
+ * Description: Lock-free work-stealing deque (Chase-Lev). The owner thread
+ *              pushes and pops at the bottom without locks, any other thread
+ *              steals from the top with a single CAS. The circular array
+ *              grows without blocking the thieves.
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef DEQUE_C
+#define DEQUE_C
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include "tds_deque.h"
+
+#include <stdatomic.h>  // For top, bottom and the array pointer
+#include <string.h>     // For memcpy
+
+#include "tds_config.h"
+#include "tds_memory.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define TDS_DEQUE_MAX_CAPACITY (UINT32_C(1) << 30)
+
+/* Typedefs -----------------------------------------------------------------*/
+
+/**
+ * @brief One circular array of slots. Arrays replaced by a growth are kept
+ * on the retired chain until the deque is destroyed.
+ */
+struct tds_deque_array_t {
+    struct tds_deque_array_t* retired; /**< Previous (smaller) array, NULL for the first */
+    uint8_t*                  slots;   /**< (mask + 1) * elements bytes, right after this header */
+    uint32_t                  mask;    /**< Number of slots - 1, power of two */
+};
+
+/**
+ * @brief Structure representing a deque instance.
+ *
+ * top and bottom are free-running positions compared through their signed
+ * difference; the slot is position & mask. The thieves only write top and
+ * the owner only writes bottom (and array on growth), each on its own line.
+ * The protocol follows Le, Pop, Cohen and Zappa Nardelli, "Correct and
+ * Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ */
+struct tds_deque_instance_t {
+    /* Read-mostly: written by the owner on growth only */
+    _Atomic(struct tds_deque_array_t*) array;    /**< Current array */
+    uint32_t                           elements; /**< Size of a single element in bytes */
+    uint8_t                            pad0[TDS_CACHE_LINE_SIZE];
+
+    /* Thieves cache line */
+    _Atomic uint32_t top; /**< Oldest position, advanced by steals */
+    uint8_t          pad1[TDS_CACHE_LINE_SIZE - sizeof(uint32_t)];
+
+    /* Owner cache line */
+    _Atomic uint32_t bottom; /**< Next position to push */
+    uint8_t          pad2[TDS_CACHE_LINE_SIZE - sizeof(uint32_t)];
+
+    TDS_STATS_FIELD
+};
+
+/* Private Functions --------------------------------------------------------*/
+
+static inline uint8_t* tds_deque_slot(tds_deque_t deque, struct tds_deque_array_t* a, uint32_t pos) {
+    return a->slots + (size_t) (pos & a->mask) * deque->elements;
+}
+
+static struct tds_deque_array_t* tds_deque_array_new(tds_deque_t deque, uint32_t slots) {
+    size_t header = TDS_MEMORY_ROUND(sizeof(struct tds_deque_array_t));
+    if (deque->elements > (SIZE_MAX - header) / slots) {
+        //printf("[ERROR] Deque array size overflows size_t.\n");
+        return NULL;
+    }
+
+    struct tds_deque_array_t* a = (struct tds_deque_array_t*) TDS_MALLOC(header + (size_t) slots * deque->elements);
+    if (!a) {
+        //printf("[ERROR] Failed to allocate memory for the deque array.\n");
+        return NULL;
+    }
+
+    a->retired = NULL;
+    a->slots   = (uint8_t*) a + header;
+    a->mask    = slots - 1;
+    TDS_STATS_ALLOC(deque, header + (size_t) slots * deque->elements);
+    return a;
+}
+
+/**
+ * @brief Owner side: copies the live positions [top, bottom) into an array
+ * twice as large and publishes it. Thieves keep reading the old array, whose
+ * live slots are never written again, until they load the new pointer.
+ */
+static struct tds_deque_array_t* tds_deque_grow(tds_deque_t deque, struct tds_deque_array_t* old, uint32_t top, uint32_t bottom) {
+    if (old->mask + 1 >= TDS_DEQUE_MAX_CAPACITY) {
+        //printf("[ERROR] Deque reached its maximum capacity.\n");
+        return NULL;
+    }
+
+    struct tds_deque_array_t* a = tds_deque_array_new(deque, 2 * (old->mask + 1));
+    if (!a) {
+        return NULL;
+    }
+
+    for (uint32_t pos = top; pos != bottom; pos++) {
+        memcpy(tds_deque_slot(deque, a, pos), tds_deque_slot(deque, old, pos), deque->elements);
+    }
+    a->retired = old;
+    atomic_store_explicit(&deque->array, a, memory_order_release);
+    return a;
+}
+
+/* Public Functions ---------------------------------------------------------*/
+
+tds_deque_t tds_deque_create(uint32_t capacity, size_t element_size) {
+    if (capacity == 0 || capacity > TDS_DEQUE_MAX_CAPACITY || element_size == 0 || element_size > UINT32_MAX) {
+        //printf("[ERROR] Invalid deque parameters!\n");
+        return NULL;
+    }
+
+    uint32_t slots = 1;
+    while (slots < capacity) {
+        slots <<= 1;
+    }
+
+    tds_deque_t deque = (tds_deque_t) TDS_MALLOC(sizeof(struct tds_deque_instance_t));
+    if (!deque) {
+        //printf("[ERROR] Failed to allocate memory for the deque.\n");
+        return NULL;
+    }
+
+    TDS_STATS_INIT(deque);
+    deque->elements = (uint32_t) element_size;
+
+    struct tds_deque_array_t* a = tds_deque_array_new(deque, slots);
+    if (!a) {
+        TDS_FREE(deque);
+        return NULL;
+    }
+
+    atomic_init(&deque->array, a);
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    return deque;
+}
+
+bool tds_deque_push(tds_deque_t instance, const void* data) {
+    if (!instance || !data) {
+        return false;
+    }
+
+    uint32_t                  bottom = atomic_load_explicit(&instance->bottom, memory_order_relaxed);
+    uint32_t                  top    = atomic_load_explicit(&instance->top, memory_order_acquire);
+    struct tds_deque_array_t* a      = atomic_load_explicit(&instance->array, memory_order_relaxed);
+
+    if ((int32_t) (bottom - top) > (int32_t) a->mask) {
+        a = tds_deque_grow(instance, a, top, bottom);
+        if (!a) {
+            TDS_STATS_ADD(instance, failed_full, 1);
+            return false;
+        }
+    }
+
+    memcpy(tds_deque_slot(instance, a, bottom), data, instance->elements);
+    atomic_store_explicit(&instance->bottom, bottom + 1, memory_order_release);
+    TDS_STATS_ADD(instance, operations, 1);
+    TDS_STATS_MAX(instance, high_water, bottom + 1 - top);
+    return true;
+}
+
+bool tds_deque_pop(tds_deque_t instance, void* data) {
+    if (!instance || !data) {
+        return false;
+    }
+
+    uint32_t                  bottom = atomic_load_explicit(&instance->bottom, memory_order_relaxed) - 1;
+    struct tds_deque_array_t* a      = atomic_load_explicit(&instance->array, memory_order_relaxed);
+
+    // Claim the bottom slot first, then look at top: a thief either sees the
+    // claim or the owner sees its steal (both sides are seq_cst)
+    atomic_store_explicit(&instance->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    uint32_t top  = atomic_load_explicit(&instance->top, memory_order_relaxed);
+    int32_t  left = (int32_t) (bottom - top);
+
+    if (left > 0) {
+        memcpy(data, tds_deque_slot(instance, a, bottom), instance->elements);
+        TDS_STATS_ADD(instance, operations, 1);
+        return true;
+    }
+
+    // Last element (left == 0) goes to whoever advances top first
+    bool won = left == 0 &&
+               atomic_compare_exchange_strong_explicit(&instance->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed);
+    if (won) {
+        memcpy(data, tds_deque_slot(instance, a, bottom), instance->elements);
+        TDS_STATS_ADD(instance, operations, 1);
+    } else {
+        TDS_STATS_ADD(instance, failed_empty, 1);
+    }
+    atomic_store_explicit(&instance->bottom, bottom + 1, memory_order_relaxed);
+    return won;
+}
+
+bool tds_deque_steal(tds_deque_t instance, void* data) {
+    if (!instance || !data) {
+        return false;
+    }
+
+    for (;;) {
+        uint32_t top = atomic_load_explicit(&instance->top, memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        uint32_t bottom = atomic_load_explicit(&instance->bottom, memory_order_acquire);
+        if ((int32_t) (bottom - top) <= 0) {
+            TDS_STATS_ADD(instance, failed_empty, 1);
+            return false;
+        }
+
+        // The copy may race with a growth or a wrap-around only when top has
+        // moved on, in which case the CAS below fails and the copy is dropped
+        struct tds_deque_array_t* a = atomic_load_explicit(&instance->array, memory_order_acquire);
+        memcpy(data, tds_deque_slot(instance, a, top), instance->elements);
+        if (atomic_compare_exchange_strong_explicit(&instance->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+            TDS_STATS_ADD(instance, operations, 1);
+            return true;
+        }
+        TDS_STATS_ADD(instance, retries, 1);
+    }
+}
+
+uint32_t tds_deque_size(tds_deque_t instance) {
+    if (!instance) {
+        return 0;
+    }
+
+    uint32_t top    = atomic_load_explicit(&instance->top, memory_order_acquire);
+    uint32_t bottom = atomic_load_explicit(&instance->bottom, memory_order_acquire);
+    int32_t  size   = (int32_t) (bottom - top);
+    return size > 0 ? (uint32_t) size : 0;
+}
+
+bool tds_deque_empty(tds_deque_t instance) {
+    return tds_deque_size(instance) == 0;
+}
+
+uint32_t tds_deque_capacity(tds_deque_t instance) {
+    if (!instance) {
+        return 0;
+    }
+    return atomic_load_explicit(&instance->array, memory_order_acquire)->mask + 1;
+}
+
+bool tds_deque_get_stats(tds_deque_t instance, tds_stats_t* stats) {
+    if (!instance || !stats) {
+        return false;
+    }
+
+    return TDS_STATS_READ(instance, stats);
+}
+
+bool tds_deque_destroy(tds_deque_t instance) {
+    if (!instance) {
+        return false;
+    }
+
+    struct tds_deque_array_t* a = atomic_load_explicit(&instance->array, memory_order_relaxed);
+    while (a) {
+        struct tds_deque_array_t* retired = a->retired;
+        TDS_FREE(a);
+        a = retired;
+    }
+    TDS_FREE(instance);
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // DEQUE_C
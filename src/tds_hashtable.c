@@ -0,0 +1,1413 @@
+/******************************************************************************
+ * File: tds_hashtable.c
+ * Author: Tiago Barbosa
+ * Description: Open-addressing hashtable for embedded systems.
+ *              Keys and values are fixed-size byte blobs stored inline in a
+ *              flat slot array, with one control byte per slot probed 16 at
+ *              a time (SSE2 when available, portable scalar otherwise).
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef HASHTABLE_C
+#define HASHTABLE_C
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include "tds_hashtable.h"
+
+#include <stdatomic.h>  // For the concurrent mode
+#include <stdlib.h>     // For malloc, free
+#include <string.h>     // For memcpy, memcmp, memset
+
+#include "tds_config.h"
+#include "tds_snapshot_internal.h"
+
+#if TDS_HASHTABLE_USE_SSE2
+#include <emmintrin.h>  // For the 16-byte control group compares
+#endif
+
+/* Defines ------------------------------------------------------------------*/
+#define TDS_HT_GROUP_WIDTH 16
+#define TDS_HT_EMPTY       ((uint8_t) 0x80) /**< Never used: stops a probe */
+#define TDS_HT_DELETED     ((uint8_t) 0xFE) /**< Tombstone: probes continue past it */
+#define TDS_HT_MIN_SLOTS   TDS_HT_GROUP_WIDTH
+#define TDS_HT_MAX_SLOTS   (UINT32_C(1) << 30)
+#define TDS_HT_NOT_FOUND   UINT32_MAX
+#define TDS_HT_LOAD_CHECKS 64 /**< Entries of a loaded snapshot rehashed to check the hash function */
+
+/* Typedefs -----------------------------------------------------------------*/
+
+/**
+ * @brief Slot storage of a hashtable.
+ *
+ * Control byte values: 0x00-0x7F full (low 7 bits of the hash), 0x80 empty,
+ * 0xFE deleted. Slots are grouped in aligned runs of 16 so a whole group of
+ * control bytes fits one vector compare; probing jumps between groups.
+ */
+struct tds_hashtable_table_t {
+    uint8_t* ctrl;     /**< One control byte per slot */
+    uint8_t* slots;    /**< Slot array, slot_size bytes per slot */
+    uint32_t mask;     /**< Slot count - 1 (slot count is a power of two >= 16) */
+    uint32_t used;     /**< Number of full slots */
+    uint32_t deleted;  /**< Number of tombstones */
+    uint32_t max_fill; /**< Limit of used + deleted before a rehash */
+};
+
+/**
+ * @brief Table of a concurrent hashtable.
+ *
+ * seq[g] is even while group g is stable and odd while a writer modifies it.
+ * generation does the same for the whole table while a purge rewrites it.
+ */
+struct tds_ht_shared_table_t {
+    struct tds_hashtable_table_t  table;
+    _Atomic uint32_t*             seq;        /**< One sequence counter per probe group */
+    _Atomic uint32_t              fill;       /**< used + deleted, checked against max_fill */
+    _Atomic uint32_t              generation; /**< Bumped twice by every in-place purge */
+    struct tds_ht_shared_table_t* retired;    /**< Next older (smaller) table kept alive for late readers */
+};
+
+/**
+ * @brief Writer lock stripe, alone on its cache line.
+ */
+struct tds_ht_stripe_t {
+    _Atomic uint32_t lock;
+    uint8_t          pad[TDS_CACHE_LINE_SIZE - sizeof(uint32_t)];
+};
+
+/**
+ * @brief State of a concurrent hashtable.
+ */
+struct tds_ht_shared_t {
+    struct tds_ht_stripe_t                 stripes[TDS_HASHTABLE_LOCK_STRIPES];
+    _Atomic(struct tds_ht_shared_table_t*) current; /**< Table used by new operations */
+    _Atomic uint32_t                       used;    /**< Number of entries */
+};
+
+/**
+ * @brief Structure representing a hashtable instance.
+ */
+struct tds_hashtable_instance_t {
+    struct tds_hashtable_table_t table;   /**< Single-threaded mode storage */
+    struct tds_hashtable_table_t old;     /**< Table being drained by an incremental resize (ctrl NULL when idle) */
+    uint32_t                     migrate; /**< Next group of old to move into table */
+    struct tds_ht_shared_t*      shared;  /**< Concurrent mode state, NULL otherwise */
+    tds_hashtable_hash_fn        hash;
+    tds_hashtable_equal_fn       equal;
+    tds_allocator_t              allocator;
+    float                        max_load_factor;
+    uint32_t                     key_size;
+    uint32_t                     value_size;
+    uint32_t                     value_offset; /**< Offset of the value inside a slot */
+    uint32_t                     slot_size;    /**< Key + value, padded to keep both aligned */
+    bool                         is_static;    /**< Instance lives in caller memory (tds_hashtable_init_static) */
+
+    TDS_STATS_FIELD
+};
+
+_Static_assert(sizeof(struct tds_hashtable_instance_t) <= TDS_HASHTABLE_INSTANCE_SIZE, "TDS_HASHTABLE_INSTANCE_SIZE too small");
+
+/* Private Functions --------------------------------------------------------*/
+
+static inline uint32_t tds_ht_ctz(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t) __builtin_ctz(mask);
+#else
+    uint32_t n = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/**
+ * @brief Bitmask of the slots of a group whose control byte equals h2.
+ */
+static inline uint32_t tds_ht_match(const uint8_t* group, uint8_t h2) {
+#if TDS_HASHTABLE_USE_SSE2
+    __m128i ctrl = _mm_loadu_si128((const __m128i*) group);
+    return (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char) h2)));
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < TDS_HT_GROUP_WIDTH; i++) {
+        mask |= (uint32_t) (group[i] == h2) << i;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * @brief Bitmask of the empty slots of a group.
+ */
+static inline uint32_t tds_ht_match_empty(const uint8_t* group) {
+    return tds_ht_match(group, TDS_HT_EMPTY);
+}
+
+/**
+ * @brief Bitmask of the empty or deleted slots of a group (high bit set).
+ */
+static inline uint32_t tds_ht_match_free(const uint8_t* group) {
+#if TDS_HASHTABLE_USE_SSE2
+    return (uint32_t) _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) group));
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < TDS_HT_GROUP_WIDTH; i++) {
+        mask |= (uint32_t) (group[i] >> 7) << i;
+    }
+    return mask;
+#endif
+}
+
+static inline uint64_t tds_ht_mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= UINT64_C(0xff51afd7ed558ccd);
+    x ^= x >> 33;
+    x *= UINT64_C(0xc4ceb9fe1a85ec53);
+    x ^= x >> 33;
+    return x;
+}
+
+static inline uint8_t tds_ht_h2(uint64_t hash) {
+    return (uint8_t) (hash & 0x7F);
+}
+
+static inline uint32_t tds_ht_first_group(const struct tds_hashtable_table_t* table, uint64_t hash) {
+    return (uint32_t) (hash >> 7) & (table->mask >> 4);
+}
+
+static inline uint8_t* tds_ht_slot(tds_hashtable_t ht, const struct tds_hashtable_table_t* table, uint32_t index) {
+    return table->slots + (size_t) index * ht->slot_size;
+}
+
+static bool tds_ht_default_equal(const void* a, const void* b, size_t key_size) {
+    return memcmp(a, b, key_size) == 0;
+}
+
+/**
+ * @brief Largest power of two (up to 8) dividing size: the alignment a C
+ * object of that size can require.
+ */
+static uint32_t tds_ht_natural_align(size_t size) {
+    uint32_t align = 1;
+    while (align < 8 && size % (align * 2) == 0) {
+        align *= 2;
+    }
+    return align;
+}
+
+/**
+ * @brief Finds the slot holding key, or TDS_HT_NOT_FOUND.
+ *
+ * Groups are visited in triangular order, which covers every group once
+ * because the group count is a power of two. The probe stops at the first
+ * group that still has an empty slot.
+ */
+static uint32_t tds_ht_find(tds_hashtable_t ht, const struct tds_hashtable_table_t* table, const void* key, uint64_t hash) {
+    uint8_t  h2         = tds_ht_h2(hash);
+    uint32_t group_mask = table->mask >> 4;
+    uint32_t group      = tds_ht_first_group(table, hash);
+
+    for (uint32_t step = 1; step <= group_mask + 1; step++) {
+        const uint8_t* ctrl  = table->ctrl + (size_t) group * TDS_HT_GROUP_WIDTH;
+        uint32_t       match = tds_ht_match(ctrl, h2);
+
+        while (match) {
+            uint32_t index = group * TDS_HT_GROUP_WIDTH + tds_ht_ctz(match);
+            if (ht->equal(key, tds_ht_slot(ht, table, index), ht->key_size)) {
+                return index;
+            }
+            match &= match - 1;
+        }
+
+        if (tds_ht_match_empty(ctrl)) {
+            return TDS_HT_NOT_FOUND;
+        }
+        group = (group + step) & group_mask;
+    }
+
+    return TDS_HT_NOT_FOUND;
+}
+
+/**
+ * @brief Finds the first empty or deleted slot on the probe path of hash.
+ */
+static uint32_t tds_ht_find_free(const struct tds_hashtable_table_t* table, uint64_t hash) {
+    uint32_t group_mask = table->mask >> 4;
+    uint32_t group      = tds_ht_first_group(table, hash);
+
+    for (uint32_t step = 1; step <= group_mask + 1; step++) {
+        uint32_t match = tds_ht_match_free(table->ctrl + (size_t) group * TDS_HT_GROUP_WIDTH);
+        if (match) {
+            return group * TDS_HT_GROUP_WIDTH + tds_ht_ctz(match);
+        }
+        group = (group + step) & group_mask;
+    }
+
+    return TDS_HT_NOT_FOUND;
+}
+
+static bool tds_ht_table_init(tds_hashtable_t ht, struct tds_hashtable_table_t* table, uint32_t slots) {
+    if (ht->slot_size != 0 && slots > (SIZE_MAX - slots) / ht->slot_size) {
+        return false;
+    }
+
+    uint8_t* storage = (uint8_t*) ht->allocator.alloc(ht->allocator.context, (size_t) slots + (size_t) slots * ht->slot_size);
+    if (!storage) {
+        //printf("[ERROR] Failed to allocate memory for %u hashtable slots.\n", slots);
+        return false;
+    }
+    TDS_STATS_ALLOC(ht, (size_t) slots + (size_t) slots * ht->slot_size);
+
+    memset(storage, TDS_HT_EMPTY, slots);
+    table->ctrl     = storage;
+    table->slots    = storage + slots;  // slots is a multiple of 16: keeps malloc alignment
+    table->mask     = slots - 1;
+    table->used     = 0;
+    table->deleted  = 0;
+    table->max_fill = (uint32_t) ((float) slots * ht->max_load_factor);
+    if (table->max_fill >= slots) {
+        table->max_fill = slots - 1;
+    }
+    return true;
+}
+
+static void tds_ht_table_free(tds_hashtable_t ht, struct tds_hashtable_table_t* table) {
+    if (table->ctrl) {
+        tds_allocator_release(&ht->allocator, table->ctrl);
+        table->ctrl = NULL;
+    }
+}
+
+/**
+ * @brief Copies a full slot of src into the first free slot of its probe path in dst.
+ */
+static void tds_ht_move_slot(tds_hashtable_t ht, struct tds_hashtable_table_t* dst, const struct tds_hashtable_table_t* src, uint32_t i) {
+    const uint8_t* from  = tds_ht_slot(ht, src, i);
+    uint32_t       index = tds_ht_find_free(dst, ht->hash(from, ht->key_size));
+    if (dst->ctrl[index] == TDS_HT_DELETED) {
+        dst->deleted--;
+    }
+    dst->ctrl[index] = src->ctrl[i];
+    memcpy(tds_ht_slot(ht, dst, index), from, ht->slot_size);
+    dst->used++;
+}
+
+/**
+ * @brief Moves up to groups probe groups of the old table into the current one.
+ *
+ * Moved slots become tombstones rather than empty so that probes in the old
+ * table still walk past them to keys that have not been moved yet. The old
+ * storage is released once its last group has been drained.
+ */
+static void tds_ht_migrate(tds_hashtable_t ht, uint32_t groups) {
+    struct tds_hashtable_table_t* old   = &ht->old;
+    uint32_t                      total = (old->mask + 1) / TDS_HT_GROUP_WIDTH;
+
+    while (groups-- && ht->migrate < total) {
+        uint32_t first = ht->migrate++ * TDS_HT_GROUP_WIDTH;
+        for (uint32_t i = first; i < first + TDS_HT_GROUP_WIDTH; i++) {
+            if (old->ctrl[i] & 0x80) {
+                continue;
+            }
+            tds_ht_move_slot(ht, &ht->table, old, i);
+            old->ctrl[i] = TDS_HT_DELETED;
+            old->used--;
+        }
+    }
+
+    if (ht->migrate == total || old->used == 0) {
+        tds_ht_table_free(ht, old);
+    }
+}
+
+/**
+ * @brief Starts an incremental resize to new_slots slots.
+ *
+ * Only the new storage is allocated here; entries are moved by later
+ * operations through tds_ht_migrate(). A resize still in progress (only
+ * possible with very low load factors) is finished first.
+ */
+static bool tds_ht_begin_resize(tds_hashtable_t ht, uint32_t new_slots) {
+    if (ht->old.ctrl) {
+        tds_ht_migrate(ht, UINT32_MAX);
+    }
+
+    struct tds_hashtable_table_t fresh;
+    if (!tds_ht_table_init(ht, &fresh, new_slots)) {
+        return false;
+    }
+
+    ht->old     = ht->table;
+    ht->table   = fresh;
+    ht->migrate = 0;
+    if (ht->old.used == 0) {
+        tds_ht_table_free(ht, &ht->old);
+    }
+    return true;
+}
+
+/**
+ * @brief Moves every entry into a fresh table of new_slots slots at once, dropping tombstones.
+ */
+static bool tds_ht_rehash(tds_hashtable_t ht, uint32_t new_slots) {
+    if (!tds_ht_begin_resize(ht, new_slots)) {
+        return false;
+    }
+    if (ht->old.ctrl) {
+        tds_ht_migrate(ht, UINT32_MAX);
+    }
+    return true;
+}
+
+/**
+ * @brief Finds key in the current table, then in the table being drained.
+ *
+ * @return The table holding the key (its slot stored in index), or NULL.
+ */
+static struct tds_hashtable_table_t* tds_ht_lookup(tds_hashtable_t ht, const void* key, uint64_t hash, uint32_t* index) {
+    *index = tds_ht_find(ht, &ht->table, key, hash);
+    if (*index != TDS_HT_NOT_FOUND) {
+        return &ht->table;
+    }
+    if (ht->old.ctrl) {
+        *index = tds_ht_find(ht, &ht->old, key, hash);
+        if (*index != TDS_HT_NOT_FOUND) {
+            return &ht->old;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Smallest power-of-two slot count that holds entries under the load factor.
+ */
+static uint32_t tds_ht_slots_for(float max_load_factor, uint32_t entries) {
+    double   needed = (double) entries / max_load_factor + 1.0;
+    uint32_t slots  = TDS_HT_MIN_SLOTS;
+    while (slots < TDS_HT_MAX_SLOTS && (double) slots < needed) {
+        slots <<= 1;
+    }
+    return slots;
+}
+
+/* Concurrent mode --------------------------------------------------------*/
+
+#if TDS_HASHTABLE_LOCK_STRIPES > 64 || TDS_HASHTABLE_LOCK_STRIPES < 1
+#error "TDS_HASHTABLE_LOCK_STRIPES must be between 1 and 64"
+#endif
+
+static inline uint32_t tds_ht_ctz64(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t) __builtin_ctzll(mask);
+#else
+    uint32_t n = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+static inline uint32_t tds_ht_stripe_of(uint32_t group) {
+    return group % TDS_HASHTABLE_LOCK_STRIPES;
+}
+
+static inline void tds_ht_stripe_lock(tds_hashtable_t ht, uint32_t stripe) {
+    _Atomic uint32_t* lock = &ht->shared->stripes[stripe].lock;
+    for (;;) {
+        if (!atomic_exchange_explicit(lock, 1, memory_order_acquire)) {
+            return;
+        }
+        TDS_STATS_ADD(ht, retries, 1);
+        while (atomic_load_explicit(lock, memory_order_relaxed)) {
+            TDS_CPU_RELAX();
+        }
+    }
+}
+
+static inline bool tds_ht_stripe_trylock(struct tds_ht_shared_t* shared, uint32_t stripe) {
+    _Atomic uint32_t* lock = &shared->stripes[stripe].lock;
+    return !atomic_load_explicit(lock, memory_order_relaxed) && !atomic_exchange_explicit(lock, 1, memory_order_acquire);
+}
+
+static void tds_ht_stripes_unlock(struct tds_ht_shared_t* shared, uint64_t held) {
+    while (held) {
+        uint32_t stripe = tds_ht_ctz64(held);
+        atomic_store_explicit(&shared->stripes[stripe].lock, 0, memory_order_release);
+        held &= held - 1;
+    }
+}
+
+/**
+ * @brief Opens a group for writing: readers that overlap will retry.
+ */
+static inline void tds_ht_write_begin(struct tds_ht_shared_table_t* st, uint32_t group) {
+    atomic_fetch_add_explicit(&st->seq[group], 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline void tds_ht_write_end(struct tds_ht_shared_table_t* st, uint32_t group) {
+    atomic_fetch_add_explicit(&st->seq[group], 1, memory_order_release);
+}
+
+static struct tds_ht_shared_table_t* tds_ht_shared_table_create(tds_hashtable_t ht, uint32_t slots) {
+    uint32_t groups = slots / TDS_HT_GROUP_WIDTH;
+    struct tds_ht_shared_table_t* st =
+        (struct tds_ht_shared_table_t*) ht->allocator.alloc(ht->allocator.context, sizeof(struct tds_ht_shared_table_t) + (size_t) groups * sizeof(uint32_t));
+    if (!st) {
+        return NULL;
+    }
+    TDS_STATS_ALLOC(ht, sizeof(struct tds_ht_shared_table_t) + (size_t) groups * sizeof(uint32_t));
+
+    if (!tds_ht_table_init(ht, &st->table, slots)) {
+        tds_allocator_release(&ht->allocator, st);
+        return NULL;
+    }
+
+    st->seq     = (_Atomic uint32_t*) (st + 1);
+    st->retired = NULL;
+    atomic_init(&st->fill, 0);
+    atomic_init(&st->generation, 0);
+    for (uint32_t g = 0; g < groups; g++) {
+        atomic_init(&st->seq[g], 0);
+    }
+    return st;
+}
+
+static void tds_ht_shared_table_free(tds_hashtable_t ht, struct tds_ht_shared_table_t* st) {
+    while (st) {
+        struct tds_ht_shared_table_t* older = st->retired;
+        tds_ht_table_free(ht, &st->table);
+        tds_allocator_release(&ht->allocator, st);
+        st = older;
+    }
+}
+
+/**
+ * @brief Probes st without locks: validates every visited group against its
+ * sequence counter and retries the group if a writer was inside it.
+ */
+static bool tds_ht_shared_probe(tds_hashtable_t ht, struct tds_ht_shared_table_t* st, const void* key, uint64_t hash, void* value) {
+    struct tds_hashtable_table_t* table = &st->table;
+    uint8_t                       h2    = tds_ht_h2(hash);
+    uint32_t                      gmask = table->mask >> 4;
+    uint32_t                      group = tds_ht_first_group(table, hash);
+
+    for (uint32_t step = 1; step <= gmask + 1; step++) {
+        const uint8_t* ctrl = table->ctrl + (size_t) group * TDS_HT_GROUP_WIDTH;
+        bool           found;
+        bool           has_empty;
+        uint32_t       seq;
+
+        for (;;) {
+            seq = atomic_load_explicit(&st->seq[group], memory_order_acquire);
+            if (seq & 1) {
+                TDS_STATS_ADD(ht, retries, 1);
+                TDS_CPU_RELAX();
+                continue;
+            }
+
+            found          = false;
+            uint32_t match = tds_ht_match(ctrl, h2);
+            while (match) {
+                uint32_t index = group * TDS_HT_GROUP_WIDTH + tds_ht_ctz(match);
+                uint8_t* slot  = tds_ht_slot(ht, table, index);
+                if (ht->equal(key, slot, ht->key_size)) {
+                    if (value) {
+                        memcpy(value, slot + ht->value_offset, ht->value_size);
+                    }
+                    found = true;
+                    break;
+                }
+                match &= match - 1;
+            }
+            has_empty = tds_ht_match_empty(ctrl) != 0;
+
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&st->seq[group], memory_order_relaxed) == seq) {
+                break;
+            }
+            TDS_STATS_ADD(ht, retries, 1);
+        }
+
+        if (found) {
+            return true;
+        }
+        if (has_empty) {
+            return false;
+        }
+        group = (group + step) & gmask;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Lock-free lookup, retried as a whole if a purge moved the entries
+ * of the table meanwhile.
+ */
+static bool tds_ht_shared_get(tds_hashtable_t ht, const void* key, uint64_t hash, void* value) {
+    struct tds_ht_shared_table_t* st = atomic_load_explicit(&ht->shared->current, memory_order_acquire);
+
+    for (;;) {
+        uint32_t generation = atomic_load_explicit(&st->generation, memory_order_acquire);
+        if (generation & 1) {
+            TDS_STATS_ADD(ht, retries, 1);
+            TDS_CPU_RELAX();
+            continue;
+        }
+
+        bool found = tds_ht_shared_probe(ht, st, key, hash, value);
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&st->generation, memory_order_relaxed) == generation) {
+            if (found) {
+                TDS_STATS_ADD(ht, operations, 1);
+            } else {
+                TDS_STATS_ADD(ht, failed_empty, 1);
+            }
+            return found;
+        }
+        TDS_STATS_ADD(ht, retries, 1);
+    }
+}
+
+/**
+ * @brief Drops the tombstones of st in place; every stripe must be held.
+ *
+ * The entries are rebuilt into a scratch table, copied back over st and the
+ * scratch is freed at once, so a purge retires no table. Lookups running
+ * meanwhile see the generation change and start over.
+ */
+static bool tds_ht_shared_purge(tds_hashtable_t ht, struct tds_ht_shared_table_t* st) {
+    struct tds_hashtable_table_t scratch = {0};
+    uint32_t                     slots   = st->table.mask + 1;
+    if (!tds_ht_table_init(ht, &scratch, slots)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < slots; i++) {
+        if (!(st->table.ctrl[i] & 0x80)) {
+            tds_ht_move_slot(ht, &scratch, &st->table, i);
+        }
+    }
+
+    atomic_fetch_add_explicit(&st->generation, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(st->table.ctrl, scratch.ctrl, (size_t) slots + (size_t) slots * ht->slot_size);
+    atomic_fetch_add_explicit(&st->generation, 1, memory_order_release);
+
+    st->table.used    = scratch.used;
+    st->table.deleted = 0;
+    atomic_store_explicit(&st->fill, scratch.used, memory_order_relaxed);
+    tds_ht_table_free(ht, &scratch);
+    return true;
+}
+
+/**
+ * @brief Rebuilds the table while holding every stripe.
+ *
+ * With seen set, the table doubles (or drops its tombstones in place) unless
+ * another writer already made room in it; with seen NULL it is enlarged to
+ * min_slots if smaller. Readers keep probing the old table, which is
+ * unchanged during the copy and stays allocated (retired) until the
+ * hashtable is destroyed. Only growth retires tables, each smaller than the
+ * next, so the retired ones together hold fewer slots than the current one.
+ */
+static bool tds_ht_shared_resize(tds_hashtable_t ht, struct tds_ht_shared_table_t* seen, uint32_t min_slots) {
+    struct tds_ht_shared_t* shared = ht->shared;
+    uint64_t                all    = 0;
+    bool                    ok     = true;
+
+    for (uint32_t i = 0; i < TDS_HASHTABLE_LOCK_STRIPES; i++) {
+        tds_ht_stripe_lock(ht, i);
+        all |= UINT64_C(1) << i;
+    }
+
+    struct tds_ht_shared_table_t* old   = atomic_load_explicit(&shared->current, memory_order_relaxed);
+    uint32_t                      slots = old->table.mask + 1;
+    if (!seen && slots < min_slots) {
+        slots = min_slots;
+    } else if (old == seen && atomic_load_explicit(&old->fill, memory_order_relaxed) >= old->table.max_fill) {
+        uint32_t used = atomic_load_explicit(&shared->used, memory_order_relaxed);
+        if (used >= old->table.max_fill / 2 && slots < TDS_HT_MAX_SLOTS) {
+            slots <<= 1;
+        } else {
+            // Same size: only tombstones to reclaim, if any
+            ok    = used < old->table.max_fill && tds_ht_shared_purge(ht, old);
+            slots = 0;
+        }
+    } else {
+        slots = 0;
+    }
+
+    if (slots) {
+        struct tds_ht_shared_table_t* fresh = tds_ht_shared_table_create(ht, slots);
+        if (fresh) {
+            for (uint32_t i = 0; i <= old->table.mask; i++) {
+                if (old->table.ctrl[i] & 0x80) {
+                    continue;
+                }
+                uint8_t* src   = tds_ht_slot(ht, &old->table, i);
+                uint32_t index = tds_ht_find_free(&fresh->table, ht->hash(src, ht->key_size));
+                fresh->table.ctrl[index] = old->table.ctrl[i];
+                memcpy(tds_ht_slot(ht, &fresh->table, index), src, ht->slot_size);
+                fresh->table.used++;
+            }
+            atomic_store_explicit(&fresh->fill, fresh->table.used, memory_order_relaxed);
+            fresh->retired = old;
+            atomic_store_explicit(&shared->current, fresh, memory_order_release);
+        } else {
+            ok = false;
+        }
+    }
+
+    tds_ht_stripes_unlock(shared, all);
+    return ok;
+}
+
+typedef enum {
+    TDS_HT_OP_PUT,
+    TDS_HT_OP_REMOVE,
+} tds_ht_op_t;
+
+/**
+ * @brief Insert/overwrite or remove under the stripes of the probe path.
+ *
+ * The home group's stripe is taken blocking, which serializes writers of the
+ * same key; stripes further along the path are only tried, and on failure
+ * everything is released and the operation restarts, so writers (and the
+ * resizer, which takes stripes in order) can never deadlock.
+ */
+static bool tds_ht_shared_write(tds_hashtable_t ht, tds_ht_op_t op, const void* key, const void* value, void* removed) {
+    struct tds_ht_shared_t* shared = ht->shared;
+    uint64_t                hash   = ht->hash(key, ht->key_size);
+    uint8_t                 h2     = tds_ht_h2(hash);
+
+    for (;;) {
+        struct tds_ht_shared_table_t* st    = atomic_load_explicit(&shared->current, memory_order_acquire);
+        struct tds_hashtable_table_t* table = &st->table;
+        uint32_t                      gmask = table->mask >> 4;
+        uint32_t                      group = tds_ht_first_group(table, hash);
+        uint32_t                      home  = tds_ht_stripe_of(group);
+        uint64_t                      held  = UINT64_C(1) << home;
+        uint32_t                      free_index = TDS_HT_NOT_FOUND;
+        bool                          retry      = false;
+
+        tds_ht_stripe_lock(ht, home);
+        if (atomic_load_explicit(&shared->current, memory_order_acquire) != st) {
+            // A resize published a new table while we waited
+            tds_ht_stripes_unlock(shared, held);
+            TDS_STATS_ADD(ht, retries, 1);
+            continue;
+        }
+
+        for (uint32_t step = 1; step <= gmask + 1; step++) {
+            uint32_t stripe = tds_ht_stripe_of(group);
+            if (!(held & (UINT64_C(1) << stripe))) {
+                if (!tds_ht_stripe_trylock(shared, stripe)) {
+                    retry = true;
+                    break;
+                }
+                held |= UINT64_C(1) << stripe;
+            }
+
+            const uint8_t* ctrl  = table->ctrl + (size_t) group * TDS_HT_GROUP_WIDTH;
+            uint32_t       match = tds_ht_match(ctrl, h2);
+            while (match) {
+                uint32_t index = group * TDS_HT_GROUP_WIDTH + tds_ht_ctz(match);
+                uint8_t* slot  = tds_ht_slot(ht, table, index);
+                if (ht->equal(key, slot, ht->key_size)) {
+                    tds_ht_write_begin(st, group);
+                    if (op == TDS_HT_OP_PUT) {
+                        if (ht->value_size) {
+                            memcpy(slot + ht->value_offset, value, ht->value_size);
+                        }
+                    } else {
+                        if (removed) {
+                            memcpy(removed, slot + ht->value_offset, ht->value_size);
+                        }
+                        if (tds_ht_match_empty(ctrl)) {
+                            table->ctrl[index] = TDS_HT_EMPTY;
+                            atomic_fetch_sub_explicit(&st->fill, 1, memory_order_relaxed);
+                        } else {
+                            table->ctrl[index] = TDS_HT_DELETED;
+                        }
+                        atomic_fetch_sub_explicit(&shared->used, 1, memory_order_relaxed);
+                    }
+                    tds_ht_write_end(st, group);
+                    tds_ht_stripes_unlock(shared, held);
+                    TDS_STATS_ADD(ht, operations, 1);
+                    return true;
+                }
+                match &= match - 1;
+            }
+
+            uint32_t free_match = tds_ht_match_free(ctrl);
+            if (free_index == TDS_HT_NOT_FOUND && free_match) {
+                free_index = group * TDS_HT_GROUP_WIDTH + tds_ht_ctz(free_match);
+            }
+            if (tds_ht_match_empty(ctrl)) {
+                break;
+            }
+            group = (group + step) & gmask;
+        }
+
+        if (retry) {
+            tds_ht_stripes_unlock(shared, held);
+            TDS_STATS_ADD(ht, retries, 1);
+            TDS_CPU_RELAX();
+            continue;
+        }
+
+        if (op == TDS_HT_OP_REMOVE) {
+            tds_ht_stripes_unlock(shared, held);
+            TDS_STATS_ADD(ht, failed_empty, 1);
+            return false;
+        }
+
+        if (free_index == TDS_HT_NOT_FOUND ||
+            (table->ctrl[free_index] == TDS_HT_EMPTY && atomic_load_explicit(&st->fill, memory_order_relaxed) >= table->max_fill)) {
+            tds_ht_stripes_unlock(shared, held);
+            if (!tds_ht_shared_resize(ht, st, 0)) {
+                TDS_STATS_ADD(ht, failed_full, 1);
+                return false;
+            }
+            continue;
+        }
+
+        // The free slot lies on the path, so its stripe is held
+        uint32_t free_group = free_index / TDS_HT_GROUP_WIDTH;
+        uint8_t* slot       = tds_ht_slot(ht, table, free_index);
+        tds_ht_write_begin(st, free_group);
+        if (table->ctrl[free_index] == TDS_HT_EMPTY) {
+            atomic_fetch_add_explicit(&st->fill, 1, memory_order_relaxed);
+        }
+        memcpy(slot, key, ht->key_size);
+        if (ht->value_size) {
+            memcpy(slot + ht->value_offset, value, ht->value_size);
+        }
+        table->ctrl[free_index] = h2;
+        tds_ht_write_end(st, free_group);
+        atomic_fetch_add_explicit(&shared->used, 1, memory_order_relaxed);
+
+        tds_ht_stripes_unlock(shared, held);
+        TDS_STATS_ADD(ht, operations, 1);
+        TDS_STATS_MAX(ht, high_water, atomic_load_explicit(&shared->used, memory_order_relaxed));
+        return true;
+    }
+}
+
+static bool tds_ht_shared_clear(tds_hashtable_t ht) {
+    struct tds_ht_shared_t* shared = ht->shared;
+    uint64_t                all    = 0;
+
+    for (uint32_t i = 0; i < TDS_HASHTABLE_LOCK_STRIPES; i++) {
+        tds_ht_stripe_lock(ht, i);
+        all |= UINT64_C(1) << i;
+    }
+
+    struct tds_ht_shared_table_t* st     = atomic_load_explicit(&shared->current, memory_order_relaxed);
+    uint32_t                      groups = (st->table.mask + 1) / TDS_HT_GROUP_WIDTH;
+    for (uint32_t g = 0; g < groups; g++) {
+        tds_ht_write_begin(st, g);
+        memset(st->table.ctrl + (size_t) g * TDS_HT_GROUP_WIDTH, TDS_HT_EMPTY, TDS_HT_GROUP_WIDTH);
+        tds_ht_write_end(st, g);
+    }
+    atomic_store_explicit(&st->fill, 0, memory_order_relaxed);
+    atomic_store_explicit(&shared->used, 0, memory_order_relaxed);
+
+    tds_ht_stripes_unlock(shared, all);
+    return true;
+}
+
+/* Public Functions ---------------------------------------------------------*/
+
+uint64_t tds_hashtable_hash_bytes(const void* key, size_t key_size) {
+    const uint8_t* bytes = (const uint8_t*) key;
+    uint64_t       hash  = UINT64_C(0x9E3779B97F4A7C15) ^ ((uint64_t) key_size * UINT64_C(0xff51afd7ed558ccd));
+
+    while (key_size >= 8) {
+        uint64_t word;
+        memcpy(&word, bytes, 8);
+        hash = (hash ^ tds_ht_mix(word)) * UINT64_C(0x9E3779B97F4A7C15);
+        bytes += 8;
+        key_size -= 8;
+    }
+
+    if (key_size) {
+        uint64_t word = 0;
+        memcpy(&word, bytes, key_size);
+        hash = (hash ^ tds_ht_mix(word)) * UINT64_C(0x9E3779B97F4A7C15);
+    }
+
+    return tds_ht_mix(hash);
+}
+
+tds_hashtable_t tds_hashtable_create(uint32_t capacity, size_t key_size, size_t value_size) {
+    return tds_hashtable_create_ex(capacity, key_size, value_size, NULL);
+}
+
+/**
+ * @brief Validates the parameters shared by create_ex and init_static.
+ *
+ * @return The load factor to use, or 0 if the parameters are invalid.
+ */
+static float tds_ht_check(size_t key_size, size_t value_size, const tds_hashtable_config_t* config) {
+    float load = config->max_load_factor > 0.0f ? config->max_load_factor : TDS_HASHTABLE_DEFAULT_LOAD_FACTOR;
+    if (key_size == 0 || key_size > UINT16_MAX || value_size > UINT16_MAX || load > 1.0f) {
+        //printf("[ERROR] Invalid hashtable parameters!\n");
+        return 0.0f;
+    }
+
+    if (config->allocator && !config->allocator->alloc) {
+        //printf("[ERROR] Allocator callbacks are incomplete!\n");
+        return 0.0f;
+    }
+
+    return load;
+}
+
+/**
+ * @brief Fills a hashtable instance; the tables are created by the caller.
+ */
+static void tds_ht_setup(tds_hashtable_t ht, size_t key_size, size_t value_size, float load, const tds_hashtable_config_t* config, bool is_static) {
+    uint32_t key_align   = tds_ht_natural_align(key_size);
+    uint32_t value_align = value_size ? tds_ht_natural_align(value_size) : 1;
+    uint32_t slot_align  = key_align > value_align ? key_align : value_align;
+
+    TDS_STATS_INIT(ht);
+    ht->hash            = config->hash ? config->hash : tds_hashtable_hash_bytes;
+    ht->equal           = config->equal ? config->equal : tds_ht_default_equal;
+    ht->allocator       = config->allocator ? *config->allocator : *tds_allocator_default();
+    ht->max_load_factor = load;
+    ht->key_size        = (uint32_t) key_size;
+    ht->value_size      = (uint32_t) value_size;
+    ht->value_offset    = ((uint32_t) key_size + value_align - 1) & ~(value_align - 1);
+    ht->slot_size       = (ht->value_offset + (uint32_t) value_size + slot_align - 1) & ~(slot_align - 1);
+    ht->table.ctrl      = NULL;
+    ht->old.ctrl        = NULL;
+    ht->old.used        = 0;
+    ht->migrate         = 0;
+    ht->shared          = NULL;
+    ht->is_static       = is_static;
+}
+
+tds_hashtable_t tds_hashtable_create_ex(uint32_t capacity, size_t key_size, size_t value_size, const tds_hashtable_config_t* config) {
+    static const tds_hashtable_config_t default_config = TDS_HASHTABLE_CONFIG_DEFAULT;
+
+    if (!config) {
+        config = &default_config;
+    }
+
+    float load = tds_ht_check(key_size, value_size, config);
+    if (load == 0.0f) {
+        return NULL;
+    }
+
+    tds_hashtable_t ht = (tds_hashtable_t) TDS_MALLOC(sizeof(struct tds_hashtable_instance_t));
+    if (!ht) {
+        //printf("[ERROR] Failed to allocate memory for the hashtable.\n");
+        return NULL;
+    }
+    tds_ht_setup(ht, key_size, value_size, load, config, false);
+
+    if (config->concurrent) {
+        ht->shared = (struct tds_ht_shared_t*) TDS_MALLOC(sizeof(struct tds_ht_shared_t));
+        struct tds_ht_shared_table_t* st = ht->shared ? tds_ht_shared_table_create(ht, tds_ht_slots_for(load, capacity)) : NULL;
+        if (!st) {
+            TDS_FREE(ht->shared);
+            TDS_FREE(ht);
+            return NULL;
+        }
+        for (uint32_t i = 0; i < TDS_HASHTABLE_LOCK_STRIPES; i++) {
+            atomic_init(&ht->shared->stripes[i].lock, 0);
+        }
+        atomic_init(&ht->shared->used, 0);
+        atomic_init(&ht->shared->current, st);
+        return ht;
+    }
+
+    if (!tds_ht_table_init(ht, &ht->table, tds_ht_slots_for(load, capacity))) {
+        TDS_FREE(ht);
+        return NULL;
+    }
+
+    return ht;
+}
+
+tds_hashtable_t tds_hashtable_init_static(void* storage, size_t storage_size, uint32_t capacity, size_t key_size, size_t value_size,
+                                          const tds_hashtable_config_t* config) {
+    if (!storage || (uintptr_t) storage % _Alignof(max_align_t) != 0 || storage_size < TDS_HASHTABLE_INSTANCE_SIZE) {
+        //printf("[ERROR] Hashtable storage is missing, misaligned or too small!\n");
+        return NULL;
+    }
+
+    if (!config || !config->allocator || config->concurrent) {
+        //printf("[ERROR] A static hashtable needs an allocator and cannot be concurrent!\n");
+        return NULL;
+    }
+
+    float load = tds_ht_check(key_size, value_size, config);
+    if (load == 0.0f) {
+        return NULL;
+    }
+
+    tds_hashtable_t ht = (tds_hashtable_t) storage;
+    tds_ht_setup(ht, key_size, value_size, load, config, true);
+    if (!tds_ht_table_init(ht, &ht->table, tds_ht_slots_for(load, capacity))) {
+        return NULL;
+    }
+
+    return ht;
+}
+
+bool tds_hashtable_put(tds_hashtable_t instance, const void* key, const void* value) {
+    uint32_t index;
+
+    if (!instance || !key || (!value && instance->value_size)) {
+        //printf("[ERROR] Hashtable is not initialized or key/value is NULL!\n");
+        return false;
+    }
+
+    if (instance->shared) {
+        return tds_ht_shared_write(instance, TDS_HT_OP_PUT, key, value, NULL);
+    }
+
+    uint64_t hash = instance->hash(key, instance->key_size);
+    if (instance->old.ctrl) {
+        tds_ht_migrate(instance, TDS_HASHTABLE_MIGRATE_GROUPS);
+    }
+
+    struct tds_hashtable_table_t* found = tds_ht_lookup(instance, key, hash, &index);
+    if (found) {
+        if (instance->value_size) {
+            memcpy(tds_ht_slot(instance, found, index) + instance->value_offset, value, instance->value_size);
+        }
+        TDS_STATS_ADD(instance, operations, 1);
+        return true;
+    }
+
+    index = tds_ht_find_free(&instance->table, hash);
+    if (index == TDS_HT_NOT_FOUND ||
+        (instance->table.ctrl[index] == TDS_HT_EMPTY && instance->table.used + instance->table.deleted >= instance->table.max_fill)) {
+        if (instance->old.ctrl) {
+            tds_ht_migrate(instance, UINT32_MAX);
+        }
+        // Grow when live entries dominate, otherwise just purge the tombstones
+        uint32_t slots = instance->table.mask + 1;
+        if (instance->table.used >= instance->table.max_fill / 2) {
+            if (slots >= TDS_HT_MAX_SLOTS) {
+                TDS_STATS_ADD(instance, failed_full, 1);
+                return false;
+            }
+            slots <<= 1;
+        }
+        if (!tds_ht_begin_resize(instance, slots)) {
+            TDS_STATS_ADD(instance, failed_full, 1);
+            return false;
+        }
+        index = tds_ht_find_free(&instance->table, hash);
+    }
+
+    struct tds_hashtable_table_t* table = &instance->table;
+    if (table->ctrl[index] == TDS_HT_DELETED) {
+        table->deleted--;
+    }
+    table->ctrl[index] = tds_ht_h2(hash);
+    uint8_t* slot      = tds_ht_slot(instance, table, index);
+    memcpy(slot, key, instance->key_size);
+    if (instance->value_size) {
+        memcpy(slot + instance->value_offset, value, instance->value_size);
+    }
+    table->used++;
+    TDS_STATS_ADD(instance, operations, 1);
+    TDS_STATS_MAX(instance, high_water, table->used + instance->old.used);
+    return true;
+}
+
+bool tds_hashtable_get(tds_hashtable_t instance, const void* key, void* value) {
+    if (!instance || !key) {
+        return false;
+    }
+
+    if (instance->shared) {
+        return tds_ht_shared_get(instance, key, instance->hash(key, instance->key_size), value);
+    }
+
+    if (instance->old.ctrl) {
+        tds_ht_migrate(instance, TDS_HASHTABLE_MIGRATE_GROUPS);
+    }
+
+    uint32_t                      index;
+    struct tds_hashtable_table_t* table = tds_ht_lookup(instance, key, instance->hash(key, instance->key_size), &index);
+    if (!table) {
+        TDS_STATS_ADD(instance, failed_empty, 1);
+        return false;
+    }
+    TDS_STATS_ADD(instance, operations, 1);
+
+    if (value) {
+        memcpy(value, tds_ht_slot(instance, table, index) + instance->value_offset, instance->value_size);
+    }
+    return true;
+}
+
+bool tds_hashtable_contains(tds_hashtable_t instance, const void* key) {
+    return tds_hashtable_get(instance, key, NULL);
+}
+
+uint32_t tds_hashtable_get_batch(tds_hashtable_t instance, const void* keys, uint32_t count, void* values, uint64_t* found) {
+    if (!instance || (!keys && count > 0)) {
+        return 0;
+    }
+
+    const uint8_t* key  = (const uint8_t*) keys;
+    uint8_t*       out  = (uint8_t*) values;
+    uint32_t       hits = 0;
+    uint64_t       hash[TDS_HASHTABLE_BATCH_WINDOW];
+
+    if (found) {
+        memset(found, 0, ((size_t) count + 63) / 64 * sizeof(uint64_t));
+    }
+
+    for (uint32_t base = 0; base < count; base += TDS_HASHTABLE_BATCH_WINDOW) {
+        uint32_t n = count - base < TDS_HASHTABLE_BATCH_WINDOW ? count - base : TDS_HASHTABLE_BATCH_WINDOW;
+
+        if (instance->shared) {
+            // The table may be replaced meanwhile: the prefetches are only hints
+            const struct tds_hashtable_table_t* table = &atomic_load_explicit(&instance->shared->current, memory_order_acquire)->table;
+            for (uint32_t i = 0; i < n; i++) {
+                hash[i] = instance->hash(key + (size_t) (base + i) * instance->key_size, instance->key_size);
+                TDS_PREFETCH(table->ctrl + (size_t) tds_ht_first_group(table, hash[i]) * TDS_HT_GROUP_WIDTH);
+            }
+        } else {
+            if (instance->old.ctrl) {
+                tds_ht_migrate(instance, TDS_HASHTABLE_MIGRATE_GROUPS * n);
+            }
+
+            // Pass 1: hash and request the control bytes of the first group
+            const struct tds_hashtable_table_t* table = &instance->table;
+            for (uint32_t i = 0; i < n; i++) {
+                hash[i] = instance->hash(key + (size_t) (base + i) * instance->key_size, instance->key_size);
+                TDS_PREFETCH(table->ctrl + (size_t) tds_ht_first_group(table, hash[i]) * TDS_HT_GROUP_WIDTH);
+            }
+
+            // Pass 2: with the control bytes arriving, request the first candidate slot
+            for (uint32_t i = 0; i < n; i++) {
+                uint32_t group = tds_ht_first_group(table, hash[i]);
+                uint32_t match = tds_ht_match(table->ctrl + (size_t) group * TDS_HT_GROUP_WIDTH, tds_ht_h2(hash[i]));
+                if (match) {
+                    uint8_t* slot = tds_ht_slot(instance, table, group * TDS_HT_GROUP_WIDTH + tds_ht_ctz(match));
+                    TDS_PREFETCH(slot);
+                    TDS_PREFETCH(slot + instance->slot_size - 1);
+                }
+            }
+        }
+
+        // Pass 3: probe, now mostly from the cache
+        for (uint32_t i = 0; i < n; i++) {
+            const uint8_t* k   = key + (size_t) (base + i) * instance->key_size;
+            uint8_t*       v   = out ? out + (size_t) (base + i) * instance->value_size : NULL;
+            bool           hit = false;
+
+            if (instance->shared) {
+                hit = tds_ht_shared_get(instance, k, hash[i], v);
+            } else {
+                uint32_t                      index;
+                struct tds_hashtable_table_t* table = tds_ht_lookup(instance, k, hash[i], &index);
+                if (table) {
+                    if (v) {
+                        memcpy(v, tds_ht_slot(instance, table, index) + instance->value_offset, instance->value_size);
+                    }
+                    hit = true;
+                    TDS_STATS_ADD(instance, operations, 1);
+                } else {
+                    TDS_STATS_ADD(instance, failed_empty, 1);
+                }
+            }
+
+            if (hit) {
+                hits++;
+                if (found) {
+                    found[(base + i) / 64] |= UINT64_C(1) << ((base + i) % 64);
+                }
+            }
+        }
+    }
+
+    return hits;
+}
+
+bool tds_hashtable_remove(tds_hashtable_t instance, const void* key, void* value) {
+    if (!instance || !key) {
+        return false;
+    }
+
+    if (instance->shared) {
+        return tds_ht_shared_write(instance, TDS_HT_OP_REMOVE, key, NULL, value);
+    }
+
+    if (instance->old.ctrl) {
+        tds_ht_migrate(instance, TDS_HASHTABLE_MIGRATE_GROUPS);
+    }
+
+    uint32_t                      index;
+    struct tds_hashtable_table_t* table = tds_ht_lookup(instance, key, instance->hash(key, instance->key_size), &index);
+    if (!table) {
+        TDS_STATS_ADD(instance, failed_empty, 1);
+        return false;
+    }
+    TDS_STATS_ADD(instance, operations, 1);
+
+    if (value) {
+        memcpy(value, tds_ht_slot(instance, table, index) + instance->value_offset, instance->value_size);
+    }
+
+    // A group that still has an empty slot already stops every probe passing
+    // through it, so the slot can go back to empty instead of a tombstone
+    if (tds_ht_match_empty(table->ctrl + (index & ~(uint32_t) (TDS_HT_GROUP_WIDTH - 1)))) {
+        table->ctrl[index] = TDS_HT_EMPTY;
+    } else {
+        table->ctrl[index] = TDS_HT_DELETED;
+        table->deleted++;
+    }
+    table->used--;
+    return true;
+}
+
+int tds_hashtable_size(tds_hashtable_t instance) {
+    if (!instance) {
+        return -1;
+    }
+    if (instance->shared) {
+        return (int) atomic_load_explicit(&instance->shared->used, memory_order_relaxed);
+    }
+    return (int) (instance->table.used + instance->old.used);
+}
+
+int tds_hashtable_capacity(tds_hashtable_t instance) {
+    if (!instance) {
+        return -1;
+    }
+    if (instance->shared) {
+        return (int) (atomic_load_explicit(&instance->shared->current, memory_order_acquire)->table.mask + 1);
+    }
+    return (int) (instance->table.mask + 1);
+}
+
+bool tds_hashtable_reserve(tds_hashtable_t instance, uint32_t entries) {
+    if (!instance) {
+        return false;
+    }
+
+    uint32_t slots = tds_ht_slots_for(instance->max_load_factor, entries);
+    if ((double) slots * instance->max_load_factor < (double) entries) {
+        //printf("[ERROR] Cannot reserve %u hashtable entries!\n", entries);
+        return false;
+    }
+
+    if (instance->shared) {
+        return tds_ht_shared_resize(instance, NULL, slots);
+    }
+
+    if (slots <= instance->table.mask + 1) {
+        if (instance->old.ctrl) {
+            tds_ht_migrate(instance, UINT32_MAX);
+        }
+        return true;
+    }
+    return tds_ht_rehash(instance, slots);
+}
+
+bool tds_hashtable_get_stats(tds_hashtable_t instance, tds_stats_t* stats) {
+    if (!instance || !stats) {
+        return false;
+    }
+
+    return TDS_STATS_READ(instance, stats);
+}
+
+bool tds_hashtable_clear(tds_hashtable_t instance) {
+    if (!instance) {
+        return false;
+    }
+
+    if (instance->shared) {
+        return tds_ht_shared_clear(instance);
+    }
+
+    tds_ht_table_free(instance, &instance->old);
+    instance->old.used = 0;
+    memset(instance->table.ctrl, TDS_HT_EMPTY, (size_t) instance->table.mask + 1);
+    instance->table.used    = 0;
+    instance->table.deleted = 0;
+    return true;
+}
+
+bool tds_hashtable_destroy(tds_hashtable_t instance) {
+    if (!instance) {
+        return false;
+    }
+
+    if (instance->shared) {
+        tds_ht_shared_table_free(instance, atomic_load_explicit(&instance->shared->current, memory_order_relaxed));
+        TDS_FREE(instance->shared);
+    }
+    tds_ht_table_free(instance, &instance->old);
+    tds_ht_table_free(instance, &instance->table);
+    if (!instance->is_static) {
+        TDS_FREE(instance);
+    }
+    return true;
+}
+
+#if TDS_SNAPSHOT
+bool tds_hashtable_snapshot(tds_hashtable_t instance, int fd) {
+    if (!instance || fd < 0) {
+        return false;
+    }
+
+    const struct tds_hashtable_table_t* table;
+    if (instance->shared) {
+        table = &atomic_load_explicit(&instance->shared->current, memory_order_acquire)->table;
+    } else {
+        if (instance->old.ctrl) {
+            tds_ht_migrate(instance, UINT32_MAX);
+        }
+        table = &instance->table;
+    }
+
+    uint32_t slots = table->mask + 1, used = 0, deleted = 0;
+    for (uint32_t i = 0; i < slots; i++) {
+        used += !(table->ctrl[i] & 0x80);
+        deleted += table->ctrl[i] == TDS_HT_DELETED;
+    }
+
+    tds_snapshot_header_t header;
+    tds_snapshot_writer_t writer;
+    tds_snapshot_header_init(&header, TDS_SNAPSHOT_HASHTABLE);
+    header.element_size = instance->value_size;
+    header.capacity     = slots;
+    header.count        = used;
+    header.key_size     = instance->key_size;
+    header.slot_size    = instance->slot_size;
+    header.tombstones   = deleted;
+    header.data_size    = (uint64_t) slots + (uint64_t) slots * instance->slot_size;
+    if (!tds_snapshot_write_begin(&writer, fd, &header)) {
+        return false;
+    }
+
+    // Full groups go out as they are; other slots are zeroed so the file
+    // never carries stale or uninitialized memory
+    tds_snapshot_write(&writer, table->ctrl, slots);
+    for (uint32_t group = 0; group < slots; group += TDS_HT_GROUP_WIDTH) {
+        if (!tds_ht_match_free(table->ctrl + group)) {
+            tds_snapshot_write(&writer, tds_ht_slot(instance, table, group), (size_t) TDS_HT_GROUP_WIDTH * instance->slot_size);
+            continue;
+        }
+        for (uint32_t i = group; i < group + TDS_HT_GROUP_WIDTH; i++) {
+            tds_snapshot_write(&writer, table->ctrl[i] & 0x80 ? NULL : tds_ht_slot(instance, table, i), instance->slot_size);
+        }
+    }
+
+    return tds_snapshot_write_end(&writer);
+}
+
+/**
+ * @brief Copies a snapshot into a freshly initialized table of the same size
+ * and checks its control bytes against the header and the hash function.
+ */
+static bool tds_ht_load_table(tds_hashtable_t ht, struct tds_hashtable_table_t* table, const uint8_t* data, const tds_snapshot_header_t* header) {
+    uint32_t slots = table->mask + 1, used = 0, deleted = 0, checked = 0;
+
+    memcpy(table->ctrl, data, slots);
+    memcpy(table->slots, data + slots, (size_t) slots * ht->slot_size);
+
+    for (uint32_t i = 0; i < slots; i++) {
+        uint8_t ctrl = table->ctrl[i];
+        if (!(ctrl & 0x80)) {
+            used++;
+            if (checked < TDS_HT_LOAD_CHECKS) {
+                if (tds_ht_h2(ht->hash(tds_ht_slot(ht, table, i), ht->key_size)) != ctrl) {
+                    //printf("[ERROR] Snapshot was saved with another hash function!\n");
+                    return false;
+                }
+                checked++;
+            }
+        } else if (ctrl == TDS_HT_DELETED) {
+            deleted++;
+        } else if (ctrl != TDS_HT_EMPTY) {
+            return false;
+        }
+    }
+
+    table->used    = used;
+    table->deleted = deleted;
+    return used == header->count && deleted == header->tombstones && used + deleted < slots;
+}
+
+tds_hashtable_t tds_hashtable_load(const char* path, const tds_hashtable_config_t* config) {
+    static const tds_hashtable_config_t default_config = TDS_HASHTABLE_CONFIG_DEFAULT;
+    tds_snapshot_header_t               header;
+    size_t                              length;
+
+    const uint8_t* data = tds_snapshot_map(path, TDS_SNAPSHOT_HASHTABLE, &header, &length);
+    if (!data) {
+        return NULL;
+    }
+
+    uint32_t        slots = header.capacity;
+    tds_hashtable_t ht    = NULL;
+    if (slots >= TDS_HT_MIN_SLOTS && slots <= TDS_HT_MAX_SLOTS && (slots & (slots - 1)) == 0 &&
+        header.data_size == (uint64_t) slots + (uint64_t) slots * header.slot_size) {
+        ht = tds_hashtable_create_ex(0, header.key_size, header.element_size, config ? config : &default_config);
+    }
+
+    bool loaded = false;
+    if (ht && ht->slot_size == header.slot_size) {
+        if (ht->shared) {
+            struct tds_ht_shared_table_t* st = tds_ht_shared_table_create(ht, slots);
+            loaded                           = st && tds_ht_load_table(ht, &st->table, data, &header);
+            if (loaded) {
+                atomic_store_explicit(&st->fill, st->table.used + st->table.deleted, memory_order_relaxed);
+                atomic_store_explicit(&ht->shared->used, st->table.used, memory_order_relaxed);
+                tds_ht_shared_table_free(ht, atomic_load_explicit(&ht->shared->current, memory_order_relaxed));
+                atomic_store_explicit(&ht->shared->current, st, memory_order_release);
+            } else {
+                tds_ht_shared_table_free(ht, st);
+            }
+        } else {
+            struct tds_hashtable_table_t table = {0};
+            loaded                             = tds_ht_table_init(ht, &table, slots) && tds_ht_load_table(ht, &table, data, &header);
+            if (loaded) {
+                tds_ht_table_free(ht, &ht->table);
+                ht->table = table;
+            } else {
+                tds_ht_table_free(ht, &table);
+            }
+        }
+    }
+
+    if (ht && !loaded) {
+        tds_hashtable_destroy(ht);
+        ht = NULL;
+    }
+
+    tds_snapshot_unmap(data, &header, length);
+    return ht;
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // HASHTABLE_C
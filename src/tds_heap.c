@@ -0,0 +1,406 @@
+/******************************************************************************
+ * File: tds_heap.c
+ * Author: Tiago Barbosa
+ * Description: Priority queue for embedded systems, stored as a d-ary heap
+ *              in one contiguous array. Elements are ordered by a user
+ *              comparator and can be re-prioritized through stable handles.
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef HEAP_C
+#define HEAP_C
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include "tds_heap.h"
+
+#include <string.h>  // For memcpy
+
+#include "tds_config.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define TDS_HEAP_MAX_ARITY    16
+#define TDS_HEAP_MAX_CAPACITY (UINT32_C(1) << 30)
+#define TDS_HEAP_FREE         UINT32_C(0x80000000) /**< Marks a free handle; the low bits link the next one */
+
+/* Typedefs -----------------------------------------------------------------*/
+
+/**
+ * @brief Structure representing a heap instance.
+ *
+ * Slot i holds the element whose handle is handle_of[i], and slot_of maps a
+ * handle back to its slot, so moving an element costs one copy plus two
+ * index stores. Unused handles form a free list through slot_of.
+ */
+struct tds_heap_instance_t {
+    uint8_t*            data;        /**< (capacity + 1) * elements bytes; the extra slot is sift scratch */
+    uint32_t*           slot_of;     /**< Handle -> slot, or TDS_HEAP_FREE | next free handle */
+    uint32_t*           handle_of;   /**< Slot -> handle */
+    tds_heap_compare_fn compare;
+    uint32_t            arity;       /**< Children per node */
+    uint32_t            capacity;    /**< Maximum number of elements */
+    uint32_t            elements;    /**< Size of a single element in bytes */
+    uint32_t            size;        /**< Current number of elements */
+    uint32_t            free_handle; /**< First free handle, capacity when none */
+    bool                is_static;   /**< Instance and storage live in caller memory (tds_heap_init_static) */
+
+    TDS_STATS_FIELD
+};
+
+_Static_assert(sizeof(struct tds_heap_instance_t) <= TDS_HEAP_INSTANCE_SIZE, "TDS_HEAP_INSTANCE_SIZE too small");
+
+/* Private Functions --------------------------------------------------------*/
+
+static inline uint8_t* tds_heap_at(tds_heap_t heap, uint32_t slot) {
+    return heap->data + (size_t) slot * heap->elements;
+}
+
+static inline uint8_t* tds_heap_scratch(tds_heap_t heap) {
+    return tds_heap_at(heap, heap->capacity);
+}
+
+static inline void tds_heap_place(tds_heap_t heap, uint32_t slot, const uint8_t* element, uint32_t handle) {
+    memcpy(tds_heap_at(heap, slot), element, heap->elements);
+    heap->handle_of[slot] = handle;
+    heap->slot_of[handle] = slot;
+}
+
+/**
+ * @brief Moves the hole at slot up until the scratch element fits, then stores it there.
+ */
+static void tds_heap_sift_up(tds_heap_t heap, uint32_t slot, uint32_t handle) {
+    const uint8_t* item = tds_heap_scratch(heap);
+
+    while (slot > 0) {
+        uint32_t parent = (slot - 1) / heap->arity;
+        if (heap->compare(item, tds_heap_at(heap, parent)) >= 0) {
+            break;
+        }
+        tds_heap_place(heap, slot, tds_heap_at(heap, parent), heap->handle_of[parent]);
+        slot = parent;
+    }
+
+    tds_heap_place(heap, slot, item, handle);
+}
+
+/**
+ * @brief Moves the hole at slot down until the scratch element fits, then stores it there.
+ *
+ * The arity children of a slot are adjacent, so picking the smallest one
+ * walks a single run of memory.
+ */
+static void tds_heap_sift_down(tds_heap_t heap, uint32_t slot, uint32_t handle) {
+    const uint8_t* item = tds_heap_scratch(heap);
+
+    for (;;) {
+        uint64_t first = (uint64_t) slot * heap->arity + 1;
+        if (first >= heap->size) {
+            break;
+        }
+        uint32_t last = first + heap->arity < heap->size ? (uint32_t) first + heap->arity : heap->size;
+        uint32_t best = (uint32_t) first;
+        for (uint32_t child = best + 1; child < last; child++) {
+            if (heap->compare(tds_heap_at(heap, child), tds_heap_at(heap, best)) < 0) {
+                best = child;
+            }
+        }
+
+        if (heap->compare(tds_heap_at(heap, best), item) >= 0) {
+            break;
+        }
+        tds_heap_place(heap, slot, tds_heap_at(heap, best), heap->handle_of[best]);
+        slot = best;
+    }
+
+    tds_heap_place(heap, slot, item, handle);
+}
+
+/**
+ * @brief Stores the scratch element at slot, moving it up or down as its order requires.
+ */
+static void tds_heap_fix(tds_heap_t heap, uint32_t slot, uint32_t handle) {
+    if (slot > 0 && heap->compare(tds_heap_scratch(heap), tds_heap_at(heap, (slot - 1) / heap->arity)) < 0) {
+        tds_heap_sift_up(heap, slot, handle);
+    } else {
+        tds_heap_sift_down(heap, slot, handle);
+    }
+}
+
+static inline bool tds_heap_valid(tds_heap_t heap, tds_heap_handle_t handle) {
+    return handle < heap->capacity && !(heap->slot_of[handle] & TDS_HEAP_FREE);
+}
+
+static inline uint32_t tds_heap_handle_take(tds_heap_t heap) {
+    uint32_t handle   = heap->free_handle;
+    heap->free_handle = heap->slot_of[handle] & ~TDS_HEAP_FREE;
+    return handle;
+}
+
+static inline void tds_heap_handle_put(tds_heap_t heap, uint32_t handle) {
+    heap->slot_of[handle] = TDS_HEAP_FREE | heap->free_handle;
+    heap->free_handle     = handle;
+}
+
+static void tds_heap_reset(tds_heap_t heap) {
+    for (uint32_t i = 0; i < heap->capacity; i++) {
+        heap->slot_of[i] = TDS_HEAP_FREE | (i + 1);
+    }
+    heap->free_handle = 0;
+    heap->size        = 0;
+}
+
+/**
+ * @brief Validates the parameters shared by create_ex and init_static.
+ *
+ * @return Bytes of element storage (with the scratch slot), or 0 if invalid.
+ */
+static size_t tds_heap_layout(uint32_t capacity, size_t element_size, const tds_heap_config_t* config) {
+    if (!config || !config->compare || config->arity == 1 || config->arity > TDS_HEAP_MAX_ARITY) {
+        //printf("[ERROR] Heap needs a comparator and an arity of 2 to 16!\n");
+        return 0;
+    }
+
+    if (capacity == 0 || capacity > TDS_HEAP_MAX_CAPACITY || element_size == 0 || element_size > UINT32_MAX ||
+        element_size > (SIZE_MAX - 2 * (size_t) capacity * sizeof(uint32_t) - TDS_MEMORY_ALIGN) / ((size_t) capacity + 1)) {
+        //printf("[ERROR] Invalid heap parameters!\n");
+        return 0;
+    }
+
+    return TDS_MEMORY_ROUND(((size_t) capacity + 1) * element_size);
+}
+
+/**
+ * @brief Fills a heap instance over storage holding the elements followed by both handle tables.
+ */
+static void tds_heap_init(tds_heap_t heap, uint8_t* storage, size_t data_bytes, uint32_t capacity, size_t element_size, const tds_heap_config_t* config,
+                          bool is_static) {
+    heap->data      = storage;
+    heap->slot_of   = (uint32_t*) (storage + data_bytes);
+    heap->handle_of = heap->slot_of + capacity;
+    heap->compare   = config->compare;
+    heap->arity     = config->arity ? config->arity : TDS_HEAP_ARITY;
+    heap->capacity  = capacity;
+    heap->elements  = (uint32_t) element_size;
+    heap->is_static = is_static;
+    TDS_STATS_INIT(heap);
+    tds_heap_reset(heap);
+}
+
+/* Public Functions ---------------------------------------------------------*/
+
+tds_heap_t tds_heap_create(uint32_t capacity, size_t element_size, tds_heap_compare_fn compare) {
+    tds_heap_config_t config = {.compare = compare, .arity = 0};
+    return tds_heap_create_ex(capacity, element_size, &config);
+}
+
+tds_heap_t tds_heap_create_ex(uint32_t capacity, size_t element_size, const tds_heap_config_t* config) {
+    size_t data_bytes = tds_heap_layout(capacity, element_size, config);
+    if (!data_bytes) {
+        return NULL;
+    }
+
+    tds_heap_t heap = (tds_heap_t) TDS_MALLOC(sizeof(struct tds_heap_instance_t));
+    if (!heap) {
+        //printf("[ERROR] Failed to allocate memory for the heap.\n");
+        return NULL;
+    }
+
+    size_t   bytes   = data_bytes + 2 * (size_t) capacity * sizeof(uint32_t);
+    uint8_t* storage = (uint8_t*) TDS_MALLOC(bytes);
+    if (!storage) {
+        //printf("[ERROR] Failed to allocate memory for the heap storage.\n");
+        TDS_FREE(heap);
+        return NULL;
+    }
+
+    tds_heap_init(heap, storage, data_bytes, capacity, element_size, config, false);
+    TDS_STATS_ALLOC(heap, bytes);
+    return heap;
+}
+
+tds_heap_t tds_heap_init_static(void* storage, size_t storage_size, uint32_t capacity, size_t element_size, const tds_heap_config_t* config) {
+    size_t header     = TDS_MEMORY_ROUND(TDS_HEAP_INSTANCE_SIZE);
+    size_t data_bytes = tds_heap_layout(capacity, element_size, config);
+
+    if (!storage || (uintptr_t) storage % _Alignof(max_align_t) != 0 || !data_bytes) {
+        //printf("[ERROR] Heap storage is missing or misaligned!\n");
+        return NULL;
+    }
+
+    if (storage_size < header || storage_size - header < data_bytes + 2 * (size_t) capacity * sizeof(uint32_t)) {
+        //printf("[ERROR] Heap storage is too small!\n");
+        return NULL;
+    }
+
+    tds_heap_t heap = (tds_heap_t) storage;
+    tds_heap_init(heap, (uint8_t*) storage + header, data_bytes, capacity, element_size, config, true);
+    return heap;
+}
+
+bool tds_heap_push(tds_heap_t instance, const void* data, tds_heap_handle_t* handle) {
+    if (!instance || !data) {
+        //printf("[ERROR] Heap is not initialized or data pointer is NULL!\n");
+        return false;
+    }
+
+    if (instance->size >= instance->capacity) {
+        //printf("[ERROR] Heap is full! Maximum capacity reached (%u elements).\n", instance->capacity);
+        TDS_STATS_ADD(instance, failed_full, 1);
+        return false;
+    }
+
+    uint32_t id = tds_heap_handle_take(instance);
+    memcpy(tds_heap_scratch(instance), data, instance->elements);
+    tds_heap_sift_up(instance, instance->size++, id);
+
+    if (handle) {
+        *handle = id;
+    }
+    TDS_STATS_ADD(instance, operations, 1);
+    TDS_STATS_MAX(instance, high_water, instance->size);
+    return true;
+}
+
+bool tds_heap_pop(tds_heap_t instance, void* data) {
+    if (!instance) {
+        return false;
+    }
+
+    if (instance->size == 0) {
+        //printf("[ERROR] Heap is empty!\n");
+        TDS_STATS_ADD(instance, failed_empty, 1);
+        return false;
+    }
+
+    return tds_heap_remove(instance, instance->handle_of[0], data);
+}
+
+bool tds_heap_peek(tds_heap_t instance, void* data) {
+    if (!instance || !data) {
+        return false;
+    }
+
+    if (instance->size == 0) {
+        TDS_STATS_ADD(instance, failed_empty, 1);
+        return false;
+    }
+
+    memcpy(data, tds_heap_at(instance, 0), instance->elements);
+    TDS_STATS_ADD(instance, operations, 1);
+    return true;
+}
+
+bool tds_heap_heapify(tds_heap_t instance, const void* data, uint32_t count, tds_heap_handle_t* handles) {
+    if (!instance || !data || count == 0) {
+        return false;
+    }
+
+    if (count > instance->capacity - instance->size) {
+        //printf("[ERROR] Heap cannot take %u more elements!\n", count);
+        TDS_STATS_ADD(instance, failed_full, 1);
+        return false;
+    }
+
+    const uint8_t* src = (const uint8_t*) data;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t id = tds_heap_handle_take(instance);
+        tds_heap_place(instance, instance->size + i, src + (size_t) i * instance->elements, id);
+        if (handles) {
+            handles[i] = id;
+        }
+    }
+    instance->size += count;
+
+    // Floyd: sift down every parent, deepest first
+    for (uint32_t slot = instance->size > 1 ? (instance->size - 2) / instance->arity + 1 : 0; slot-- > 0;) {
+        memcpy(tds_heap_scratch(instance), tds_heap_at(instance, slot), instance->elements);
+        tds_heap_sift_down(instance, slot, instance->handle_of[slot]);
+    }
+
+    TDS_STATS_ADD(instance, operations, count);
+    TDS_STATS_MAX(instance, high_water, instance->size);
+    return true;
+}
+
+bool tds_heap_update(tds_heap_t instance, tds_heap_handle_t handle, const void* data) {
+    if (!instance || !data || !tds_heap_valid(instance, handle)) {
+        //printf("[ERROR] Heap is not initialized or handle is invalid!\n");
+        return false;
+    }
+
+    memcpy(tds_heap_scratch(instance), data, instance->elements);
+    tds_heap_fix(instance, instance->slot_of[handle], handle);
+    TDS_STATS_ADD(instance, operations, 1);
+    return true;
+}
+
+bool tds_heap_remove(tds_heap_t instance, tds_heap_handle_t handle, void* data) {
+    if (!instance || !tds_heap_valid(instance, handle)) {
+        //printf("[ERROR] Heap is not initialized or handle is invalid!\n");
+        return false;
+    }
+
+    uint32_t slot = instance->slot_of[handle];
+    if (data) {
+        memcpy(data, tds_heap_at(instance, slot), instance->elements);
+    }
+    tds_heap_handle_put(instance, handle);
+
+    // The last element fills the hole, then moves to where its order puts it
+    uint32_t last = --instance->size;
+    if (slot != last) {
+        memcpy(tds_heap_scratch(instance), tds_heap_at(instance, last), instance->elements);
+        tds_heap_fix(instance, slot, instance->handle_of[last]);
+    }
+
+    TDS_STATS_ADD(instance, operations, 1);
+    return true;
+}
+
+uint32_t tds_heap_size(tds_heap_t instance) {
+    return instance ? instance->size : 0;
+}
+
+bool tds_heap_empty(tds_heap_t instance) {
+    return !instance || instance->size == 0;
+}
+
+bool tds_heap_clear(tds_heap_t instance) {
+    if (!instance) {
+        return false;
+    }
+
+    tds_heap_reset(instance);
+    return true;
+}
+
+bool tds_heap_get_stats(tds_heap_t instance, tds_stats_t* stats) {
+    if (!instance || !stats) {
+        return false;
+    }
+
+    return TDS_STATS_READ(instance, stats);
+}
+
+bool tds_heap_destroy(tds_heap_t instance) {
+    if (!instance) {
+        //printf("[ERROR] Heap not initialized");
+        return false;
+    }
+
+    if (!instance->is_static) {
+        TDS_FREE(instance->data);
+        TDS_FREE(instance);
+    }
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // HEAP_C
@@ -0,0 +1,442 @@
+/******************************************************************************
+ * File: tds_list.c
+ * Author: Tiago Barbosa
+ * Description: Unrolled linked list for embedded systems.
+ *              Each node packs a small array of elements sized to one or two
+ *              cache lines, so scans walk mostly contiguous memory while
+ *              inserting in the middle only shifts the elements of one node.
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef LIST_C
+#define LIST_C
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include "tds_list.h"
+
+#include <stdlib.h>  // For malloc, free
+#include <string.h>  // For memcpy, memmove, memcmp
+
+#include "tds_config.h"
+
+/* Typedefs -----------------------------------------------------------------*/
+
+/**
+ * @brief Node of an unrolled list: up to per_node elements packed in order.
+ */
+struct tds_list_node_t {
+    struct tds_list_node_t*       next;
+    struct tds_list_node_t*       prev;
+    uint32_t                      count; /**< Elements stored, never 0 while linked */
+    _Alignas(max_align_t) uint8_t data[];
+};
+
+/**
+ * @brief Structure representing a list instance.
+ */
+struct tds_list_instance_t {
+    struct tds_list_node_t* head;
+    struct tds_list_node_t* tail;
+    tds_allocator_t         allocator; /**< Allocator used for the nodes */
+    uint32_t                per_node;  /**< Elements per node */
+    uint32_t                capacity;  /**< Maximum number of elements */
+    uint32_t                elements;  /**< Size of a single element in bytes */
+    uint32_t                size;      /**< Current number of elements */
+    bool                    is_static; /**< Instance lives in caller memory (tds_list_init_static) */
+
+    TDS_STATS_FIELD
+};
+
+_Static_assert(sizeof(struct tds_list_instance_t) <= TDS_LIST_INSTANCE_SIZE, "TDS_LIST_INSTANCE_SIZE too small");
+
+/* Private Functions --------------------------------------------------------*/
+
+static uint32_t tds_list_per_node(size_t element_size) {
+    size_t room  = TDS_LIST_NODE_BYTES > sizeof(struct tds_list_node_t) ? TDS_LIST_NODE_BYTES - sizeof(struct tds_list_node_t) : 0;
+    size_t count = room / element_size;
+    return count ? (uint32_t) count : 1;
+}
+
+static inline uint8_t* tds_list_at(tds_list_t list, struct tds_list_node_t* node, uint32_t index) {
+    return node->data + (size_t) index * list->elements;
+}
+
+static struct tds_list_node_t* tds_list_node_new(tds_list_t list) {
+    struct tds_list_node_t* node = (struct tds_list_node_t*) list->allocator.alloc(list->allocator.context, tds_list_node_size(list->elements));
+    if (!node) {
+        //printf("[ERROR] Failed to allocate memory for a list node.\n");
+        return NULL;
+    }
+    TDS_STATS_ALLOC(list, tds_list_node_size(list->elements));
+    node->count = 0;
+    return node;
+}
+
+/**
+ * @brief Links node after prev, or at the front when prev is NULL.
+ */
+static void tds_list_link_after(tds_list_t list, struct tds_list_node_t* prev, struct tds_list_node_t* node) {
+    node->prev = prev;
+    node->next = prev ? prev->next : list->head;
+    if (node->next) {
+        node->next->prev = node;
+    } else {
+        list->tail = node;
+    }
+    if (prev) {
+        prev->next = node;
+    } else {
+        list->head = node;
+    }
+}
+
+static void tds_list_unlink_free(tds_list_t list, struct tds_list_node_t* node) {
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        list->head = node->next;
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    } else {
+        list->tail = node->prev;
+    }
+    tds_allocator_release(&list->allocator, node);
+}
+
+/**
+ * @brief Finds the node holding position index, walking from the nearer end.
+ *
+ * Position size maps to the end of the tail node. A position on a node
+ * boundary maps to the start of the later node.
+ */
+static struct tds_list_node_t* tds_list_locate(tds_list_t list, uint32_t index, uint32_t* offset) {
+    struct tds_list_node_t* node;
+
+    if (index >= list->size / 2) {
+        uint32_t start = list->size - list->tail->count;
+        node           = list->tail;
+        while (index < start) {
+            node   = node->prev;
+            start -= node->count;
+        }
+        *offset = index - start;
+    } else {
+        node = list->head;
+        while (index >= node->count) {
+            index -= node->count;
+            node   = node->next;
+        }
+        *offset = index;
+    }
+
+    return node;
+}
+
+/* Public Functions ---------------------------------------------------------*/
+
+tds_list_t tds_list_create(uint32_t capacity, size_t element_size) {
+    return tds_list_create_ex(capacity, element_size, NULL);
+}
+
+/**
+ * @brief Validates the parameters shared by create_ex and init_static.
+ */
+static bool tds_list_check(uint32_t capacity, size_t element_size, const tds_list_config_t* config) {
+    if (capacity == 0 || element_size == 0 || element_size > UINT32_MAX) {
+        //printf("[ERROR] Invalid list parameters!\n");
+        return false;
+    }
+
+    if (config && config->allocator && !config->allocator->alloc) {
+        //printf("[ERROR] Allocator callbacks are incomplete!\n");
+        return false;
+    }
+
+    return true;
+}
+
+static void tds_list_init(tds_list_t list, uint32_t capacity, size_t element_size, const tds_list_config_t* config, bool is_static) {
+    list->head      = NULL;
+    list->tail      = NULL;
+    list->allocator = (config && config->allocator) ? *config->allocator : *tds_allocator_default();
+    list->per_node  = tds_list_per_node(element_size);
+    list->capacity  = capacity;
+    list->elements  = (uint32_t) element_size;
+    list->size      = 0;
+    list->is_static = is_static;
+    TDS_STATS_INIT(list);
+}
+
+tds_list_t tds_list_create_ex(uint32_t capacity, size_t element_size, const tds_list_config_t* config) {
+    if (!tds_list_check(capacity, element_size, config)) {
+        return NULL;
+    }
+
+    tds_list_t list = (tds_list_t) TDS_MALLOC(sizeof(struct tds_list_instance_t));
+    if (!list) {
+        //printf("[ERROR] Failed to allocate memory for the list.\n");
+        return NULL;
+    }
+
+    tds_list_init(list, capacity, element_size, config, false);
+
+    //printf("[LOG] List created with %u elements per node.\n", list->per_node);
+    return list;
+}
+
+tds_list_t tds_list_init_static(void* storage, size_t storage_size, uint32_t capacity, size_t element_size, const tds_list_config_t* config) {
+    if (!storage || (uintptr_t) storage % _Alignof(max_align_t) != 0 || storage_size < TDS_LIST_INSTANCE_SIZE) {
+        //printf("[ERROR] List storage is missing, misaligned or too small!\n");
+        return NULL;
+    }
+
+    if (!config || !config->allocator || !tds_list_check(capacity, element_size, config)) {
+        //printf("[ERROR] A static list needs an allocator for its nodes!\n");
+        return NULL;
+    }
+
+    tds_list_t list = (tds_list_t) storage;
+    tds_list_init(list, capacity, element_size, config, true);
+    return list;
+}
+
+size_t tds_list_node_size(size_t element_size) {
+    return sizeof(struct tds_list_node_t) + (size_t) tds_list_per_node(element_size) * element_size;
+}
+
+bool tds_list_insert(tds_list_t instance, uint32_t index, const void* data) {
+    if (!instance || !data || index > instance->size) {
+        //printf("[ERROR] List is not initialized or index is out of range!\n");
+        return false;
+    }
+
+    if (instance->size >= instance->capacity) {
+        //printf("[ERROR] List is full! Maximum capacity reached (%u elements).\n", instance->capacity);
+        TDS_STATS_ADD(instance, failed_full, 1);
+        return false;
+    }
+
+    uint32_t                offset = 0;
+    struct tds_list_node_t* node   = instance->size ? tds_list_locate(instance, index, &offset) : NULL;
+
+    if (!node) {
+        node = tds_list_node_new(instance);
+        if (!node) {
+            return false;
+        }
+        tds_list_link_after(instance, NULL, node);
+    } else if (node->count == instance->per_node) {
+        if (offset == 0 && node->prev && node->prev->count < instance->per_node) {
+            // Append to the previous node instead of shifting a full one
+            node   = node->prev;
+            offset = node->count;
+        } else if (offset == node->count) {
+            // Appending past the tail: start a new node so sequential pushes keep nodes full
+            struct tds_list_node_t* fresh = tds_list_node_new(instance);
+            if (!fresh) {
+                return false;
+            }
+            tds_list_link_after(instance, node, fresh);
+            node   = fresh;
+            offset = 0;
+        } else {
+            // Split: the upper half moves to a new node after this one
+            struct tds_list_node_t* fresh = tds_list_node_new(instance);
+            if (!fresh) {
+                return false;
+            }
+            uint32_t half = node->count / 2;
+            memcpy(fresh->data, tds_list_at(instance, node, half), (size_t) (node->count - half) * instance->elements);
+            fresh->count = node->count - half;
+            node->count  = half;
+            tds_list_link_after(instance, node, fresh);
+            if (offset > half) {
+                node    = fresh;
+                offset -= half;
+            }
+        }
+    }
+
+    memmove(tds_list_at(instance, node, offset + 1), tds_list_at(instance, node, offset), (size_t) (node->count - offset) * instance->elements);
+    memcpy(tds_list_at(instance, node, offset), data, instance->elements);
+    node->count++;
+    instance->size++;
+    TDS_STATS_ADD(instance, operations, 1);
+    TDS_STATS_MAX(instance, high_water, instance->size);
+    return true;
+}
+
+bool tds_list_push_back(tds_list_t instance, const void* data) {
+    return instance && tds_list_insert(instance, instance->size, data);
+}
+
+bool tds_list_push_front(tds_list_t instance, const void* data) {
+    return tds_list_insert(instance, 0, data);
+}
+
+bool tds_list_remove(tds_list_t instance, uint32_t index, void* data) {
+    if (!instance || index >= instance->size) {
+        //printf("[ERROR] List is not initialized or index is out of range!\n");
+        return false;
+    }
+
+    uint32_t                offset;
+    struct tds_list_node_t* node = tds_list_locate(instance, index, &offset);
+
+    if (data) {
+        memcpy(data, tds_list_at(instance, node, offset), instance->elements);
+    }
+    memmove(tds_list_at(instance, node, offset), tds_list_at(instance, node, offset + 1), (size_t) (node->count - offset - 1) * instance->elements);
+    node->count--;
+    instance->size--;
+    TDS_STATS_ADD(instance, operations, 1);
+
+    if (node->count == 0) {
+        tds_list_unlink_free(instance, node);
+    } else if (node->count < instance->per_node / 2) {
+        // Merge with a neighbour when both fit in one node
+        struct tds_list_node_t* next = node->next;
+        struct tds_list_node_t* prev = node->prev;
+        if (next && node->count + next->count <= instance->per_node) {
+            memcpy(tds_list_at(instance, node, node->count), next->data, (size_t) next->count * instance->elements);
+            node->count += next->count;
+            tds_list_unlink_free(instance, next);
+        } else if (prev && prev->count + node->count <= instance->per_node) {
+            memcpy(tds_list_at(instance, prev, prev->count), node->data, (size_t) node->count * instance->elements);
+            prev->count += node->count;
+            tds_list_unlink_free(instance, node);
+        }
+    }
+
+    return true;
+}
+
+bool tds_list_get(tds_list_t instance, uint32_t index, void* data) {
+    if (!instance || !data || index >= instance->size) {
+        return false;
+    }
+
+    uint32_t                offset;
+    struct tds_list_node_t* node = tds_list_locate(instance, index, &offset);
+    memcpy(data, tds_list_at(instance, node, offset), instance->elements);
+    TDS_STATS_ADD(instance, operations, 1);
+    return true;
+}
+
+int tds_list_find(tds_list_t instance, const void* data) {
+    if (!instance || !data) {
+        return -1;
+    }
+
+    uint32_t position = 0;
+    for (struct tds_list_node_t* node = instance->head; node; node = node->next) {
+        const uint8_t* element = node->data;
+        for (uint32_t i = 0; i < node->count; i++, element += instance->elements) {
+            if (memcmp(element, data, instance->elements) == 0) {
+                TDS_STATS_ADD(instance, operations, 1);
+                return (int) (position + i);
+            }
+        }
+        position += node->count;
+    }
+
+    // A completed search is an operation even when it finds nothing
+    TDS_STATS_ADD(instance, operations, 1);
+    return -1;
+}
+
+int tds_list_size(tds_list_t instance) {
+    if (!instance) {
+        return -1;
+    }
+    return (int) instance->size;
+}
+
+bool tds_list_empty(tds_list_t instance) {
+    return !instance || instance->size == 0;
+}
+
+bool tds_list_clear(tds_list_t instance) {
+    if (!instance) {
+        return false;
+    }
+
+    // Nodes from an allocator without free (arena) go away with the region
+    struct tds_list_node_t* node = instance->allocator.free ? instance->head : NULL;
+    while (node) {
+        struct tds_list_node_t* next = node->next;
+        tds_allocator_release(&instance->allocator, node);
+        node = next;
+    }
+
+    instance->head = NULL;
+    instance->tail = NULL;
+    instance->size = 0;
+    return true;
+}
+
+bool tds_list_get_stats(tds_list_t instance, tds_stats_t* stats) {
+    if (!instance || !stats) {
+        return false;
+    }
+
+    return TDS_STATS_READ(instance, stats);
+}
+
+bool tds_list_destroy(tds_list_t instance) {
+    if (!tds_list_clear(instance)) {
+        //printf("[ERROR] List not initialized");
+        return false;
+    }
+
+    if (!instance->is_static) {
+        TDS_FREE(instance);
+    }
+    return true;
+}
+
+tds_list_iterator_t tds_list_begin(tds_list_t instance) {
+    tds_list_iterator_t it = {NULL, 0, 0};
+    if (instance) {
+        it.node     = instance->head;
+        it.elements = instance->elements;
+    }
+    return it;
+}
+
+void* tds_list_next(tds_list_iterator_t* it) {
+    if (!it || !it->node) {
+        return NULL;
+    }
+
+    uint8_t* element = it->node->data + (size_t) it->index * it->elements;
+    if (++it->index == it->node->count) {
+        it->node  = it->node->next;
+        it->index = 0;
+    }
+    return element;
+}
+
+void* tds_list_next_span(tds_list_iterator_t* it, uint32_t* count) {
+    if (!it || !count || !it->node) {
+        return NULL;
+    }
+
+    uint8_t* span = it->node->data + (size_t) it->index * it->elements;
+    *count        = it->node->count - it->index;
+    it->node      = it->node->next;
+    it->index     = 0;
+    return span;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIST_C
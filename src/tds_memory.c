@@ -0,0 +1,889 @@
+/******************************************************************************
+ * File: tds_memory.c
+ * Author: Tiago Barbosa
+ * Description: Memory management helpers for embedded systems.
+ *              Provides the allocator interface used by the TDS containers,
+ *              a fixed-size block pool with O(1) allocation and release,
+ *              a bump-pointer arena released all at once and a thread-caching
+ *              block allocator (per-thread magazines over a shared depot).
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef MEMORY_C
+#define MEMORY_C
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include "tds_memory.h"
+
+#include <stdatomic.h>  // For the depot lock and the cache ids
+
+#include "tds_config.h"
+
+/* Typedefs -----------------------------------------------------------------*/
+
+/**
+ * @brief Structure representing a pool instance.
+ *
+ * Free blocks form a singly linked list threaded through the blocks
+ * themselves, so no bookkeeping memory is needed beyond this header.
+ */
+struct tds_pool_instance_t {
+    uint8_t* storage;     /**< First byte of the block area */
+    void*    free_list;   /**< Head of the free block list */
+    size_t   block_size;  /**< Size of each block after alignment */
+    uint32_t block_count; /**< Total number of blocks */
+    uint32_t available;   /**< Number of blocks in the free list */
+    bool     is_static;   /**< Lives in caller storage (tds_pool_init_static) */
+
+    TDS_STATS_FIELD
+};
+
+/**
+ * @brief Block of an arena. Blocks stay chained after a reset and are reused.
+ */
+struct tds_arena_block_t {
+    struct tds_arena_block_t*     next;
+    size_t                        size; /**< Usable bytes in data */
+    _Alignas(max_align_t) uint8_t data[];
+};
+
+/**
+ * @brief Structure representing an arena instance.
+ *
+ * Allocation advances cursor inside the current block; when it does not fit,
+ * the next chained block (or a new one) becomes current.
+ */
+struct tds_arena_instance_t {
+    struct tds_arena_block_t* first;      /**< Block used right after a reset */
+    struct tds_arena_block_t* current;    /**< Block being carved */
+    uint8_t*                  cursor;     /**< Next free byte of current */
+    uint8_t*                  limit;      /**< End of current */
+    size_t                    block_size; /**< Minimum size of a new block */
+    size_t                    used;       /**< Bytes handed out since the last reset */
+    bool                      is_static;  /**< Lives in caller storage and never grows (tds_arena_init_static) */
+
+    TDS_STATS_FIELD
+};
+
+/**
+ * @brief Stack of free blocks owned by one thread, or parked in the depot.
+ */
+struct tds_cache_magazine_t {
+    struct tds_cache_magazine_t* next;  /**< Depot list link */
+    uint32_t                     count; /**< Blocks held in rounds */
+    void*                        rounds[];
+};
+
+/**
+ * @brief Magazines of one thread for one cache. Records are linked in the
+ * cache and found again through the thread-local slots.
+ */
+struct tds_cache_local_t {
+    struct tds_cache_local_t*    next;
+    const void*                  owner;    /**< Thread token: address of the thread's tds_cache_slots */
+    struct tds_cache_magazine_t* loaded;   /**< Magazine allocations and frees go to first */
+    struct tds_cache_magazine_t* previous; /**< Second magazine, swapped in before going to the depot */
+};
+
+/**
+ * @brief Slab of blocks taken from the system, freed at destroy.
+ */
+struct tds_cache_slab_t {
+    struct tds_cache_slab_t* next;
+};
+
+/**
+ * @brief Structure representing a block cache instance.
+ *
+ * The fast paths only touch the calling thread's record and the read-only
+ * fields. Everything below the padding is the depot, guarded by lock.
+ */
+struct tds_cache_instance_t {
+    /* Read-only after creation */
+    uint64_t id;            /**< Unique for the process lifetime, keys the thread-local slots */
+    size_t   block_size;    /**< Size of each block after alignment */
+    uint32_t magazine_size; /**< Capacity of a magazine */
+    uint32_t slab_blocks;   /**< Blocks per slab */
+    uint8_t  pad0[TDS_CACHE_LINE_SIZE];
+
+    /* Depot */
+    _Atomic uint32_t             lock;
+    struct tds_cache_magazine_t* full;   /**< Magazines holding blocks */
+    struct tds_cache_magazine_t* empty;  /**< Spare empty magazines */
+    struct tds_cache_local_t*    locals; /**< One record per thread that used the cache */
+    struct tds_cache_slab_t*     slabs;
+    uint8_t*                     carve;      /**< Next unused block of the newest slab */
+    uint32_t                     carve_left; /**< Unused blocks left in the newest slab */
+    void*                        loose;      /**< Blocks freed while no magazine could be allocated */
+
+    TDS_STATS_FIELD
+};
+
+/**
+ * @brief Thread-local lookup slot: the record of this thread for cache id.
+ */
+struct tds_cache_slot_t {
+    uint64_t                  id;
+    struct tds_cache_local_t* local;
+};
+
+_Static_assert(sizeof(struct tds_pool_instance_t) <= TDS_POOL_INSTANCE_SIZE, "TDS_POOL_INSTANCE_SIZE too small");
+_Static_assert(sizeof(struct tds_arena_instance_t) <= TDS_ARENA_INSTANCE_SIZE, "TDS_ARENA_INSTANCE_SIZE too small");
+_Static_assert(sizeof(struct tds_arena_block_t) <= TDS_MEMORY_ROUND(2 * sizeof(size_t)), "TDS_ARENA_STORAGE_SIZE too small");
+
+/* Private Variables --------------------------------------------------------*/
+
+static _Atomic uint64_t                      tds_cache_next_id = 1;
+static _Thread_local struct tds_cache_slot_t tds_cache_slots[TDS_CACHE_THREAD_SLOTS];
+
+_Static_assert((TDS_CACHE_THREAD_SLOTS & (TDS_CACHE_THREAD_SLOTS - 1)) == 0, "TDS_CACHE_THREAD_SLOTS must be a power of two");
+
+/* Private Functions --------------------------------------------------------*/
+
+static void* tds_default_alloc(void* context, size_t size) {
+    (void) context;
+    return TDS_MALLOC(size);
+}
+
+static void tds_default_free(void* context, void* ptr) {
+    (void) context;
+    TDS_FREE(ptr);
+}
+
+static void* tds_pool_allocator_alloc(void* context, size_t size) {
+    tds_pool_t pool = (tds_pool_t) context;
+    if (!pool || size > pool->block_size) {
+        //printf("[ERROR] Request of %zu bytes exceeds the pool block size.\n", size);
+        return NULL;
+    }
+    return tds_pool_alloc(pool);
+}
+
+static void tds_pool_allocator_free(void* context, void* ptr) {
+    tds_pool_free((tds_pool_t) context, ptr);
+}
+
+static void* tds_arena_allocator_alloc(void* context, size_t size) {
+    return tds_arena_alloc((tds_arena_t) context, size);
+}
+
+static struct tds_arena_block_t* tds_arena_block_new(tds_arena_t arena, size_t size) {
+    (void) arena;  // Only read by the statistics
+    if (size > SIZE_MAX - sizeof(struct tds_arena_block_t)) {
+        return NULL;
+    }
+
+    struct tds_arena_block_t* block = (struct tds_arena_block_t*) TDS_MALLOC(sizeof(struct tds_arena_block_t) + size);
+    if (!block) {
+        //printf("[ERROR] Failed to allocate an arena block of %zu bytes.\n", size);
+        return NULL;
+    }
+    TDS_STATS_ALLOC(arena, sizeof(struct tds_arena_block_t) + size);
+
+    block->next = NULL;
+    block->size = size;
+    return block;
+}
+
+static inline void tds_arena_enter(tds_arena_t arena, struct tds_arena_block_t* block) {
+    arena->current = block;
+    arena->cursor  = block->data;
+    arena->limit   = block->data + block->size;
+}
+
+/**
+ * @brief Slow path of tds_arena_alloc: moves to a block with room for size bytes.
+ *
+ * Chained blocks too small for the request are skipped until the next reset;
+ * a new block is linked right after the current one when none fits.
+ */
+static void* tds_arena_refill(tds_arena_t arena, size_t size) {
+    struct tds_arena_block_t* block = arena->current->next;
+    while (block && block->size < size) {
+        block = block->next;
+    }
+
+    if (!block && !arena->is_static) {
+        block = tds_arena_block_new(arena, size > arena->block_size ? size : arena->block_size);
+        if (block) {
+            block->next          = arena->current->next;
+            arena->current->next = block;
+        }
+    }
+
+    if (!block) {
+        TDS_STATS_ADD(arena, failed_full, 1);
+        return NULL;
+    }
+
+    tds_arena_enter(arena, block);
+    void* ptr      = arena->cursor;
+    arena->cursor += size;
+    return ptr;
+}
+
+/**
+ * @brief Rounds the block size of a pool and checks that header plus blocks fit in size_t.
+ *
+ * @return Total bytes of the pool, or 0 if the parameters are invalid.
+ */
+static size_t tds_pool_layout(size_t* block_size, uint32_t block_count, size_t header) {
+    if (*block_size == 0 || block_count == 0) {
+        //printf("[ERROR] Invalid pool parameters!\n");
+        return 0;
+    }
+
+    if (*block_size < sizeof(void*)) {
+        *block_size = sizeof(void*);
+    }
+    if (*block_size > SIZE_MAX - TDS_MEMORY_ALIGN) {
+        return 0;
+    }
+    *block_size = TDS_MEMORY_ROUND(*block_size);
+
+    if (*block_size > (SIZE_MAX - header) / block_count) {
+        //printf("[ERROR] Pool size overflows size_t.\n");
+        return 0;
+    }
+    return header + *block_size * block_count;
+}
+
+static void tds_pool_init(tds_pool_t pool, size_t header, size_t block_size, uint32_t block_count, bool is_static) {
+    pool->storage     = (uint8_t*) pool + header;
+    pool->block_size  = block_size;
+    pool->block_count = block_count;
+    pool->available   = block_count;
+    pool->is_static   = is_static;
+    TDS_STATS_INIT(pool);
+
+    // Thread the free list through the blocks in address order
+    for (uint32_t i = 0; i < block_count - 1; i++) {
+        *(void**) (pool->storage + i * block_size) = pool->storage + (i + 1) * block_size;
+    }
+    *(void**) (pool->storage + (size_t) (block_count - 1) * block_size) = NULL;
+    pool->free_list = pool->storage;
+}
+
+static void* tds_cache_allocator_alloc(void* context, size_t size) {
+    tds_cache_t cache = (tds_cache_t) context;
+    if (!cache || size > cache->block_size) {
+        //printf("[ERROR] Request of %zu bytes exceeds the cache block size.\n", size);
+        return NULL;
+    }
+    return tds_cache_alloc(cache);
+}
+
+static void tds_cache_allocator_free(void* context, void* ptr) {
+    tds_cache_free((tds_cache_t) context, ptr);
+}
+
+static inline void tds_cache_lock(tds_cache_t cache) {
+    for (;;) {
+        if (!atomic_exchange_explicit(&cache->lock, 1, memory_order_acquire)) {
+            return;
+        }
+        TDS_STATS_ADD(cache, retries, 1);
+        while (atomic_load_explicit(&cache->lock, memory_order_relaxed)) {
+            TDS_CPU_RELAX();
+        }
+    }
+}
+
+static inline void tds_cache_unlock(tds_cache_t cache) {
+    atomic_store_explicit(&cache->lock, 0, memory_order_release);
+}
+
+/**
+ * @brief Depot (locked): an empty magazine, reused or newly allocated.
+ */
+static struct tds_cache_magazine_t* tds_cache_magazine_get(tds_cache_t cache) {
+    struct tds_cache_magazine_t* m = cache->empty;
+    if (m) {
+        cache->empty = m->next;
+        return m;
+    }
+
+    size_t size = sizeof(struct tds_cache_magazine_t) + (size_t) cache->magazine_size * sizeof(void*);
+    m           = (struct tds_cache_magazine_t*) TDS_MALLOC(size);
+    if (!m) {
+        //printf("[ERROR] Failed to allocate a cache magazine.\n");
+        return NULL;
+    }
+    TDS_STATS_ALLOC(cache, size);
+    m->count = 0;
+    return m;
+}
+
+/**
+ * @brief Depot (locked): parks a magazine on the full list if it holds blocks, on the empty list otherwise.
+ */
+static void tds_cache_magazine_put(tds_cache_t cache, struct tds_cache_magazine_t* m) {
+    if (!m) {
+        return;
+    }
+    if (m->count) {
+        m->next     = cache->full;
+        cache->full = m;
+    } else {
+        m->next      = cache->empty;
+        cache->empty = m;
+    }
+}
+
+/**
+ * @brief Depot (locked): a block never handed out before, from a loose block or a slab.
+ */
+static void* tds_cache_carve(tds_cache_t cache) {
+    if (cache->loose) {
+        void* block  = cache->loose;
+        cache->loose = *(void**) block;
+        return block;
+    }
+
+    if (cache->carve_left == 0) {
+        size_t                   header = TDS_MEMORY_ROUND(sizeof(struct tds_cache_slab_t));
+        size_t                   size   = header + cache->block_size * cache->slab_blocks;
+        struct tds_cache_slab_t* slab   = (struct tds_cache_slab_t*) TDS_MALLOC(size);
+        if (!slab) {
+            //printf("[ERROR] Failed to allocate a cache slab.\n");
+            return NULL;
+        }
+        TDS_STATS_ALLOC(cache, size);
+        slab->next        = cache->slabs;
+        cache->slabs      = slab;
+        cache->carve      = (uint8_t*) slab + header;
+        cache->carve_left = cache->slab_blocks;
+    }
+
+    void* block    = cache->carve;
+    cache->carve  += cache->block_size;
+    cache->carve_left--;
+    TDS_STATS_ADD(cache, high_water, 1);
+    return block;
+}
+
+/**
+ * @brief Finds (or creates) the record of the calling thread and caches it in its slot.
+ */
+static struct tds_cache_local_t* tds_cache_bind(tds_cache_t cache, struct tds_cache_slot_t* slot) {
+    const void* owner = tds_cache_slots;
+
+    tds_cache_lock(cache);
+    struct tds_cache_local_t* local = cache->locals;
+    while (local && local->owner != owner) {
+        local = local->next;
+    }
+    if (!local) {
+        local = (struct tds_cache_local_t*) TDS_MALLOC(sizeof(struct tds_cache_local_t));
+        if (local) {
+            TDS_STATS_ALLOC(cache, sizeof(struct tds_cache_local_t));
+            local->owner    = owner;
+            local->loaded   = NULL;
+            local->previous = NULL;
+            local->next     = cache->locals;
+            cache->locals   = local;
+        }
+    }
+    tds_cache_unlock(cache);
+
+    if (local) {
+        slot->id    = cache->id;
+        slot->local = local;
+    }
+    return local;
+}
+
+/**
+ * @brief Record of the calling thread: one thread-local load in the common case.
+ *
+ * Ids are never reused, so a slot left over by a destroyed cache can never
+ * match and its record is never dereferenced.
+ */
+static inline struct tds_cache_local_t* tds_cache_local(tds_cache_t cache) {
+    struct tds_cache_slot_t* slot = &tds_cache_slots[cache->id & (TDS_CACHE_THREAD_SLOTS - 1)];
+    if (slot->id == cache->id) {
+        return slot->local;
+    }
+    return tds_cache_bind(cache, slot);
+}
+
+static void* tds_cache_alloc_slow(tds_cache_t cache, struct tds_cache_local_t* local) {
+    struct tds_cache_magazine_t* m = local->previous;
+    if (m && m->count) {
+        local->previous = local->loaded;
+        local->loaded   = m;
+        return m->rounds[--m->count];
+    }
+
+    // Both magazines empty: trade the spare one for a full magazine of the depot
+    tds_cache_lock(cache);
+    m = cache->full;
+    if (m) {
+        cache->full = m->next;
+        tds_cache_magazine_put(cache, local->previous);
+        local->previous = local->loaded;
+        local->loaded   = m;
+        tds_cache_unlock(cache);
+        return m->rounds[--m->count];
+    }
+
+    // Depot empty too: fill the loaded magazine with fresh blocks in one go
+    if (!local->loaded) {
+        local->loaded = tds_cache_magazine_get(cache);
+    }
+    m = local->loaded;
+    if (!m) {
+        void* block = tds_cache_carve(cache);
+        tds_cache_unlock(cache);
+        return block;
+    }
+    while (m->count < cache->magazine_size) {
+        void* block = tds_cache_carve(cache);
+        if (!block) {
+            break;
+        }
+        m->rounds[m->count++] = block;
+    }
+    tds_cache_unlock(cache);
+    return m->count ? m->rounds[--m->count] : NULL;
+}
+
+static void tds_cache_free_slow(tds_cache_t cache, struct tds_cache_local_t* local, void* block) {
+    struct tds_cache_magazine_t* m = local->previous;
+    if (m && m->count == 0) {
+        local->previous       = local->loaded;
+        local->loaded         = m;
+        m->rounds[m->count++] = block;
+        return;
+    }
+
+    // Both magazines full: park the spare one in the depot and start an empty one
+    tds_cache_lock(cache);
+    tds_cache_magazine_put(cache, local->previous);
+    local->previous = local->loaded;
+    local->loaded   = tds_cache_magazine_get(cache);
+    m               = local->loaded;
+    if (!m) {
+        *(void**) block = cache->loose;
+        cache->loose    = block;
+        tds_cache_unlock(cache);
+        return;
+    }
+    tds_cache_unlock(cache);
+    m->rounds[m->count++] = block;
+}
+
+/* Public Functions ---------------------------------------------------------*/
+
+const tds_allocator_t* tds_allocator_default(void) {
+    static const tds_allocator_t allocator = {
+        .alloc   = tds_default_alloc,
+        .free    = tds_default_free,
+        .context = NULL,
+    };
+    return &allocator;
+}
+
+tds_pool_t tds_pool_create(size_t block_size, uint32_t block_count) {
+    size_t header = TDS_MEMORY_ROUND(sizeof(struct tds_pool_instance_t));
+    size_t total  = tds_pool_layout(&block_size, block_count, header);
+    if (!total) {
+        return NULL;
+    }
+
+    tds_pool_t pool = (tds_pool_t) TDS_MALLOC(total);
+    if (!pool) {
+        //printf("[ERROR] Failed to allocate memory for the pool.\n");
+        return NULL;
+    }
+
+    tds_pool_init(pool, header, block_size, block_count, false);
+    TDS_STATS_ALLOC(pool, total);
+    return pool;
+}
+
+tds_pool_t tds_pool_init_static(void* storage, size_t storage_size, size_t block_size, uint32_t block_count) {
+    size_t header = TDS_MEMORY_ROUND(TDS_POOL_INSTANCE_SIZE);
+    size_t total  = tds_pool_layout(&block_size, block_count, header);
+    if (!storage || (uintptr_t) storage % _Alignof(max_align_t) != 0 || !total || total > storage_size) {
+        //printf("[ERROR] Pool storage is misaligned or too small!\n");
+        return NULL;
+    }
+
+    tds_pool_t pool = (tds_pool_t) storage;
+    tds_pool_init(pool, header, block_size, block_count, true);
+    return pool;
+}
+
+void* tds_pool_alloc(tds_pool_t pool) {
+    if (!pool) {
+        return NULL;
+    }
+
+    if (!pool->free_list) {
+        TDS_STATS_ADD(pool, failed_empty, 1);
+        return NULL;
+    }
+
+    void* block     = pool->free_list;
+    pool->free_list = *(void**) block;
+    pool->available--;
+    TDS_STATS_ADD(pool, operations, 1);
+    TDS_STATS_MAX(pool, high_water, pool->block_count - pool->available);
+    return block;
+}
+
+bool tds_pool_free(tds_pool_t pool, void* block) {
+    if (!pool || !block) {
+        return false;
+    }
+
+    uint8_t* ptr = (uint8_t*) block;
+    if (ptr < pool->storage || ptr >= pool->storage + pool->block_size * pool->block_count ||
+        (size_t) (ptr - pool->storage) % pool->block_size != 0) {
+        //printf("[ERROR] Block %p does not belong to the pool.\n", block);
+        return false;
+    }
+
+    *(void**) block = pool->free_list;
+    pool->free_list = block;
+    pool->available++;
+    TDS_STATS_ADD(pool, operations, 1);
+    return true;
+}
+
+int tds_pool_available(tds_pool_t pool) {
+    if (!pool) {
+        return -1;
+    }
+    return pool->available;
+}
+
+size_t tds_pool_block_size(tds_pool_t pool) {
+    if (!pool) {
+        return 0;
+    }
+    return pool->block_size;
+}
+
+tds_allocator_t tds_pool_allocator(tds_pool_t pool) {
+    tds_allocator_t allocator = {
+        .alloc   = tds_pool_allocator_alloc,
+        .free    = tds_pool_allocator_free,
+        .context = pool,
+    };
+    return allocator;
+}
+
+bool tds_pool_get_stats(tds_pool_t pool, tds_stats_t* stats) {
+    if (!pool || !stats) {
+        return false;
+    }
+
+    return TDS_STATS_READ(pool, stats);
+}
+
+bool tds_pool_destroy(tds_pool_t pool) {
+    if (!pool) {
+        return false;
+    }
+    if (!pool->is_static) {
+        TDS_FREE(pool);
+    }
+    return true;
+}
+
+tds_arena_t tds_arena_create(size_t block_size) {
+    if (block_size == 0 || block_size > SIZE_MAX - TDS_MEMORY_ALIGN) {
+        //printf("[ERROR] Invalid arena block size!\n");
+        return NULL;
+    }
+
+    tds_arena_t arena = (tds_arena_t) TDS_MALLOC(sizeof(struct tds_arena_instance_t));
+    if (!arena) {
+        //printf("[ERROR] Failed to allocate memory for the arena.\n");
+        return NULL;
+    }
+    TDS_STATS_INIT(arena);
+
+    arena->block_size = TDS_MEMORY_ROUND(block_size);
+    arena->used       = 0;
+    arena->is_static  = false;
+    arena->first      = tds_arena_block_new(arena, arena->block_size);
+    if (!arena->first) {
+        TDS_FREE(arena);
+        return NULL;
+    }
+    tds_arena_enter(arena, arena->first);
+
+    return arena;
+}
+
+tds_arena_t tds_arena_init_static(void* storage, size_t storage_size) {
+    size_t header = TDS_MEMORY_ROUND(TDS_ARENA_INSTANCE_SIZE);
+    if (!storage || (uintptr_t) storage % _Alignof(max_align_t) != 0 || storage_size <= header + sizeof(struct tds_arena_block_t)) {
+        //printf("[ERROR] Arena storage is misaligned or too small!\n");
+        return NULL;
+    }
+
+    tds_arena_t               arena = (tds_arena_t) storage;
+    struct tds_arena_block_t* block = (struct tds_arena_block_t*) ((uint8_t*) storage + header);
+    TDS_STATS_INIT(arena);
+
+    block->next       = NULL;
+    block->size       = storage_size - header - sizeof(struct tds_arena_block_t);
+    arena->first      = block;
+    arena->block_size = 0;
+    arena->used       = 0;
+    arena->is_static  = true;
+    tds_arena_enter(arena, block);
+
+    return arena;
+}
+
+void* tds_arena_alloc(tds_arena_t arena, size_t size) {
+    if (!arena || size == 0 || size > SIZE_MAX - TDS_MEMORY_ALIGN) {
+        return NULL;
+    }
+
+    size = (size + TDS_MEMORY_ALIGN - 1) & ~(TDS_MEMORY_ALIGN - 1);
+
+    void* ptr;
+    if ((size_t) (arena->limit - arena->cursor) >= size) {
+        ptr            = arena->cursor;
+        arena->cursor += size;
+    } else {
+        ptr = tds_arena_refill(arena, size);
+        if (!ptr) {
+            return NULL;
+        }
+    }
+
+    arena->used += size;
+    TDS_STATS_ADD(arena, operations, 1);
+    TDS_STATS_MAX(arena, high_water, arena->used);
+    return ptr;
+}
+
+bool tds_arena_reset(tds_arena_t arena) {
+    if (!arena) {
+        return false;
+    }
+
+    tds_arena_enter(arena, arena->first);
+    arena->used = 0;
+    return true;
+}
+
+size_t tds_arena_used(tds_arena_t arena) {
+    if (!arena) {
+        return 0;
+    }
+    return arena->used;
+}
+
+tds_allocator_t tds_arena_allocator(tds_arena_t arena) {
+    tds_allocator_t allocator = {
+        .alloc   = tds_arena_allocator_alloc,
+        .free    = NULL,
+        .context = arena,
+    };
+    return allocator;
+}
+
+bool tds_arena_get_stats(tds_arena_t arena, tds_stats_t* stats) {
+    if (!arena || !stats) {
+        return false;
+    }
+
+    return TDS_STATS_READ(arena, stats);
+}
+
+bool tds_arena_destroy(tds_arena_t arena) {
+    if (!arena) {
+        return false;
+    }
+
+    // A static arena owns no heap memory: its single block lives in the storage
+    struct tds_arena_block_t* block = arena->is_static ? NULL : arena->first;
+    while (block) {
+        struct tds_arena_block_t* next = block->next;
+        TDS_FREE(block);
+        block = next;
+    }
+    if (!arena->is_static) {
+        TDS_FREE(arena);
+    }
+    return true;
+}
+
+tds_cache_t tds_cache_create(size_t block_size, uint32_t magazine_size) {
+    if (magazine_size == 0) {
+        magazine_size = TDS_CACHE_MAGAZINE_SIZE;
+    }
+    if (magazine_size > UINT32_MAX / 4) {
+        //printf("[ERROR] Invalid cache magazine size!\n");
+        return NULL;
+    }
+
+    // Reuse the pool rounding and overflow checks for one slab
+    size_t header = TDS_MEMORY_ROUND(sizeof(struct tds_cache_slab_t));
+    if (!tds_pool_layout(&block_size, 4 * magazine_size, header)) {
+        return NULL;
+    }
+
+    tds_cache_t cache = (tds_cache_t) TDS_MALLOC(sizeof(struct tds_cache_instance_t));
+    if (!cache) {
+        //printf("[ERROR] Failed to allocate memory for the cache.\n");
+        return NULL;
+    }
+    TDS_STATS_INIT(cache);
+
+    cache->id            = atomic_fetch_add_explicit(&tds_cache_next_id, 1, memory_order_relaxed);
+    cache->block_size    = block_size;
+    cache->magazine_size = magazine_size;
+    cache->slab_blocks   = 4 * magazine_size;
+    cache->full          = NULL;
+    cache->empty         = NULL;
+    cache->locals        = NULL;
+    cache->slabs         = NULL;
+    cache->carve         = NULL;
+    cache->carve_left    = 0;
+    cache->loose         = NULL;
+    atomic_init(&cache->lock, 0);
+    return cache;
+}
+
+void* tds_cache_alloc(tds_cache_t cache) {
+    if (!cache) {
+        return NULL;
+    }
+
+    struct tds_cache_local_t* local = tds_cache_local(cache);
+    void*                     block;
+    if (local && local->loaded && local->loaded->count) {
+        block = local->loaded->rounds[--local->loaded->count];
+    } else if (local) {
+        block = tds_cache_alloc_slow(cache, local);
+    } else {
+        tds_cache_lock(cache);
+        block = tds_cache_carve(cache);
+        tds_cache_unlock(cache);
+    }
+
+    if (!block) {
+        TDS_STATS_ADD(cache, failed_empty, 1);
+        return NULL;
+    }
+    TDS_STATS_ADD(cache, operations, 1);
+    return block;
+}
+
+bool tds_cache_free(tds_cache_t cache, void* block) {
+    if (!cache || !block) {
+        return false;
+    }
+
+    struct tds_cache_local_t* local = tds_cache_local(cache);
+    if (local && local->loaded && local->loaded->count < cache->magazine_size) {
+        local->loaded->rounds[local->loaded->count++] = block;
+    } else if (local) {
+        tds_cache_free_slow(cache, local, block);
+    } else {
+        tds_cache_lock(cache);
+        *(void**) block = cache->loose;
+        cache->loose    = block;
+        tds_cache_unlock(cache);
+    }
+
+    TDS_STATS_ADD(cache, operations, 1);
+    return true;
+}
+
+bool tds_cache_flush(tds_cache_t cache) {
+    if (!cache) {
+        return false;
+    }
+
+    struct tds_cache_local_t* local = tds_cache_local(cache);
+    if (!local) {
+        return true;
+    }
+
+    tds_cache_lock(cache);
+    tds_cache_magazine_put(cache, local->loaded);
+    tds_cache_magazine_put(cache, local->previous);
+    local->loaded   = NULL;
+    local->previous = NULL;
+    tds_cache_unlock(cache);
+    return true;
+}
+
+size_t tds_cache_block_size(tds_cache_t cache) {
+    if (!cache) {
+        return 0;
+    }
+    return cache->block_size;
+}
+
+tds_allocator_t tds_cache_allocator(tds_cache_t cache) {
+    tds_allocator_t allocator = {
+        .alloc   = tds_cache_allocator_alloc,
+        .free    = tds_cache_allocator_free,
+        .context = cache,
+    };
+    return allocator;
+}
+
+bool tds_cache_get_stats(tds_cache_t cache, tds_stats_t* stats) {
+    if (!cache || !stats) {
+        return false;
+    }
+
+    return TDS_STATS_READ(cache, stats);
+}
+
+bool tds_cache_destroy(tds_cache_t cache) {
+    if (!cache) {
+        return false;
+    }
+
+    struct tds_cache_local_t* local = cache->locals;
+    while (local) {
+        struct tds_cache_local_t* next = local->next;
+        TDS_FREE(local->loaded);
+        TDS_FREE(local->previous);
+        TDS_FREE(local);
+        local = next;
+    }
+
+    struct tds_cache_magazine_t* lists[2] = {cache->full, cache->empty};
+    for (int i = 0; i < 2; i++) {
+        struct tds_cache_magazine_t* m = lists[i];
+        while (m) {
+            struct tds_cache_magazine_t* next = m->next;
+            TDS_FREE(m);
+            m = next;
+        }
+    }
+
+    struct tds_cache_slab_t* slab = cache->slabs;
+    while (slab) {
+        struct tds_cache_slab_t* next = slab->next;
+        TDS_FREE(slab);
+        slab = next;
+    }
+    TDS_FREE(cache);
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MEMORY_C
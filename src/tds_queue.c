@@ -11,6 +11,10 @@
 #ifndef QUEUE_C
 #define QUEUE_C
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  // For syscall() and clock_gettime() under -std=c11
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -18,57 +22,588 @@ extern "C" {
 /* Includes -----------------------------------------------------------------*/
 #include "tds_queue.h"
 
+#include <stdatomic.h>  // For the MPMC positions and slot sequences
+
+#include "tds_config.h"
+#include "tds_snapshot_internal.h"
+
+#if TDS_QUEUE_BLOCKING
+#include <time.h>  // For the wait deadlines
+#if TDS_QUEUE_BLOCKING == 2
+#include <pthread.h>
+#else
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
 /* Defines ------------------------------------------------------------------*/
+#define TDS_QUEUE_MPMC_MAX_CAPACITY (UINT32_C(1) << 30)
+
+/*
+ * A parked thread registers in waiting and then re-reads the positions, while
+ * the thread that claims a position reads waiting afterwards. Both sides must
+ * be sequentially consistent for one of them to see the other, so the claim
+ * CAS is seq_cst whenever the blocking functions are built in.
+ */
+#if TDS_QUEUE_BLOCKING
+#define TDS_QUEUE_CLAIM_ORDER       memory_order_seq_cst
+#define TDS_QUEUE_WAKE(inst, w, n)  tds_queue_wake((inst), &(inst)->w, (n))
+#else
+#define TDS_QUEUE_CLAIM_ORDER       memory_order_relaxed
+#define TDS_QUEUE_WAKE(inst, w, n)  ((void) 0)
+#endif
 
 /* Typedefs -----------------------------------------------------------------*/
 
+#if TDS_QUEUE_BLOCKING
+/**
+ * @brief Threads parked on one condition (not empty / not full) of a queue.
+ *
+ * event changes on every wake, so a thread that read it before registering
+ * and finds it changed does not go to sleep (futex word).
+ */
+struct tds_queue_waiters_t {
+    _Atomic uint32_t event;   /**< Bumped by every wake */
+    _Atomic uint32_t waiting; /**< Threads registered to be woken */
+#if TDS_QUEUE_BLOCKING == 2
+    pthread_cond_t cond;
+#endif
+};
+#endif
+
 /* Function Prototypes ------------------------------------------------------*/
 
 struct tds_queue_instance_t {
-    struct tds_queue_node_t* head;
-    struct tds_queue_node_t* tail;
+    tds_queue_mode_t         mode;
+    struct tds_queue_node_t* head;      /**< Linked mode: oldest node */
+    struct tds_queue_node_t* tail;      /**< Linked mode: newest node */
+    tds_allocator_t          allocator; /**< Linked mode: node allocator */
+    uint8_t*                 buffer;    /**< Ring mode: capacity * elements bytes */
+    uint32_t                 read;      /**< Ring mode: slot of the oldest element */
+    uint32_t                 write;     /**< Ring mode: slot of the next enqueue */
+    uint32_t                 reserved;  /**< Ring mode: slots granted by the pending reserve */
+    uint32_t                 mask;      /**< MPMC mode: capacity - 1 */
+    uint32_t                 stride;    /**< MPMC mode: bytes per cell (sequence + element) */
     uint32_t                 capacity;
     uint32_t                 elements;
     uint32_t                 size;
+    bool                     is_static; /**< Instance and storage live in caller memory (tds_queue_init_static) */
+
+    /* MPMC mode: each position counter owns a cache line */
+    uint8_t          pad0[TDS_CACHE_LINE_SIZE];
+    _Atomic uint32_t enqueue_pos;
+    uint8_t          pad1[TDS_CACHE_LINE_SIZE - sizeof(uint32_t)];
+    _Atomic uint32_t dequeue_pos;
+    uint8_t          pad2[TDS_CACHE_LINE_SIZE - sizeof(uint32_t)];
+
+#if TDS_QUEUE_BLOCKING
+    /* MPMC mode: parked callers of the *_wait functions, read-mostly */
+    struct tds_queue_waiters_t not_empty; /**< Consumers waiting for an element */
+    struct tds_queue_waiters_t not_full;  /**< Producers waiting for a free slot */
+#if TDS_QUEUE_BLOCKING == 2
+    pthread_mutex_t wait_lock; /**< Guards both events against lost wakeups */
+#endif
+#endif
+
+    TDS_STATS_FIELD
 };
 
+/**
+ * @brief MPMC slot. sequence == pos means free for the producer of pos,
+ * sequence == pos + 1 means filled for the consumer of pos.
+ */
+struct tds_queue_cell_t {
+    _Atomic uint32_t sequence;
+    uint8_t          data[];
+};
+
+_Static_assert(sizeof(struct tds_queue_instance_t) <= TDS_QUEUE_INSTANCE_SIZE, "TDS_QUEUE_INSTANCE_SIZE too small");
+_Static_assert(sizeof(struct tds_queue_cell_t) == 4 && _Alignof(struct tds_queue_cell_t) == 4, "TDS_QUEUE_MPMC_STORAGE_SIZE assumes 4-byte cell headers");
+
 struct tds_queue_node_t {
-    void*                    data;
-    struct tds_queue_node_t* next;
+    struct tds_queue_node_t*      next;
+    _Alignas(max_align_t) uint8_t data[]; /**< Element stored inline, one allocation per node */
 };
 
-tds_queue_t tds_queue_create(uint32_t capacity, size_t element_size) {
-    if (capacity == 0 || element_size == 0) {
+size_t tds_queue_node_size(size_t element_size) {
+    return sizeof(struct tds_queue_node_t) + element_size;
+}
+
+static inline struct tds_queue_cell_t* tds_queue_cell(tds_queue_t instance, uint32_t pos) {
+    return (struct tds_queue_cell_t*) (instance->buffer + (size_t) (pos & instance->mask) * instance->stride);
+}
+
+#if TDS_QUEUE_BLOCKING
+static uint64_t tds_queue_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+/**
+ * @brief Sleeps while w->event still equals key, at most timeout_ns (0 = no limit).
+ */
+static void tds_queue_park(tds_queue_t instance, struct tds_queue_waiters_t* w, uint32_t key, uint64_t timeout_ns) {
+#if TDS_QUEUE_BLOCKING == 2
+    pthread_mutex_lock(&instance->wait_lock);
+    if (atomic_load_explicit(&w->event, memory_order_relaxed) == key) {
+        if (timeout_ns) {
+            // Condition variables time out on the realtime clock
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            uint64_t nsec     = (uint64_t) deadline.tv_nsec + timeout_ns;
+            deadline.tv_sec  += (time_t) (nsec / 1000000000u);
+            deadline.tv_nsec  = (long) (nsec % 1000000000u);
+            pthread_cond_timedwait(&w->cond, &instance->wait_lock, &deadline);
+        } else {
+            pthread_cond_wait(&w->cond, &instance->wait_lock);
+        }
+    }
+    pthread_mutex_unlock(&instance->wait_lock);
+#else
+    (void) instance;
+    struct timespec relative = {(time_t) (timeout_ns / 1000000000u), (long) (timeout_ns % 1000000000u)};
+    // Returns at once if event already moved on; spurious returns are handled by the caller
+    syscall(SYS_futex, (uint32_t*) &w->event, FUTEX_WAIT_PRIVATE, key, timeout_ns ? &relative : NULL, NULL, 0);
+#endif
+}
+
+/**
+ * @brief Wakes up to count threads parked on w. Only called with waiters present.
+ */
+static void tds_queue_unpark(tds_queue_t instance, struct tds_queue_waiters_t* w, uint32_t count) {
+#if TDS_QUEUE_BLOCKING == 2
+    pthread_mutex_lock(&instance->wait_lock);
+    atomic_fetch_add_explicit(&w->event, 1, memory_order_relaxed);
+    if (count == 1) {
+        pthread_cond_signal(&w->cond);
+    } else {
+        pthread_cond_broadcast(&w->cond);
+    }
+    pthread_mutex_unlock(&instance->wait_lock);
+#else
+    (void) instance;
+    atomic_fetch_add_explicit(&w->event, 1, memory_order_release);
+    syscall(SYS_futex, (uint32_t*) &w->event, FUTEX_WAKE_PRIVATE, count > INT32_MAX ? INT32_MAX : (int) count, NULL, NULL, 0);
+#endif
+}
+
+/**
+ * @brief Called after a position was claimed and published: wakes the other
+ * side only if somebody is parked, so the common path costs one load.
+ */
+static inline void tds_queue_wake(tds_queue_t instance, struct tds_queue_waiters_t* w, uint32_t count) {
+    if (atomic_load_explicit(&w->waiting, memory_order_seq_cst) != 0) {
+        tds_queue_unpark(instance, w, count);
+    }
+}
+#endif
+
+static uint32_t tds_queue_mpmc_size(tds_queue_t instance) {
+    uint32_t dequeue_pos = atomic_load_explicit(&instance->dequeue_pos, memory_order_acquire);
+    uint32_t enqueue_pos = atomic_load_explicit(&instance->enqueue_pos, memory_order_acquire);
+    int32_t  size        = (int32_t) (enqueue_pos - dequeue_pos);
+    return size < 0 ? 0 : (uint32_t) size;
+}
+
+static bool tds_queue_mpmc_enqueue(tds_queue_t instance, const void* data) {
+    uint32_t pos = atomic_load_explicit(&instance->enqueue_pos, memory_order_relaxed);
+
+    for (;;) {
+        struct tds_queue_cell_t* cell = tds_queue_cell(instance, pos);
+        uint32_t                 seq  = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        int32_t                  diff = (int32_t) (seq - pos);
+
+        if (diff == 0) {
+            // Slot is free for this lap; claim it (pos is reloaded on failure)
+            if (atomic_compare_exchange_weak_explicit(&instance->enqueue_pos, &pos, pos + 1, TDS_QUEUE_CLAIM_ORDER, memory_order_relaxed)) {
+                memcpy(cell->data, data, instance->elements);
+                atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+                TDS_QUEUE_WAKE(instance, not_empty, 1);
+                TDS_STATS_ADD(instance, operations, 1);
+                TDS_STATS_MAX(instance, high_water, tds_queue_mpmc_size(instance));
+                return true;
+            }
+            TDS_STATS_ADD(instance, retries, 1);
+        } else if (diff < 0) {
+            // The consumer of the previous lap has not released the slot yet
+            TDS_STATS_ADD(instance, failed_full, 1);
+            return false;
+        } else {
+            TDS_STATS_ADD(instance, retries, 1);
+            pos = atomic_load_explicit(&instance->enqueue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+static bool tds_queue_mpmc_dequeue(tds_queue_t instance, void* data) {
+    uint32_t pos = atomic_load_explicit(&instance->dequeue_pos, memory_order_relaxed);
+
+    for (;;) {
+        struct tds_queue_cell_t* cell = tds_queue_cell(instance, pos);
+        uint32_t                 seq  = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        int32_t                  diff = (int32_t) (seq - (pos + 1));
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&instance->dequeue_pos, &pos, pos + 1, TDS_QUEUE_CLAIM_ORDER, memory_order_relaxed)) {
+                memcpy(data, cell->data, instance->elements);
+                // Hand the slot to the producer of the next lap
+                atomic_store_explicit(&cell->sequence, pos + instance->mask + 1, memory_order_release);
+                TDS_QUEUE_WAKE(instance, not_full, 1);
+                TDS_STATS_ADD(instance, operations, 1);
+                return true;
+            }
+            TDS_STATS_ADD(instance, retries, 1);
+        } else if (diff < 0) {
+            // The producer of this position has not published yet: empty
+            TDS_STATS_ADD(instance, failed_empty, 1);
+            return false;
+        } else {
+            TDS_STATS_ADD(instance, retries, 1);
+            pos = atomic_load_explicit(&instance->dequeue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+static bool tds_queue_mpmc_peek(tds_queue_t instance, void* data) {
+    for (;;) {
+        uint32_t                 pos  = atomic_load_explicit(&instance->dequeue_pos, memory_order_acquire);
+        struct tds_queue_cell_t* cell = tds_queue_cell(instance, pos);
+        uint32_t                 seq  = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+
+        if (seq != pos + 1) {
+            if ((int32_t) (seq - (pos + 1)) < 0) {
+                TDS_STATS_ADD(instance, failed_empty, 1);
+                return false;
+            }
+            TDS_STATS_ADD(instance, retries, 1);
+            continue;
+        }
+
+        memcpy(data, cell->data, instance->elements);
+
+        // The copy is only valid if no consumer released the slot meanwhile
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&cell->sequence, memory_order_relaxed) == seq) {
+            TDS_STATS_ADD(instance, operations, 1);
+            return true;
+        }
+        TDS_STATS_ADD(instance, retries, 1);
+    }
+}
+
+static uint32_t tds_queue_mpmc_enqueue_n(tds_queue_t instance, const uint8_t* data, uint32_t count) {
+    uint32_t pos = atomic_load_explicit(&instance->enqueue_pos, memory_order_relaxed);
+
+    for (;;) {
+        // Count how many consecutive slots are free for this lap
+        uint32_t n = 0;
+        while (n < count && n <= instance->mask) {
+            uint32_t seq = atomic_load_explicit(&tds_queue_cell(instance, pos + n)->sequence, memory_order_acquire);
+            if (seq != pos + n) {
+                break;
+            }
+            n++;
+        }
+
+        if (n == 0) {
+            uint32_t seq = atomic_load_explicit(&tds_queue_cell(instance, pos)->sequence, memory_order_acquire);
+            if ((int32_t) (seq - pos) < 0) {
+                TDS_STATS_ADD(instance, failed_full, 1);
+                return 0;
+            }
+            TDS_STATS_ADD(instance, retries, 1);
+            pos = atomic_load_explicit(&instance->enqueue_pos, memory_order_relaxed);
+            continue;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(&instance->enqueue_pos, &pos, pos + n, TDS_QUEUE_CLAIM_ORDER, memory_order_relaxed)) {
+            for (uint32_t i = 0; i < n; i++) {
+                struct tds_queue_cell_t* cell = tds_queue_cell(instance, pos + i);
+                memcpy(cell->data, data + (size_t) i * instance->elements, instance->elements);
+                atomic_store_explicit(&cell->sequence, pos + i + 1, memory_order_release);
+            }
+            TDS_QUEUE_WAKE(instance, not_empty, n);
+            TDS_STATS_ADD(instance, operations, n);
+            TDS_STATS_MAX(instance, high_water, tds_queue_mpmc_size(instance));
+            return n;
+        }
+        TDS_STATS_ADD(instance, retries, 1);
+    }
+}
+
+static uint32_t tds_queue_mpmc_dequeue_n(tds_queue_t instance, uint8_t* data, uint32_t count) {
+    uint32_t pos = atomic_load_explicit(&instance->dequeue_pos, memory_order_relaxed);
+
+    for (;;) {
+        // Count how many consecutive slots are published for this lap
+        uint32_t n = 0;
+        while (n < count && n <= instance->mask) {
+            uint32_t seq = atomic_load_explicit(&tds_queue_cell(instance, pos + n)->sequence, memory_order_acquire);
+            if (seq != pos + n + 1) {
+                break;
+            }
+            n++;
+        }
+
+        if (n == 0) {
+            uint32_t seq = atomic_load_explicit(&tds_queue_cell(instance, pos)->sequence, memory_order_acquire);
+            if ((int32_t) (seq - (pos + 1)) < 0) {
+                TDS_STATS_ADD(instance, failed_empty, 1);
+                return 0;
+            }
+            TDS_STATS_ADD(instance, retries, 1);
+            pos = atomic_load_explicit(&instance->dequeue_pos, memory_order_relaxed);
+            continue;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(&instance->dequeue_pos, &pos, pos + n, TDS_QUEUE_CLAIM_ORDER, memory_order_relaxed)) {
+            for (uint32_t i = 0; i < n; i++) {
+                struct tds_queue_cell_t* cell = tds_queue_cell(instance, pos + i);
+                memcpy(data + (size_t) i * instance->elements, cell->data, instance->elements);
+                atomic_store_explicit(&cell->sequence, pos + i + instance->mask + 1, memory_order_release);
+            }
+            TDS_QUEUE_WAKE(instance, not_full, n);
+            TDS_STATS_ADD(instance, operations, n);
+            return n;
+        }
+        TDS_STATS_ADD(instance, retries, 1);
+    }
+}
+
+#if TDS_QUEUE_BLOCKING
+/**
+ * @brief Spin-then-park loop shared by tds_queue_enqueue_wait and tds_queue_dequeue_wait.
+ *
+ * @param in Element to enqueue, or NULL to dequeue into out.
+ */
+static bool tds_queue_mpmc_wait(tds_queue_t instance, const void* in, void* out, uint32_t timeout_ms) {
+    struct tds_queue_waiters_t* w        = in ? &instance->not_full : &instance->not_empty;
+    uint64_t                    deadline = 0;
+    uint32_t                    spins    = 0;
+
+    for (;;) {
+        if (in ? tds_queue_mpmc_enqueue(instance, in) : tds_queue_mpmc_dequeue(instance, out)) {
+            return true;
+        }
+
+        if (spins < TDS_QUEUE_SPIN_COUNT && timeout_ms != 0) {
+            spins++;
+            TDS_CPU_RELAX();
+            continue;
+        }
+
+        uint64_t now = tds_queue_now_ns();
+        if (deadline == 0) {
+            deadline = timeout_ms == TDS_QUEUE_WAIT_FOREVER ? UINT64_MAX : now + (uint64_t) timeout_ms * 1000000u;
+        }
+        if (now >= deadline) {
+            return false;
+        }
+
+        // Register before re-reading the positions (see TDS_QUEUE_CLAIM_ORDER)
+        uint32_t key = atomic_load_explicit(&w->event, memory_order_acquire);
+        atomic_fetch_add_explicit(&w->waiting, 1, memory_order_seq_cst);
+
+        uint32_t enqueue_pos = atomic_load_explicit(&instance->enqueue_pos, memory_order_seq_cst);
+        uint32_t dequeue_pos = atomic_load_explicit(&instance->dequeue_pos, memory_order_seq_cst);
+        int32_t  size        = (int32_t) (enqueue_pos - dequeue_pos);
+
+        // A claimed but unpublished position is only a few instructions away: retry instead
+        if (in ? size >= (int32_t) instance->capacity : size <= 0) {
+            TDS_STATS_ADD(instance, retries, 1);
+            tds_queue_park(instance, w, key, deadline == UINT64_MAX ? 0 : deadline - now);
+        }
+        atomic_fetch_sub_explicit(&w->waiting, 1, memory_order_relaxed);
+    }
+}
+#endif
+
+/**
+ * @brief Validates the parameters shared by create_ex and init_static.
+ *
+ * @param slots Number of slots of the queue (capacity rounded up in MPMC mode).
+ * @param stride Bytes of storage per slot, 0 in linked mode.
+ */
+static bool tds_queue_layout(uint32_t capacity, size_t element_size, const tds_queue_config_t* config, uint32_t* slots, size_t* stride) {
+    if (capacity == 0 || element_size == 0 || element_size > UINT32_MAX) {
         // printf("[LOG] Capacity is invalid!\n");
+        return false;
+    }
+
+    if (config->mode != TDS_QUEUE_MODE_LINKED && config->mode != TDS_QUEUE_MODE_RING && config->mode != TDS_QUEUE_MODE_MPMC) {
+        // printf("[ERROR] Unknown queue mode %d!\n", config->mode);
+        return false;
+    }
+
+    if (config->allocator && !config->allocator->alloc) {
+        // printf("[ERROR] Allocator callbacks are incomplete!\n");
+        return false;
+    }
+
+    *slots  = capacity;
+    *stride = 0;
+
+    if (config->mode == TDS_QUEUE_MODE_RING) {
+        if (element_size > SIZE_MAX / capacity) {
+            // printf("[ERROR] Ring storage size overflows size_t.\n");
+            return false;
+        }
+        *stride = element_size;
+    }
+
+    if (config->mode == TDS_QUEUE_MODE_MPMC) {
+        if (capacity > TDS_QUEUE_MPMC_MAX_CAPACITY || element_size > UINT32_MAX - 2 * sizeof(struct tds_queue_cell_t)) {
+            return false;
+        }
+
+        *slots = 1;
+        while (*slots < capacity) {
+            *slots <<= 1;
+        }
+
+        *stride = (sizeof(struct tds_queue_cell_t) + element_size + _Alignof(struct tds_queue_cell_t) - 1) & ~(_Alignof(struct tds_queue_cell_t) - 1);
+        if (*stride > SIZE_MAX / *slots) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Fills a queue instance over already allocated storage.
+ */
+static void tds_queue_init(tds_queue_t queue, uint32_t slots, size_t element_size, const tds_queue_config_t* config, uint8_t* buffer, size_t stride, bool is_static) {
+    queue->mode      = config->mode;
+    queue->head      = NULL;
+    queue->tail      = NULL;
+    queue->allocator = config->allocator ? *config->allocator : *tds_allocator_default();
+    queue->buffer    = buffer;
+    queue->read      = 0;
+    queue->write     = 0;
+    queue->reserved  = 0;
+    queue->mask      = 0;
+    queue->stride    = 0;
+    queue->elements  = element_size;
+    queue->capacity  = slots;
+    queue->size      = 0;
+    queue->is_static = is_static;
+    atomic_init(&queue->enqueue_pos, 0);
+    atomic_init(&queue->dequeue_pos, 0);
+    TDS_STATS_INIT(queue);
+
+    if (config->mode == TDS_QUEUE_MODE_MPMC) {
+        queue->mask   = slots - 1;
+        queue->stride = (uint32_t) stride;
+        for (uint32_t i = 0; i < slots; i++) {
+            atomic_init(&tds_queue_cell(queue, i)->sequence, i);
+        }
+
+#if TDS_QUEUE_BLOCKING
+        atomic_init(&queue->not_empty.event, 0);
+        atomic_init(&queue->not_empty.waiting, 0);
+        atomic_init(&queue->not_full.event, 0);
+        atomic_init(&queue->not_full.waiting, 0);
+#if TDS_QUEUE_BLOCKING == 2
+        pthread_mutex_init(&queue->wait_lock, NULL);
+        pthread_cond_init(&queue->not_empty.cond, NULL);
+        pthread_cond_init(&queue->not_full.cond, NULL);
+#endif
+#endif
+    }
+}
+
+tds_queue_t tds_queue_create(uint32_t capacity, size_t element_size) {
+    return tds_queue_create_ex(capacity, element_size, NULL);
+}
+
+tds_queue_t tds_queue_create_ex(uint32_t capacity, size_t element_size, const tds_queue_config_t* config) {
+    static const tds_queue_config_t default_config = TDS_QUEUE_CONFIG_DEFAULT;
+    uint32_t                        slots;
+    size_t                          stride;
+
+    if (!config) {
+        config = &default_config;
+    }
+
+    if (!tds_queue_layout(capacity, element_size, config, &slots, &stride)) {
         return NULL;
     }
 
     // printf("[LOG] Creating queue with capacity %u and element size of %zu bytes...\n", capacity, element_size);
-    tds_queue_t new_queue = (tds_queue_t) malloc(sizeof(struct tds_queue_instance_t));
+    tds_queue_t new_queue = (tds_queue_t) TDS_MALLOC(sizeof(struct tds_queue_instance_t));
 
     if (!new_queue) {
         // printf("[ERROR] Failed to allocate memory for the queue.\n");
         return NULL;
     }
 
-    new_queue->head     = NULL;
-    new_queue->tail     = NULL;
-    new_queue->elements = element_size;
-    new_queue->capacity = capacity;
-    new_queue->size     = 0;
+    uint8_t* buffer = NULL;
+    if (stride) {
+        buffer = (uint8_t*) TDS_MALLOC((size_t) slots * stride);
+        if (!buffer) {
+            // printf("[ERROR] Failed to allocate memory for the queue storage.\n");
+            TDS_FREE(new_queue);
+            return NULL;
+        }
+    }
+
+    tds_queue_init(new_queue, slots, element_size, config, buffer, stride, false);
+    if (buffer) {
+        TDS_STATS_ALLOC(new_queue, (size_t) slots * stride);
+    }
 
     // printf("[LOG] Queue create sucessfully\n");
     return new_queue;
 }
 
+tds_queue_t tds_queue_init_static(void* storage, size_t storage_size, uint32_t capacity, size_t element_size, const tds_queue_config_t* config) {
+    static const tds_queue_config_t default_config = {.mode = TDS_QUEUE_MODE_RING, .allocator = NULL};
+    size_t                          header         = TDS_MEMORY_ROUND(TDS_QUEUE_INSTANCE_SIZE);
+    uint32_t                        slots;
+    size_t                          stride;
+
+    if (!config) {
+        config = &default_config;
+    }
+
+    if (!storage || (uintptr_t) storage % _Alignof(max_align_t) != 0) {
+        // printf("[ERROR] Queue storage is missing or misaligned!\n");
+        return NULL;
+    }
+
+    if (config->mode == TDS_QUEUE_MODE_LINKED && !config->allocator) {
+        // printf("[ERROR] A static linked queue needs an allocator for its nodes!\n");
+        return NULL;
+    }
+
+    if (!tds_queue_layout(capacity, element_size, config, &slots, &stride) || storage_size < TDS_QUEUE_INSTANCE_SIZE ||
+        (stride && (storage_size < header || (size_t) slots > (storage_size - header) / stride))) {
+        // printf("[ERROR] Queue storage is too small!\n");
+        return NULL;
+    }
+
+    tds_queue_t queue = (tds_queue_t) storage;
+    tds_queue_init(queue, slots, element_size, config, stride ? (uint8_t*) storage + header : NULL, stride, true);
+    return queue;
+}
+
 bool tds_queue_enqueue(tds_queue_t instance, const void* data) {
     if (!instance) {
         // printf("[ERROR] Queue is not initialized!\n");
         return false;
     }
 
+    if (instance->mode == TDS_QUEUE_MODE_MPMC) {
+        return data && tds_queue_mpmc_enqueue(instance, data);
+    }
+
     if (instance->size >= instance->capacity) {
         // printf("[ERROR] Queue is full! Maximum capacity reached (%u elements).\n", instance->capacity);
+        TDS_STATS_ADD(instance, failed_full, 1);
         return false;
     }
 
@@ -77,22 +612,28 @@ bool tds_queue_enqueue(tds_queue_t instance, const void* data) {
         return false;
     }
 
-    instance->size += 1;
-    // printf("[LOG] Inserting element %u into the queue...\n", instance->size);
+    if (instance->mode == TDS_QUEUE_MODE_RING) {
+        memcpy(instance->buffer + (size_t) instance->write * instance->elements, data, instance->elements);
+        if (++instance->write == instance->capacity) {
+            instance->write = 0;
+        }
+        instance->size++;
+        instance->reserved = 0;  // The pending reservation may have been overwritten
+        TDS_STATS_ADD(instance, operations, 1);
+        TDS_STATS_MAX(instance, high_water, instance->size);
+        return true;
+    }
+
+    // printf("[LOG] Inserting element %u into the queue...\n", instance->size + 1);
 
-    struct tds_queue_node_t* new_node = (struct tds_queue_node_t*) malloc(sizeof(struct tds_queue_node_t));
+    struct tds_queue_node_t* new_node = (struct tds_queue_node_t*) instance->allocator.alloc(instance->allocator.context, tds_queue_node_size(instance->elements));
     if (!new_node) {
         // printf("[ERROR] Failed to allocate memory for new node.\n");
         return false;
     }
+    TDS_STATS_ALLOC(instance, tds_queue_node_size(instance->elements));
 
-    new_node->data = malloc(instance->elements);
     new_node->next = NULL;
-    if (!new_node->data) {
-        // printf("[ERROR] Failed to allocate memory for the node data.\n");
-        free(new_node);
-        return false;
-    }
     memcpy(new_node->data, data, instance->elements);
 
     if (!instance->head) {
@@ -102,6 +643,9 @@ bool tds_queue_enqueue(tds_queue_t instance, const void* data) {
         instance->tail->next = new_node;
         instance->tail       = new_node;
     }
+    instance->size++;
+    TDS_STATS_ADD(instance, operations, 1);
+    TDS_STATS_MAX(instance, high_water, instance->size);
 
     // printf("[LOG] Element inserted sucessfully! Current queue size: %u\n", instance->size);
     return true;
@@ -118,11 +662,27 @@ bool tds_queue_dequeue(tds_queue_t instance, void* data) {
         return false;
     }
 
+    if (instance->mode == TDS_QUEUE_MODE_MPMC) {
+        return tds_queue_mpmc_dequeue(instance, data);
+    }
+
     if (instance->size == 0) {
         // printf("[ERROR] Queue is empty!\n");
+        TDS_STATS_ADD(instance, failed_empty, 1);
         return false;
     }
 
+    TDS_STATS_ADD(instance, operations, 1);
+
+    if (instance->mode == TDS_QUEUE_MODE_RING) {
+        memcpy(data, instance->buffer + (size_t) instance->read * instance->elements, instance->elements);
+        if (++instance->read == instance->capacity) {
+            instance->read = 0;
+        }
+        instance->size--;
+        return true;
+    }
+
     struct tds_queue_node_t* temp = instance->head;
     memcpy(data, temp->data, instance->elements);
 
@@ -132,8 +692,7 @@ bool tds_queue_dequeue(tds_queue_t instance, void* data) {
         instance->tail = NULL;
     }
 
-    free(temp->data);
-    free(temp);
+    tds_allocator_release(&instance->allocator, temp);
 
     instance->size--;
 
@@ -148,6 +707,10 @@ bool tds_queue_empty(tds_queue_t instance) {
         return true;
     }
 
+    if (instance->mode == TDS_QUEUE_MODE_MPMC) {
+        return tds_queue_mpmc_size(instance) == 0;
+    }
+
     bool empty = (instance->size == 0);
 
     return (!empty) ? false : true;
@@ -164,7 +727,23 @@ bool tds_queue_peek(tds_queue_t instance, void* data) {
         return false;
     }
 
-    memcpy(data, instance->head->data, instance->elements);
+    if (instance->mode == TDS_QUEUE_MODE_MPMC) {
+        return tds_queue_mpmc_peek(instance, data);
+    }
+
+    if (instance->size == 0) {
+        // printf("[ERROR] Queue is empty!\n");
+        TDS_STATS_ADD(instance, failed_empty, 1);
+        return false;
+    }
+
+    TDS_STATS_ADD(instance, operations, 1);
+
+    if (instance->mode == TDS_QUEUE_MODE_RING) {
+        memcpy(data, instance->buffer + (size_t) instance->read * instance->elements, instance->elements);
+    } else {
+        memcpy(data, instance->head->data, instance->elements);
+    }
     return true;
 }
 
@@ -174,6 +753,10 @@ int tds_queue_size(tds_queue_t instance) {
         return -1;
     }
 
+    if (instance->mode == TDS_QUEUE_MODE_MPMC) {
+        return tds_queue_mpmc_size(instance);
+    }
+
     return instance->size;
 }
 
@@ -182,25 +765,340 @@ bool tds_queue_destroy(tds_queue_t instance) {
         return true;
     }
 
-    if (instance->size > 0) {
-        while (!instance->head) {
+#if TDS_QUEUE_BLOCKING == 2
+    if (instance->mode == TDS_QUEUE_MODE_MPMC) {
+        pthread_cond_destroy(&instance->not_full.cond);
+        pthread_cond_destroy(&instance->not_empty.cond);
+        pthread_mutex_destroy(&instance->wait_lock);
+    }
+#endif
+
+    if (instance->mode == TDS_QUEUE_MODE_RING || instance->mode == TDS_QUEUE_MODE_MPMC) {
+        if (!instance->is_static) {
+            TDS_FREE(instance->buffer);
+            TDS_FREE(instance);
+        }
+        return true;
+    }
+
+    // Nodes from an allocator without free (arena) go away with the region
+    if (instance->size > 0 && instance->allocator.free) {
+        while (instance->head) {
             struct tds_queue_node_t* temp = instance->head;
             instance->head                = instance->head->next;
             if (!instance->head) {
                 instance->tail = NULL;
             }
-            free(temp->data);
-            free(temp);
+            tds_allocator_release(&instance->allocator, temp);
 
             instance->size--;
         }
     }
 
-    free(instance);
+    if (!instance->is_static) {
+        TDS_FREE(instance);
+    }
 
     return true;
 }
 
+uint32_t tds_queue_enqueue_n(tds_queue_t instance, const void* data, uint32_t count) {
+    if (!instance || !data || count == 0) {
+        // printf("[ERROR] Queue is not initialized or data pointer is NULL!\n");
+        return 0;
+    }
+
+    const uint8_t* src = (const uint8_t*) data;
+
+    if (instance->mode == TDS_QUEUE_MODE_MPMC) {
+        return tds_queue_mpmc_enqueue_n(instance, src, count);
+    }
+
+    if (count > instance->capacity - instance->size) {
+        TDS_STATS_ADD(instance, failed_full, 1);
+        count = instance->capacity - instance->size;
+    }
+
+    if (instance->mode == TDS_QUEUE_MODE_RING) {
+        uint32_t first = instance->capacity - instance->write;
+        if (first > count) {
+            first = count;
+        }
+        memcpy(instance->buffer + (size_t) instance->write * instance->elements, src, (size_t) first * instance->elements);
+        memcpy(instance->buffer, src + (size_t) first * instance->elements, (size_t) (count - first) * instance->elements);
+
+        instance->write += count;
+        if (instance->write >= instance->capacity) {
+            instance->write -= instance->capacity;
+        }
+        instance->size += count;
+        if (count) {
+            instance->reserved = 0;  // The pending reservation may have been overwritten
+        }
+        TDS_STATS_ADD(instance, operations, count);
+        TDS_STATS_MAX(instance, high_water, instance->size);
+        return count;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        struct tds_queue_node_t* new_node = (struct tds_queue_node_t*) instance->allocator.alloc(instance->allocator.context, tds_queue_node_size(instance->elements));
+        if (!new_node) {
+            // printf("[ERROR] Failed to allocate memory for new node.\n");
+            return i;
+        }
+        TDS_STATS_ALLOC(instance, tds_queue_node_size(instance->elements));
+
+        new_node->next = NULL;
+        memcpy(new_node->data, src + (size_t) i * instance->elements, instance->elements);
+
+        if (!instance->head) {
+            instance->head = new_node;
+        } else {
+            instance->tail->next = new_node;
+        }
+        instance->tail = new_node;
+        instance->size++;
+        TDS_STATS_ADD(instance, operations, 1);
+        TDS_STATS_MAX(instance, high_water, instance->size);
+    }
+
+    return count;
+}
+
+uint32_t tds_queue_dequeue_n(tds_queue_t instance, void* data, uint32_t count) {
+    if (!instance || !data || count == 0) {
+        // printf("[ERROR] Queue is not initialized or data pointer is NULL!\n");
+        return 0;
+    }
+
+    uint8_t* dst = (uint8_t*) data;
+
+    if (instance->mode == TDS_QUEUE_MODE_MPMC) {
+        return tds_queue_mpmc_dequeue_n(instance, dst, count);
+    }
+
+    if (count > instance->size) {
+        TDS_STATS_ADD(instance, failed_empty, 1);
+        count = instance->size;
+    }
+
+    TDS_STATS_ADD(instance, operations, count);
+
+    if (instance->mode == TDS_QUEUE_MODE_RING) {
+        uint32_t first = instance->capacity - instance->read;
+        if (first > count) {
+            first = count;
+        }
+        memcpy(dst, instance->buffer + (size_t) instance->read * instance->elements, (size_t) first * instance->elements);
+        memcpy(dst + (size_t) first * instance->elements, instance->buffer, (size_t) (count - first) * instance->elements);
+
+        instance->read += count;
+        if (instance->read >= instance->capacity) {
+            instance->read -= instance->capacity;
+        }
+        instance->size -= count;
+        return count;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        struct tds_queue_node_t* temp = instance->head;
+        memcpy(dst + (size_t) i * instance->elements, temp->data, instance->elements);
+        instance->head = temp->next;
+        tds_allocator_release(&instance->allocator, temp);
+    }
+    if (!instance->head) {
+        instance->tail = NULL;
+    }
+    instance->size -= count;
+
+    return count;
+}
+
+void* tds_queue_reserve(tds_queue_t instance, uint32_t count, uint32_t* reserved) {
+    if (reserved) {
+        *reserved = 0;
+    }
+
+    if (!instance || !reserved || instance->mode != TDS_QUEUE_MODE_RING) {
+        // printf("[ERROR] Zero-copy access requires a ring mode queue!\n");
+        return NULL;
+    }
+
+    uint32_t contiguous = instance->capacity - instance->write;
+    uint32_t free_slots = instance->capacity - instance->size;
+    if (count > free_slots) {
+        count = free_slots;
+    }
+    if (count > contiguous) {
+        count = contiguous;
+    }
+
+    instance->reserved = count;
+    *reserved          = count;
+    return count ? instance->buffer + (size_t) instance->write * instance->elements : NULL;
+}
+
+bool tds_queue_commit(tds_queue_t instance, uint32_t count) {
+    if (!instance || instance->mode != TDS_QUEUE_MODE_RING || count > instance->reserved) {
+        return false;
+    }
+
+    instance->write += count;
+    if (instance->write >= instance->capacity) {
+        instance->write -= instance->capacity;
+    }
+    instance->size    += count;
+    instance->reserved = 0;
+    TDS_STATS_ADD(instance, operations, count);
+    TDS_STATS_MAX(instance, high_water, instance->size);
+    return true;
+}
+
+const void* tds_queue_peek_span(tds_queue_t instance, uint32_t* count) {
+    if (count) {
+        *count = 0;
+    }
+
+    if (!instance || !count || instance->mode != TDS_QUEUE_MODE_RING || instance->size == 0) {
+        return NULL;
+    }
+
+    uint32_t contiguous = instance->capacity - instance->read;
+    *count              = instance->size < contiguous ? instance->size : contiguous;
+    return instance->buffer + (size_t) instance->read * instance->elements;
+}
+
+uint32_t tds_queue_consume(tds_queue_t instance, uint32_t count) {
+    if (!instance || instance->mode != TDS_QUEUE_MODE_RING) {
+        return 0;
+    }
+
+    if (count > instance->size) {
+        count = instance->size;
+    }
+
+    instance->read += count;
+    if (instance->read >= instance->capacity) {
+        instance->read -= instance->capacity;
+    }
+    instance->size -= count;
+    TDS_STATS_ADD(instance, operations, count);
+    return count;
+}
+
+bool tds_queue_enqueue_threadsafe(tds_queue_t instance, const void* data) {
+    if (!instance || !data || instance->mode != TDS_QUEUE_MODE_MPMC) {
+        // printf("[ERROR] Queue is not initialized or not in MPMC mode!\n");
+        return false;
+    }
+
+    return tds_queue_mpmc_enqueue(instance, data);
+}
+
+bool tds_queue_dequeue_threadsafe(tds_queue_t instance, void* data) {
+    if (!instance || !data || instance->mode != TDS_QUEUE_MODE_MPMC) {
+        // printf("[ERROR] Queue is not initialized or not in MPMC mode!\n");
+        return false;
+    }
+
+    return tds_queue_mpmc_dequeue(instance, data);
+}
+
+#if TDS_QUEUE_BLOCKING
+bool tds_queue_enqueue_wait(tds_queue_t instance, const void* data, uint32_t timeout_ms) {
+    if (!instance || !data || instance->mode != TDS_QUEUE_MODE_MPMC) {
+        // printf("[ERROR] Queue is not initialized or not in MPMC mode!\n");
+        return false;
+    }
+
+    return tds_queue_mpmc_wait(instance, data, NULL, timeout_ms);
+}
+
+bool tds_queue_dequeue_wait(tds_queue_t instance, void* data, uint32_t timeout_ms) {
+    if (!instance || !data || instance->mode != TDS_QUEUE_MODE_MPMC) {
+        // printf("[ERROR] Queue is not initialized or not in MPMC mode!\n");
+        return false;
+    }
+
+    return tds_queue_mpmc_wait(instance, NULL, data, timeout_ms);
+}
+#endif
+
+bool tds_queue_get_stats(tds_queue_t instance, tds_stats_t* stats) {
+    if (!instance || !stats) {
+        return false;
+    }
+
+    return TDS_STATS_READ(instance, stats);
+}
+
+#if TDS_SNAPSHOT
+bool tds_queue_snapshot(tds_queue_t instance, int fd) {
+    if (!instance || fd < 0) {
+        return false;
+    }
+
+    uint32_t              count = (uint32_t) tds_queue_size(instance);
+    tds_snapshot_header_t header;
+    tds_snapshot_writer_t writer;
+
+    tds_snapshot_header_init(&header, TDS_SNAPSHOT_QUEUE);
+    header.queue_mode   = (uint32_t) instance->mode;
+    header.element_size = instance->elements;
+    header.capacity     = instance->capacity;
+    header.count        = count;
+    header.data_size    = (uint64_t) count * instance->elements;
+    if (!tds_snapshot_write_begin(&writer, fd, &header)) {
+        return false;
+    }
+
+    if (instance->mode == TDS_QUEUE_MODE_RING) {
+        uint32_t first = instance->capacity - instance->read;
+        if (first > count) {
+            first = count;
+        }
+        tds_snapshot_write(&writer, instance->buffer + (size_t) instance->read * instance->elements, (size_t) first * instance->elements);
+        tds_snapshot_write(&writer, instance->buffer, (size_t) (count - first) * instance->elements);
+    } else if (instance->mode == TDS_QUEUE_MODE_MPMC) {
+        uint32_t pos = atomic_load_explicit(&instance->dequeue_pos, memory_order_acquire);
+        for (uint32_t i = 0; i < count; i++) {
+            tds_snapshot_write(&writer, tds_queue_cell(instance, pos + i)->data, instance->elements);
+        }
+    } else {
+        for (struct tds_queue_node_t* node = instance->head; node; node = node->next) {
+            tds_snapshot_write(&writer, node->data, instance->elements);
+        }
+    }
+
+    return tds_snapshot_write_end(&writer);
+}
+
+tds_queue_t tds_queue_load(const char* path, const tds_queue_config_t* config) {
+    tds_snapshot_header_t header;
+    size_t                length;
+    const uint8_t*        data = tds_snapshot_map(path, TDS_SNAPSHOT_QUEUE, &header, &length);
+    if (!data) {
+        return NULL;
+    }
+
+    tds_queue_config_t saved = {.mode = (tds_queue_mode_t) header.queue_mode, .allocator = NULL};
+    tds_queue_t        queue = NULL;
+    if (header.queue_mode <= TDS_QUEUE_MODE_MPMC && header.count <= header.capacity &&
+        header.data_size == (uint64_t) header.count * header.element_size) {
+        queue = tds_queue_create_ex(header.capacity, header.element_size, config ? config : &saved);
+    }
+
+    if (queue && header.count > 0 && tds_queue_enqueue_n(queue, data, header.count) != header.count) {
+        //printf("[ERROR] Snapshot elements do not fit the queue!\n");
+        tds_queue_destroy(queue);
+        queue = NULL;
+    }
+
+    tds_snapshot_unmap(data, &header, length);
+    return queue;
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,802 @@
+/******************************************************************************
+ * File: tds_ringbuffer.c
+ * Author: Tiago Barbosa
+ * Description: Lock-free single-producer/single-consumer ring buffer for
+ *              embedded systems. One thread (or ISR) pushes and one thread
+ *              pops without locks and without allocating after creation.
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef RINGBUFFER_C
+#define RINGBUFFER_C
+
+#define _DEFAULT_SOURCE  // For MAP_ANONYMOUS and ftruncate() under -std=c11
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include "tds_ringbuffer.h"
+
+#include <stdatomic.h>  // For the head and consumer positions
+#include <stdlib.h>     // For malloc, free
+#include <string.h>     // For memcpy
+
+#include "tds_config.h"
+#include "tds_snapshot_internal.h"
+
+#if TDS_RINGBUFFER_MMAP
+#include <sys/mman.h>  // For mmap, munmap
+#include <sys/stat.h>  // For fstat
+#include <unistd.h>    // For ftruncate, sysconf
+#endif
+
+/* Defines ------------------------------------------------------------------*/
+#define TDS_RINGBUFFER_MAX_CAPACITY (UINT32_C(1) << 30)
+#define TDS_RINGBUFFER_MAGIC        UINT32_C(0x52534454) /* "TDSR" */
+#define TDS_RINGBUFFER_VERSION      1
+
+/* Typedefs -----------------------------------------------------------------*/
+
+/**
+ * @brief Read position of one consumer, alone on its cache line.
+ */
+struct tds_ringbuffer_cursor_t {
+    _Atomic uint32_t position;     /**< Next position this consumer reads */
+    uint32_t         cached_limit; /**< Consumer's last observed limit: head, or its slowest dependency */
+    uint32_t         depends;      /**< Consumers that must release a slot before this one sees it (bit mask) */
+    uint8_t          pad[TDS_CACHE_LINE_SIZE - 3 * sizeof(uint32_t)];
+};
+
+/**
+ * @brief Structure representing a ring buffer instance.
+ *
+ * head and the consumer positions (the tail) are free-running; the slot is
+ * position & mask. Each side owns one cache line holding its own index plus
+ * a private copy of the other side's index, which is only refreshed when the
+ * copy says the buffer is full (producer) or empty (consumer). In steady
+ * state each operation therefore touches only its own line plus the data
+ * slot.
+ *
+ * A broadcast ring buffer has one cursor per consumer: every consumer reads
+ * every element, in place, and the producer is limited by the slowest of the
+ * leaves (consumers nobody depends on). An SPSC ring buffer is the case of a
+ * single cursor.
+ *
+ * The slots always follow the instance at offset bytes, in the same block,
+ * so the instance holds no pointer and can itself live in a shared mapping
+ * (tds_ringbuffer_create_mapped()). When the slots are mapped twice back to
+ * back, window is 2 * capacity and no copy or span is ever split at the end.
+ */
+struct tds_ringbuffer_instance_t {
+    /* Read-only after creation */
+    uint32_t magic;     /**< TDS_RINGBUFFER_MAGIC, checked on attach */
+    uint16_t version;   /**< TDS_RINGBUFFER_VERSION */
+    uint16_t layout;    /**< Instance bytes with its cursors, differs with TDS_STATS_SIZE */
+    uint32_t offset;    /**< Bytes from the instance to slot 0 */
+    uint32_t mask;      /**< capacity - 1 */
+    uint32_t capacity;  /**< Number of slots, power of two */
+    uint32_t window;    /**< Slots contiguous from slot 0: capacity, or 2 * capacity when mirrored */
+    uint32_t elements;  /**< Size of a single element in bytes */
+    uint32_t consumers; /**< Number of cursors */
+    uint32_t leaves;    /**< Cursors the producer waits for (bit mask) */
+    bool     is_static; /**< Instance and storage live in caller memory */
+    bool     is_mapped; /**< Instance and storage live in a mirrored file mapping */
+    uint8_t  pad0[TDS_CACHE_LINE_SIZE];
+
+    /* Producer cache line */
+    _Atomic uint32_t head;        /**< Next position to write */
+    uint32_t         cached_tail; /**< Producer's last observed slowest consumer */
+    uint32_t         reserved;    /**< Slots granted by the pending reserve */
+    uint8_t          pad1[TDS_CACHE_LINE_SIZE - 3 * sizeof(uint32_t)];
+
+    TDS_STATS_FIELD
+
+    /* Consumer cache lines */
+    struct tds_ringbuffer_cursor_t cursors[]; /**< consumers entries, cursors[0] is the SPSC consumer */
+};
+
+/**
+ * @brief Bytes of an instance with n consumer cursors.
+ */
+#define TDS_RINGBUFFER_HEADER_BYTES(n) (sizeof(struct tds_ringbuffer_instance_t) + (size_t) (n) * sizeof(struct tds_ringbuffer_cursor_t))
+
+_Static_assert(TDS_RINGBUFFER_HEADER_BYTES(1) <= TDS_RINGBUFFER_INSTANCE_SIZE, "TDS_RINGBUFFER_INSTANCE_SIZE too small");
+_Static_assert(TDS_RINGBUFFER_MAX_CONSUMERS <= 32, "consumer masks are 32 bits");
+
+/* Private Functions --------------------------------------------------------*/
+
+/**
+ * @brief Address of the slot holding position pos.
+ */
+static inline uint8_t* tds_ringbuffer_slot(tds_ringbuffer_t rb, uint32_t pos) {
+    return (uint8_t*) rb + rb->offset + (size_t) (pos & rb->mask) * rb->elements;
+}
+
+/**
+ * @brief Position of the slowest leaf consumer, head being the current head.
+ */
+static inline uint32_t tds_ringbuffer_slowest(tds_ringbuffer_t rb, uint32_t head, memory_order order) {
+    uint32_t slowest = atomic_load_explicit(&rb->cursors[0].position, order);
+    for (uint32_t i = 1; i < rb->consumers; i++) {
+        if (rb->leaves & (UINT32_C(1) << i)) {
+            uint32_t position = atomic_load_explicit(&rb->cursors[i].position, order);
+            if (head - position > head - slowest) {
+                slowest = position;
+            }
+        }
+    }
+    return slowest;
+}
+
+/**
+ * @brief Returns how many slots the producer may fill, refreshing the cached
+ * tail only when the cached value shows fewer than wanted.
+ */
+static inline uint32_t tds_ringbuffer_free_slots(tds_ringbuffer_t rb, uint32_t head, uint32_t wanted) {
+    uint32_t free_slots = rb->capacity - (head - rb->cached_tail);
+    if (free_slots < wanted) {
+        rb->cached_tail = tds_ringbuffer_slowest(rb, head, memory_order_acquire);
+        free_slots      = rb->capacity - (head - rb->cached_tail);
+    }
+    return free_slots;
+}
+
+/**
+ * @brief Returns how many elements a consumer may read, refreshing its cached
+ * limit only when the cached value shows fewer than wanted.
+ *
+ * The limit is head, lowered to the position of every consumer this one
+ * depends on.
+ */
+static inline uint32_t tds_ringbuffer_used_slots(tds_ringbuffer_t rb, struct tds_ringbuffer_cursor_t* c, uint32_t tail, uint32_t wanted) {
+    uint32_t used = c->cached_limit - tail;
+    if (used < wanted) {
+        uint32_t limit = atomic_load_explicit(&rb->head, memory_order_acquire);
+        for (uint32_t i = 0, depends = c->depends; depends; i++, depends >>= 1) {
+            if (depends & 1) {
+                uint32_t position = atomic_load_explicit(&rb->cursors[i].position, memory_order_acquire);
+                if (position - tail < limit - tail) {
+                    limit = position;
+                }
+            }
+        }
+        c->cached_limit = limit;
+        used            = limit - tail;
+    }
+    return used;
+}
+
+/**
+ * @brief Elements held right after the producer published head (stats only).
+ */
+static inline uint32_t tds_ringbuffer_fill(tds_ringbuffer_t rb, uint32_t head) {
+    return head - tds_ringbuffer_slowest(rb, head, memory_order_relaxed);
+}
+
+/**
+ * @brief Copies count elements into the ring starting at position pos,
+ * splitting the copy in two when it wraps (never when mirrored).
+ */
+static inline void tds_ringbuffer_copy_in(tds_ringbuffer_t rb, uint32_t pos, const uint8_t* src, uint32_t count) {
+    uint32_t slot  = pos & rb->mask;
+    uint32_t first = rb->window - slot;
+    uint8_t* base  = (uint8_t*) rb + rb->offset;
+    if (first > count) {
+        first = count;
+    }
+    memcpy(base + (size_t) slot * rb->elements, src, (size_t) first * rb->elements);
+    if (count > first) {
+        memcpy(base, src + (size_t) first * rb->elements, (size_t) (count - first) * rb->elements);
+    }
+}
+
+/**
+ * @brief Copies count elements out of the ring starting at position pos,
+ * splitting the copy in two when it wraps (never when mirrored).
+ */
+static inline void tds_ringbuffer_copy_out(tds_ringbuffer_t rb, uint32_t pos, uint8_t* dst, uint32_t count) {
+    uint32_t slot  = pos & rb->mask;
+    uint32_t first = rb->window - slot;
+    uint8_t* base  = (uint8_t*) rb + rb->offset;
+    if (first > count) {
+        first = count;
+    }
+    memcpy(dst, base + (size_t) slot * rb->elements, (size_t) first * rb->elements);
+    if (count > first) {
+        memcpy(dst + (size_t) first * rb->elements, base, (size_t) (count - first) * rb->elements);
+    }
+}
+
+/**
+ * @brief Copies the next element of a consumer out and releases it.
+ */
+static bool tds_ringbuffer_pop_one(tds_ringbuffer_t rb, struct tds_ringbuffer_cursor_t* c, void* data) {
+    uint32_t tail = atomic_load_explicit(&c->position, memory_order_relaxed);
+    if (tds_ringbuffer_used_slots(rb, c, tail, 1) == 0) {
+        TDS_STATS_ADD(rb, failed_empty, 1);
+        return false;
+    }
+
+    memcpy(data, tds_ringbuffer_slot(rb, tail), rb->elements);
+    atomic_store_explicit(&c->position, tail + 1, memory_order_release);
+    TDS_STATS_ADD(rb, operations, 1);
+    return true;
+}
+
+/**
+ * @brief Exposes the readable elements of a consumer in place.
+ */
+static const void* tds_ringbuffer_span(tds_ringbuffer_t rb, struct tds_ringbuffer_cursor_t* c, uint32_t* count) {
+    uint32_t tail       = atomic_load_explicit(&c->position, memory_order_relaxed);
+    uint32_t slot       = tail & rb->mask;
+    uint32_t contiguous = rb->window - slot;
+    uint32_t used       = tds_ringbuffer_used_slots(rb, c, tail, contiguous);
+    if (used == 0) {
+        return NULL;
+    }
+
+    *count = used < contiguous ? used : contiguous;
+    return tds_ringbuffer_slot(rb, tail);
+}
+
+/**
+ * @brief Advances a consumer past count elements read in place.
+ */
+static uint32_t tds_ringbuffer_release(tds_ringbuffer_t rb, struct tds_ringbuffer_cursor_t* c, uint32_t count) {
+    uint32_t tail = atomic_load_explicit(&c->position, memory_order_relaxed);
+    uint32_t used = tds_ringbuffer_used_slots(rb, c, tail, count);
+    if (count > used) {
+        count = used;
+    }
+
+    atomic_store_explicit(&c->position, tail + count, memory_order_release);
+    TDS_STATS_ADD(rb, operations, count);
+    return count;
+}
+
+/**
+ * @brief Fills a ring buffer instance whose slots start offset bytes after it.
+ */
+static void tds_ringbuffer_init(tds_ringbuffer_t rb, uint32_t slots, size_t element_size, size_t offset, uint32_t window) {
+    TDS_STATS_INIT(rb);
+
+    rb->magic       = TDS_RINGBUFFER_MAGIC;
+    rb->version     = TDS_RINGBUFFER_VERSION;
+    rb->layout      = (uint16_t) TDS_RINGBUFFER_HEADER_BYTES(1);
+    rb->offset      = (uint32_t) offset;
+    rb->mask        = slots - 1;
+    rb->capacity    = slots;
+    rb->window      = window;
+    rb->elements    = (uint32_t) element_size;
+    rb->consumers   = 1;
+    rb->leaves      = 1;
+    rb->is_static   = false;
+    rb->is_mapped   = false;
+    rb->cached_tail = 0;
+    rb->reserved    = 0;
+    atomic_init(&rb->head, 0);
+    rb->cursors[0].cached_limit = 0;
+    rb->cursors[0].depends      = 0;
+    atomic_init(&rb->cursors[0].position, 0);
+}
+
+#if TDS_RINGBUFFER_MMAP
+/**
+ * @brief Bytes before slot 0 in a mapping: the instance rounded up to a page,
+ * so the slots can be mapped a second time right after themselves.
+ */
+static size_t tds_ringbuffer_map_header(size_t page) {
+    return (TDS_RINGBUFFER_HEADER_BYTES(1) + page - 1) & ~(page - 1);
+}
+
+/**
+ * @brief Maps header + data bytes of fd, followed by a second view of the
+ * data bytes, in one reserved range of address space.
+ */
+static tds_ringbuffer_t tds_ringbuffer_map(int fd, size_t header, size_t data) {
+    uint8_t* base = (uint8_t*) mmap(NULL, header + 2 * data, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == (uint8_t*) MAP_FAILED) {
+        //printf("[ERROR] Failed to reserve address space for the ring buffer.\n");
+        return NULL;
+    }
+
+    if (mmap(base, header + data, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(base + header + data, data, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, (off_t) header) == MAP_FAILED) {
+        //printf("[ERROR] Failed to map the ring buffer file.\n");
+        munmap(base, header + 2 * data);
+        return NULL;
+    }
+    return (tds_ringbuffer_t) base;
+}
+#endif
+
+/* Public Functions ---------------------------------------------------------*/
+
+tds_ringbuffer_t tds_ringbuffer_create(uint32_t capacity, size_t element_size) {
+    if (capacity == 0 || capacity > TDS_RINGBUFFER_MAX_CAPACITY || element_size == 0 || element_size > UINT32_MAX) {
+        //printf("[ERROR] Invalid ring buffer parameters!\n");
+        return NULL;
+    }
+
+    uint32_t slots = 1;
+    while (slots < capacity) {
+        slots <<= 1;
+    }
+
+    size_t header = TDS_MEMORY_ROUND(TDS_RINGBUFFER_INSTANCE_SIZE);
+    if (element_size > (SIZE_MAX - header) / slots) {
+        //printf("[ERROR] Ring buffer size overflows size_t.\n");
+        return NULL;
+    }
+
+    tds_ringbuffer_t rb = (tds_ringbuffer_t) TDS_MALLOC(header + (size_t) slots * element_size);
+    if (!rb) {
+        //printf("[ERROR] Failed to allocate memory for the ring buffer.\n");
+        return NULL;
+    }
+
+    tds_ringbuffer_init(rb, slots, element_size, header, slots);
+    TDS_STATS_ALLOC(rb, header + (size_t) slots * element_size);
+    return rb;
+}
+
+tds_ringbuffer_t tds_ringbuffer_init_static(void* storage, size_t storage_size, uint32_t capacity, size_t element_size) {
+    size_t header = TDS_MEMORY_ROUND(TDS_RINGBUFFER_INSTANCE_SIZE);
+
+    if (!storage || (uintptr_t) storage % _Alignof(max_align_t) != 0) {
+        //printf("[ERROR] Ring buffer storage is missing or misaligned!\n");
+        return NULL;
+    }
+
+    if (capacity == 0 || capacity > TDS_RINGBUFFER_MAX_CAPACITY || (capacity & (capacity - 1)) != 0 || element_size == 0 || element_size > UINT32_MAX) {
+        //printf("[ERROR] Invalid ring buffer parameters!\n");
+        return NULL;
+    }
+
+    if (storage_size < header || element_size > (storage_size - header) / capacity) {
+        //printf("[ERROR] Ring buffer storage is too small!\n");
+        return NULL;
+    }
+
+    tds_ringbuffer_t rb = (tds_ringbuffer_t) storage;
+    tds_ringbuffer_init(rb, capacity, element_size, header, capacity);
+    rb->is_static = true;
+    return rb;
+}
+
+tds_ringbuffer_t tds_ringbuffer_create_broadcast(uint32_t capacity, size_t element_size, uint32_t consumers, const uint32_t* depends) {
+    if (capacity == 0 || capacity > TDS_RINGBUFFER_MAX_CAPACITY || element_size == 0 || element_size > UINT32_MAX || consumers == 0 ||
+        consumers > TDS_RINGBUFFER_MAX_CONSUMERS) {
+        //printf("[ERROR] Invalid ring buffer parameters!\n");
+        return NULL;
+    }
+
+    /* Every consumer is a leaf unless another one waits for it */
+    uint32_t leaves = consumers == 32 ? UINT32_MAX : (UINT32_C(1) << consumers) - 1;
+    for (uint32_t i = 0; depends && i < consumers; i++) {
+        if (depends[i] >> i) {
+            //printf("[ERROR] A consumer may only depend on lower indices!\n");
+            return NULL;
+        }
+        leaves &= ~depends[i];
+    }
+
+    uint32_t slots = 1;
+    while (slots < capacity) {
+        slots <<= 1;
+    }
+
+    size_t header = TDS_MEMORY_ROUND(TDS_RINGBUFFER_HEADER_BYTES(consumers));
+    if (element_size > (SIZE_MAX - header) / slots) {
+        //printf("[ERROR] Ring buffer size overflows size_t.\n");
+        return NULL;
+    }
+
+    tds_ringbuffer_t rb = (tds_ringbuffer_t) TDS_MALLOC(header + (size_t) slots * element_size);
+    if (!rb) {
+        //printf("[ERROR] Failed to allocate memory for the ring buffer.\n");
+        return NULL;
+    }
+
+    tds_ringbuffer_init(rb, slots, element_size, header, slots);
+    rb->layout    = (uint16_t) TDS_RINGBUFFER_HEADER_BYTES(consumers);
+    rb->consumers = consumers;
+    rb->leaves    = leaves;
+    for (uint32_t i = 0; i < consumers; i++) {
+        rb->cursors[i].cached_limit = 0;
+        rb->cursors[i].depends      = depends ? depends[i] : 0;
+        atomic_init(&rb->cursors[i].position, 0);
+    }
+    TDS_STATS_ALLOC(rb, header + (size_t) slots * element_size);
+    return rb;
+}
+
+#if TDS_RINGBUFFER_MMAP
+tds_ringbuffer_t tds_ringbuffer_create_mapped(int fd, uint32_t capacity, size_t element_size) {
+    long page = sysconf(_SC_PAGESIZE);
+
+    if (fd < 0 || page <= 0 || capacity == 0 || capacity > TDS_RINGBUFFER_MAX_CAPACITY || element_size == 0 || element_size > UINT32_MAX) {
+        //printf("[ERROR] Invalid ring buffer parameters!\n");
+        return NULL;
+    }
+
+    /* Round up to a power of two, then until the slots fill whole pages */
+    uint32_t slots = 1;
+    while (slots < capacity || ((size_t) slots * element_size) % (size_t) page != 0) {
+        if (slots == TDS_RINGBUFFER_MAX_CAPACITY) {
+            //printf("[ERROR] Ring buffer slots cannot fill whole pages.\n");
+            return NULL;
+        }
+        slots <<= 1;
+    }
+
+    size_t header = tds_ringbuffer_map_header((size_t) page);
+    if (element_size > (SIZE_MAX / 2 - header) / slots) {
+        //printf("[ERROR] Ring buffer size overflows size_t.\n");
+        return NULL;
+    }
+
+    size_t data = (size_t) slots * element_size;
+    if (ftruncate(fd, (off_t) (header + data)) != 0) {
+        //printf("[ERROR] Failed to size the ring buffer file.\n");
+        return NULL;
+    }
+
+    tds_ringbuffer_t rb = tds_ringbuffer_map(fd, header, data);
+    if (!rb) {
+        return NULL;
+    }
+
+    tds_ringbuffer_init(rb, slots, element_size, header, 2 * slots);
+    rb->is_mapped = true;
+    return rb;
+}
+
+tds_ringbuffer_t tds_ringbuffer_attach(int fd) {
+    long        page = sysconf(_SC_PAGESIZE);
+    struct stat st;
+
+    if (fd < 0 || page <= 0 || fstat(fd, &st) != 0) {
+        //printf("[ERROR] Invalid ring buffer file!\n");
+        return NULL;
+    }
+
+    size_t header = tds_ringbuffer_map_header((size_t) page);
+    if ((uintmax_t) st.st_size < (uintmax_t) header) {
+        //printf("[ERROR] Ring buffer file is too small!\n");
+        return NULL;
+    }
+
+    struct tds_ringbuffer_instance_t* probe = (struct tds_ringbuffer_instance_t*) mmap(NULL, header, PROT_READ, MAP_SHARED, fd, 0);
+    if (probe == MAP_FAILED) {
+        //printf("[ERROR] Failed to map the ring buffer header.\n");
+        return NULL;
+    }
+
+    uint32_t slots    = probe->capacity;
+    uint32_t elements = probe->elements;
+    bool     valid    = probe->magic == TDS_RINGBUFFER_MAGIC && probe->version == TDS_RINGBUFFER_VERSION &&
+                 probe->layout == TDS_RINGBUFFER_HEADER_BYTES(1) && probe->consumers == 1 && probe->is_mapped && probe->offset == header &&
+                 slots != 0 && slots <= TDS_RINGBUFFER_MAX_CAPACITY && (slots & (slots - 1)) == 0 && probe->mask == slots - 1 &&
+                 probe->window == 2 * slots && elements != 0 && ((size_t) slots * elements) % (size_t) page == 0 &&
+                 (uintmax_t) st.st_size == (uintmax_t) header + (uintmax_t) slots * elements;
+    munmap(probe, header);
+
+    if (!valid) {
+        //printf("[ERROR] File does not hold a compatible ring buffer!\n");
+        return NULL;
+    }
+
+    return tds_ringbuffer_map(fd, header, (size_t) slots * elements);
+}
+#endif
+
+bool tds_ringbuffer_try_push(tds_ringbuffer_t instance, const void* data) {
+    if (!instance || !data) {
+        return false;
+    }
+
+    uint32_t head = atomic_load_explicit(&instance->head, memory_order_relaxed);
+    if (tds_ringbuffer_free_slots(instance, head, 1) == 0) {
+        TDS_STATS_ADD(instance, failed_full, 1);
+        return false;
+    }
+
+    memcpy(tds_ringbuffer_slot(instance, head), data, instance->elements);
+    atomic_store_explicit(&instance->head, head + 1, memory_order_release);
+    TDS_STATS_ADD(instance, operations, 1);
+    TDS_STATS_MAX(instance, high_water, tds_ringbuffer_fill(instance, head + 1));
+    return true;
+}
+
+bool tds_ringbuffer_try_pop(tds_ringbuffer_t instance, void* data) {
+    if (!instance || !data) {
+        return false;
+    }
+
+    return tds_ringbuffer_pop_one(instance, &instance->cursors[0], data);
+}
+
+uint32_t tds_ringbuffer_push_bulk(tds_ringbuffer_t instance, const void* data, uint32_t count) {
+    if (!instance || !data || count == 0) {
+        return 0;
+    }
+
+    uint32_t head       = atomic_load_explicit(&instance->head, memory_order_relaxed);
+    uint32_t free_slots = tds_ringbuffer_free_slots(instance, head, count);
+    if (count > free_slots) {
+        TDS_STATS_ADD(instance, failed_full, 1);
+        count = free_slots;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    tds_ringbuffer_copy_in(instance, head, (const uint8_t*) data, count);
+    atomic_store_explicit(&instance->head, head + count, memory_order_release);
+    TDS_STATS_ADD(instance, operations, count);
+    TDS_STATS_MAX(instance, high_water, tds_ringbuffer_fill(instance, head + count));
+    return count;
+}
+
+uint32_t tds_ringbuffer_pop_bulk(tds_ringbuffer_t instance, void* data, uint32_t count) {
+    if (!instance || !data || count == 0) {
+        return 0;
+    }
+
+    struct tds_ringbuffer_cursor_t* c    = &instance->cursors[0];
+    uint32_t                        tail = atomic_load_explicit(&c->position, memory_order_relaxed);
+    uint32_t                        used = tds_ringbuffer_used_slots(instance, c, tail, count);
+    if (count > used) {
+        TDS_STATS_ADD(instance, failed_empty, 1);
+        count = used;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    tds_ringbuffer_copy_out(instance, tail, (uint8_t*) data, count);
+    atomic_store_explicit(&c->position, tail + count, memory_order_release);
+    TDS_STATS_ADD(instance, operations, count);
+    return count;
+}
+
+void* tds_ringbuffer_reserve(tds_ringbuffer_t instance, uint32_t count, uint32_t* reserved) {
+    if (reserved) {
+        *reserved = 0;
+    }
+    if (!instance || !reserved || count == 0) {
+        return NULL;
+    }
+
+    uint32_t head       = atomic_load_explicit(&instance->head, memory_order_relaxed);
+    uint32_t slot       = head & instance->mask;
+    uint32_t contiguous = instance->window - slot;
+    if (count > contiguous) {
+        count = contiguous;
+    }
+
+    uint32_t free_slots = tds_ringbuffer_free_slots(instance, head, count);
+    if (count > free_slots) {
+        count = free_slots;
+    }
+
+    instance->reserved = count;
+    *reserved          = count;
+    return count ? tds_ringbuffer_slot(instance, head) : NULL;
+}
+
+bool tds_ringbuffer_commit(tds_ringbuffer_t instance, uint32_t count) {
+    if (!instance || count > instance->reserved) {
+        return false;
+    }
+
+    uint32_t head = atomic_load_explicit(&instance->head, memory_order_relaxed);
+    atomic_store_explicit(&instance->head, head + count, memory_order_release);
+    instance->reserved = 0;
+    TDS_STATS_ADD(instance, operations, count);
+    TDS_STATS_MAX(instance, high_water, tds_ringbuffer_fill(instance, head + count));
+    return true;
+}
+
+const void* tds_ringbuffer_peek_span(tds_ringbuffer_t instance, uint32_t* count) {
+    if (count) {
+        *count = 0;
+    }
+    if (!instance || !count) {
+        return NULL;
+    }
+
+    return tds_ringbuffer_span(instance, &instance->cursors[0], count);
+}
+
+uint32_t tds_ringbuffer_consume(tds_ringbuffer_t instance, uint32_t count) {
+    if (!instance || count == 0) {
+        return 0;
+    }
+
+    return tds_ringbuffer_release(instance, &instance->cursors[0], count);
+}
+
+bool tds_ringbuffer_peek(tds_ringbuffer_t instance, void* data) {
+    if (!instance || !data) {
+        return false;
+    }
+
+    struct tds_ringbuffer_cursor_t* c    = &instance->cursors[0];
+    uint32_t                        tail = atomic_load_explicit(&c->position, memory_order_relaxed);
+    if (tds_ringbuffer_used_slots(instance, c, tail, 1) == 0) {
+        TDS_STATS_ADD(instance, failed_empty, 1);
+        return false;
+    }
+
+    memcpy(data, tds_ringbuffer_slot(instance, tail), instance->elements);
+    TDS_STATS_ADD(instance, operations, 1);
+    return true;
+}
+
+bool tds_ringbuffer_broadcast_pop(tds_ringbuffer_t instance, uint32_t consumer, void* data) {
+    if (!instance || consumer >= instance->consumers || !data) {
+        return false;
+    }
+
+    return tds_ringbuffer_pop_one(instance, &instance->cursors[consumer], data);
+}
+
+const void* tds_ringbuffer_broadcast_peek_span(tds_ringbuffer_t instance, uint32_t consumer, uint32_t* count) {
+    if (!instance || consumer >= instance->consumers || !count) {
+        return NULL;
+    }
+
+    return tds_ringbuffer_span(instance, &instance->cursors[consumer], count);
+}
+
+uint32_t tds_ringbuffer_broadcast_consume(tds_ringbuffer_t instance, uint32_t consumer, uint32_t count) {
+    if (!instance || consumer >= instance->consumers || count == 0) {
+        return 0;
+    }
+
+    return tds_ringbuffer_release(instance, &instance->cursors[consumer], count);
+}
+
+int tds_ringbuffer_size(tds_ringbuffer_t instance) {
+    if (!instance) {
+        return -1;
+    }
+
+    uint32_t head = atomic_load_explicit(&instance->head, memory_order_acquire);
+    return (int) (head - tds_ringbuffer_slowest(instance, head, memory_order_acquire));
+}
+
+int tds_ringbuffer_capacity(tds_ringbuffer_t instance) {
+    if (!instance) {
+        return -1;
+    }
+    return (int) instance->capacity;
+}
+
+bool tds_ringbuffer_empty(tds_ringbuffer_t instance) {
+    return tds_ringbuffer_size(instance) <= 0;
+}
+
+bool tds_ringbuffer_full(tds_ringbuffer_t instance) {
+    if (!instance) {
+        return true;
+    }
+    return (uint32_t) tds_ringbuffer_size(instance) >= instance->capacity;
+}
+
+bool tds_ringbuffer_get_stats(tds_ringbuffer_t instance, tds_stats_t* stats) {
+    if (!instance || !stats) {
+        return false;
+    }
+
+    return TDS_STATS_READ(instance, stats);
+}
+
+#if TDS_SNAPSHOT
+bool tds_ringbuffer_snapshot(tds_ringbuffer_t instance, int fd) {
+    if (!instance || fd < 0) {
+        return false;
+    }
+
+    uint32_t              head  = atomic_load_explicit(&instance->head, memory_order_acquire);
+    uint32_t              tail  = tds_ringbuffer_slowest(instance, head, memory_order_acquire);
+    uint32_t              count = head - tail;
+    tds_snapshot_header_t header;
+    tds_snapshot_writer_t writer;
+
+    tds_snapshot_header_init(&header, TDS_SNAPSHOT_RINGBUFFER);
+    header.element_size = instance->elements;
+    header.capacity     = instance->capacity;
+    header.count        = count;
+    header.consumers    = instance->consumers;
+    header.data_size    = (uint64_t) instance->consumers * 2 * sizeof(uint32_t) + (uint64_t) count * instance->elements;
+    if (!tds_snapshot_write_begin(&writer, fd, &header)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < instance->consumers; i++) {
+        uint32_t cursor[2] = {instance->cursors[i].depends, head - atomic_load_explicit(&instance->cursors[i].position, memory_order_acquire)};
+        tds_snapshot_write(&writer, cursor, sizeof(cursor));
+    }
+
+    uint32_t slot  = tail & instance->mask;
+    uint32_t first = instance->window - slot;
+    if (first > count) {
+        first = count;
+    }
+    tds_snapshot_write(&writer, tds_ringbuffer_slot(instance, tail), (size_t) first * instance->elements);
+    tds_snapshot_write(&writer, (uint8_t*) instance + instance->offset, (size_t) (count - first) * instance->elements);
+    return tds_snapshot_write_end(&writer);
+}
+
+tds_ringbuffer_t tds_ringbuffer_load(const char* path) {
+    tds_snapshot_header_t header;
+    size_t                length;
+    const uint8_t*        data = tds_snapshot_map(path, TDS_SNAPSHOT_RINGBUFFER, &header, &length);
+    if (!data) {
+        return NULL;
+    }
+
+    uint32_t         consumers = header.consumers;
+    uint32_t         depends[TDS_RINGBUFFER_MAX_CONSUMERS];
+    uint32_t         pending[TDS_RINGBUFFER_MAX_CONSUMERS];
+    tds_ringbuffer_t rb    = NULL;
+    bool             valid = consumers >= 1 && consumers <= TDS_RINGBUFFER_MAX_CONSUMERS && header.count <= header.capacity &&
+                 header.data_size == (uint64_t) consumers * 2 * sizeof(uint32_t) + (uint64_t) header.count * header.element_size;
+
+    /* A consumer never gets ahead of the consumers it depends on */
+    for (uint32_t i = 0; valid && i < consumers; i++) {
+        memcpy(&depends[i], data + (size_t) i * 2 * sizeof(uint32_t), sizeof(uint32_t));
+        memcpy(&pending[i], data + (size_t) i * 2 * sizeof(uint32_t) + sizeof(uint32_t), sizeof(uint32_t));
+        valid = pending[i] <= header.count;
+        for (uint32_t j = 0; valid && j < i; j++) {
+            valid = !(depends[i] & (UINT32_C(1) << j)) || pending[i] >= pending[j];
+        }
+    }
+
+    if (valid) {
+        rb = consumers == 1 && depends[0] == 0 ? tds_ringbuffer_create(header.capacity, header.element_size)
+                                               : tds_ringbuffer_create_broadcast(header.capacity, header.element_size, consumers, depends);
+    }
+
+    if (rb && tds_ringbuffer_push_bulk(rb, data + (size_t) consumers * 2 * sizeof(uint32_t), header.count) == header.count) {
+        for (uint32_t i = 0; i < consumers; i++) {
+            atomic_store_explicit(&rb->cursors[i].position, header.count - pending[i], memory_order_relaxed);
+        }
+    } else if (rb) {
+        //printf("[ERROR] Snapshot elements do not fit the ring buffer!\n");
+        tds_ringbuffer_destroy(rb);
+        rb = NULL;
+    }
+
+    tds_snapshot_unmap(data, &header, length);
+    return rb;
+}
+#endif
+
+bool tds_ringbuffer_destroy(tds_ringbuffer_t instance) {
+    if (!instance) {
+        return false;
+    }
+
+#if TDS_RINGBUFFER_MMAP
+    if (instance->is_mapped) {
+        return munmap(instance, instance->offset + 2 * (size_t) instance->capacity * instance->elements) == 0;
+    }
+#endif
+    if (!instance->is_static) {
+        TDS_FREE(instance);
+    }
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RINGBUFFER_C
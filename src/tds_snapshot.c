@@ -0,0 +1,182 @@
+/******************************************************************************
+ * File: tds_snapshot.c
+ * Author: Tiago Barbosa
+ * Description: Binary snapshot format shared by the containers that can be
+ *              saved to a file and loaded back (tds_queue_snapshot(),
+ *              tds_ringbuffer_snapshot(), tds_hashtable_snapshot() and the
+ *              matching tds_*_load()): the writer and loader they use.
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef SNAPSHOT_C
+#define SNAPSHOT_C
+
+#define _DEFAULT_SOURCE  // For posix_madvise() under -std=c11
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include "tds_snapshot_internal.h"
+
+#if TDS_SNAPSHOT
+
+#include <errno.h>     // For EINTR
+#include <fcntl.h>     // For open
+#include <string.h>    // For memcpy, memset
+#include <sys/mman.h>  // For mmap, munmap, posix_madvise
+#include <sys/stat.h>  // For fstat
+#include <unistd.h>    // For write, close
+
+/* Private Functions --------------------------------------------------------*/
+
+/**
+ * @brief Writes all of size bytes, resuming after short writes and signals.
+ */
+static bool tds_snapshot_write_all(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            //printf("[ERROR] Failed to write the snapshot.\n");
+            return false;
+        }
+        data += n;
+        size -= (size_t) n;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks that the fields owned by the other kinds and reserved are zero.
+ */
+static bool tds_snapshot_fields_valid(const tds_snapshot_header_t* header) {
+    uint32_t foreign = header->reserved;
+    if (header->kind != TDS_SNAPSHOT_QUEUE) {
+        foreign |= header->queue_mode;
+    }
+    if (header->kind != TDS_SNAPSHOT_RINGBUFFER) {
+        foreign |= header->consumers;
+    }
+    if (header->kind != TDS_SNAPSHOT_HASHTABLE) {
+        foreign |= header->key_size | header->slot_size | header->tombstones;
+    }
+    return foreign == 0;
+}
+
+static void tds_snapshot_flush(tds_snapshot_writer_t* writer) {
+    if (!writer->failed && writer->used) {
+        writer->failed = !tds_snapshot_write_all(writer->fd, writer->buffer, writer->used);
+    }
+    writer->used = 0;
+}
+
+/* Public Functions ---------------------------------------------------------*/
+
+void tds_snapshot_header_init(tds_snapshot_header_t* header, tds_snapshot_kind_t kind) {
+    memset(header, 0, sizeof(*header));
+    header->magic       = TDS_SNAPSHOT_MAGIC;
+    header->version     = TDS_SNAPSHOT_VERSION;
+    header->kind        = (uint16_t) kind;
+    header->byte_order  = TDS_SNAPSHOT_BYTE_ORDER;
+    header->data_offset = sizeof(tds_snapshot_header_t);
+}
+
+bool tds_snapshot_write_begin(tds_snapshot_writer_t* writer, int fd, const tds_snapshot_header_t* header) {
+    writer->fd        = fd;
+    writer->used      = 0;
+    writer->remaining = header->data_size;
+    writer->failed    = fd < 0 || header->data_offset != sizeof(tds_snapshot_header_t) ||
+                     !tds_snapshot_write_all(fd, (const uint8_t*) header, sizeof(tds_snapshot_header_t));
+    return !writer->failed;
+}
+
+void tds_snapshot_write(tds_snapshot_writer_t* writer, const void* data, size_t size) {
+    if (writer->failed || size > writer->remaining) {
+        writer->failed = true;
+        return;
+    }
+    writer->remaining -= size;
+
+    // Large arrays skip the buffer
+    if (data && size >= TDS_SNAPSHOT_BUFFER_SIZE) {
+        tds_snapshot_flush(writer);
+        writer->failed = writer->failed || !tds_snapshot_write_all(writer->fd, (const uint8_t*) data, size);
+        return;
+    }
+
+    const uint8_t* src = (const uint8_t*) data;
+    while (size > 0) {
+        size_t n = TDS_SNAPSHOT_BUFFER_SIZE - writer->used;
+        n        = n < size ? n : size;
+        if (src) {
+            memcpy(writer->buffer + writer->used, src, n);
+            src += n;
+        } else {
+            memset(writer->buffer + writer->used, 0, n);
+        }
+        writer->used += (uint32_t) n;
+        size -= n;
+        if (writer->used == TDS_SNAPSHOT_BUFFER_SIZE) {
+            tds_snapshot_flush(writer);
+        }
+    }
+}
+
+bool tds_snapshot_write_end(tds_snapshot_writer_t* writer) {
+    tds_snapshot_flush(writer);
+    return !writer->failed && writer->remaining == 0;
+}
+
+const uint8_t* tds_snapshot_map(const char* path, tds_snapshot_kind_t kind, tds_snapshot_header_t* header, size_t* length) {
+    struct stat st;
+    int         fd = path ? open(path, O_RDONLY | O_CLOEXEC) : -1;
+    if (fd < 0) {
+        //printf("[ERROR] Failed to open the snapshot.\n");
+        return NULL;
+    }
+
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(tds_snapshot_header_t) || (uintmax_t) st.st_size > SIZE_MAX) {
+        //printf("[ERROR] Snapshot file is too small!\n");
+        close(fd);
+        return NULL;
+    }
+
+    *length    = (size_t) st.st_size;
+    void* base = mmap(NULL, *length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        //printf("[ERROR] Failed to map the snapshot.\n");
+        return NULL;
+    }
+    posix_madvise(base, *length, POSIX_MADV_SEQUENTIAL);
+
+    memcpy(header, base, sizeof(tds_snapshot_header_t));
+    if (header->magic != TDS_SNAPSHOT_MAGIC || header->version != TDS_SNAPSHOT_VERSION || header->kind != (uint16_t) kind ||
+        header->byte_order != TDS_SNAPSHOT_BYTE_ORDER || header->data_offset != sizeof(tds_snapshot_header_t) ||
+        header->data_size != *length - sizeof(tds_snapshot_header_t) || !tds_snapshot_fields_valid(header)) {
+        //printf("[ERROR] File is not a compatible snapshot!\n");
+        munmap(base, *length);
+        return NULL;
+    }
+
+    return (const uint8_t*) base + header->data_offset;
+}
+
+void tds_snapshot_unmap(const uint8_t* data, const tds_snapshot_header_t* header, size_t length) {
+    if (data) {
+        munmap((void*) (data - header->data_offset), length);
+    }
+}
+
+#endif  // TDS_SNAPSHOT
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SNAPSHOT_C
@@ -0,0 +1,107 @@
+/******************************************************************************
+ * File: tds_snapshot_internal.h
+ * Author: Tiago Barbosa
+ * Description: Writer and loader of the snapshot format (tds_snapshot.h),
+ *              shared by the containers' tds_*_snapshot()/tds_*_load().
+ *              Private to the library: not installed with include/.
+ * Created on: 04/02/2025
+ * Version: 1.0
+ ******************************************************************************/
+
+#ifndef SNAPSHOT_INTERNAL_H
+#define SNAPSHOT_INTERNAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes -----------------------------------------------------------------*/
+#include "tds_snapshot.h"
+
+#if TDS_SNAPSHOT
+
+/* Typedefs -----------------------------------------------------------------*/
+/**
+ * @brief Buffered sequential writer of one snapshot.
+ */
+typedef struct {
+    int      fd;
+    bool     failed;    /**< A write failed; the rest is skipped */
+    uint32_t used;      /**< Bytes waiting in buffer */
+    uint64_t remaining; /**< Data bytes announced by the header and not written yet */
+    uint8_t  buffer[TDS_SNAPSHOT_BUFFER_SIZE];
+} tds_snapshot_writer_t;
+
+/* Function Prototypes ------------------------------------------------------*/
+
+/**
+ * @brief Fills the fixed fields of a header (magic, version, byte order, offset).
+ *
+ * @param header The header to initialize; every other field is zeroed.
+ * @param kind The container stored.
+ */
+void tds_snapshot_header_init(tds_snapshot_header_t* header, tds_snapshot_kind_t kind);
+
+/**
+ * @brief Writes header at the current offset of fd and prepares the writer.
+ *
+ * @param writer The writer.
+ * @param fd File descriptor opened for writing, normally positioned at the start of an empty file.
+ * @param header The complete header, data_size included.
+ * @return true If the header was written.
+ * @return false On a write error.
+ */
+bool tds_snapshot_write_begin(tds_snapshot_writer_t* writer, int fd, const tds_snapshot_header_t* header);
+
+/**
+ * @brief Appends size bytes of data (NULL writes zeros).
+ *
+ * Errors are remembered and reported by tds_snapshot_write_end().
+ *
+ * @param writer The writer.
+ * @param data Bytes to append, or NULL for zeros.
+ * @param size Number of bytes.
+ */
+void tds_snapshot_write(tds_snapshot_writer_t* writer, const void* data, size_t size);
+
+/**
+ * @brief Flushes the writer.
+ *
+ * @param writer The writer.
+ * @return true If every byte was written and exactly data_size data bytes were appended.
+ * @return false Otherwise.
+ */
+bool tds_snapshot_write_end(tds_snapshot_writer_t* writer);
+
+/**
+ * @brief Maps a snapshot file read-only and validates its header.
+ *
+ * The whole file is mapped with sequential read-ahead, so copying the data
+ * out runs at the speed of the page cache or the disk. Besides magic,
+ * version, byte order and kind, the fields owned by other kinds and
+ * reserved must be zero.
+ *
+ * @param path Path of the snapshot file.
+ * @param kind The container expected.
+ * @param header Where to copy the header.
+ * @param length Where to store the mapping length, for tds_snapshot_unmap().
+ * @return const uint8_t* Start of the data (header->data_offset into the file), or NULL if the file is not a valid snapshot of kind.
+ */
+const uint8_t* tds_snapshot_map(const char* path, tds_snapshot_kind_t kind, tds_snapshot_header_t* header, size_t* length);
+
+/**
+ * @brief Releases a mapping returned by tds_snapshot_map().
+ *
+ * @param data The pointer returned by tds_snapshot_map().
+ * @param header The header it filled.
+ * @param length The length it stored.
+ */
+void tds_snapshot_unmap(const uint8_t* data, const tds_snapshot_header_t* header, size_t length);
+
+#endif  // TDS_SNAPSHOT
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SNAPSHOT_INTERNAL_H
@@ -18,6 +18,263 @@ extern "C" {
 /* Includes -----------------------------------------------------------------*/
 #include "tds_stack.h"
 
+#include <stdatomic.h>  // For the lock-free mode
+
+#include "tds_config.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define TDS_STACK_LF_NONE UINT32_MAX /**< Index terminating a lock-free list */
+
+/* Typedefs -----------------------------------------------------------------*/
+
+/**
+ * @brief Node of a lock-free stack. Nodes live in one array and link by index.
+ */
+struct tds_stack_lf_node_t {
+    _Atomic uint32_t              next; /**< Index of the next node, or TDS_STACK_LF_NONE */
+    _Alignas(max_align_t) uint8_t data[];
+};
+
+/**
+ * @brief State of a lock-free stack.
+ *
+ * Both list heads pack a node index (low 32 bits) with a tag (high 32 bits)
+ * bumped by every successful compare-and-swap: a head that was taken and put
+ * back meanwhile no longer compares equal, so a stale next index can never
+ * be installed (ABA).
+ */
+struct tds_stack_lockfree_t {
+    _Atomic uint64_t top;  /**< Stacked elements */
+    uint8_t          pad0[TDS_CACHE_LINE_SIZE - sizeof(uint64_t)];
+    _Atomic uint64_t free; /**< Unused nodes */
+    uint8_t          pad1[TDS_CACHE_LINE_SIZE - sizeof(uint64_t)];
+    uint8_t*         nodes;
+    size_t           stride; /**< Bytes per node (next + element, aligned) */
+};
+
+/* Private Functions --------------------------------------------------------*/
+
+static inline struct tds_stack_lf_node_t* tds_stack_lf_node(struct tds_stack_lockfree_t* lf, uint32_t index) {
+    return (struct tds_stack_lf_node_t*) (lf->nodes + (size_t) index * lf->stride);
+}
+
+static inline uint64_t tds_stack_lf_pack(uint64_t old_head, uint32_t index) {
+    return (((old_head >> 32) + 1) << 32) | index;
+}
+
+/**
+ * @brief Unlinks the first node of a lock-free list.
+ *
+ * @return Index of the node, now owned by the caller, or TDS_STACK_LF_NONE.
+ */
+static uint32_t tds_stack_lf_take(tds_stack_t instance, _Atomic uint64_t* head) {
+    struct tds_stack_lockfree_t* lf  = instance->lockfree;
+    uint64_t                     old = atomic_load_explicit(head, memory_order_acquire);
+    for (;;) {
+        uint32_t index = (uint32_t) old;
+        if (index == TDS_STACK_LF_NONE) {
+            return TDS_STACK_LF_NONE;
+        }
+        // May read a node that another thread just took; the tag makes the CAS fail then
+        uint32_t next = atomic_load_explicit(&tds_stack_lf_node(lf, index)->next, memory_order_relaxed);
+        if (atomic_compare_exchange_weak_explicit(head, &old, tds_stack_lf_pack(old, next), memory_order_acquire, memory_order_acquire)) {
+            return index;
+        }
+        TDS_STATS_ADD(instance, retries, 1);
+    }
+}
+
+/**
+ * @brief Links an owned node in front of a lock-free list.
+ */
+static void tds_stack_lf_put(tds_stack_t instance, _Atomic uint64_t* head, uint32_t index) {
+    struct tds_stack_lf_node_t* node = tds_stack_lf_node(instance->lockfree, index);
+    uint64_t                    old  = atomic_load_explicit(head, memory_order_relaxed);
+    for (;;) {
+        atomic_store_explicit(&node->next, (uint32_t) old, memory_order_relaxed);
+        if (atomic_compare_exchange_weak_explicit(head, &old, tds_stack_lf_pack(old, index), memory_order_release, memory_order_relaxed)) {
+            return;
+        }
+        TDS_STATS_ADD(instance, retries, 1);
+    }
+}
+
+static bool tds_stack_lf_push(tds_stack_t instance, const void* data) {
+    struct tds_stack_lockfree_t* lf    = instance->lockfree;
+    uint32_t                     index = tds_stack_lf_take(instance, &lf->free);
+    if (index == TDS_STACK_LF_NONE) {
+        //printf("[ERROR] Stack is full! Maximum capacity reached (%u elements).\n", instance->capacity);
+        TDS_STATS_ADD(instance, failed_full, 1);
+        return false;
+    }
+
+    memcpy(tds_stack_lf_node(lf, index)->data, data, instance->elements);
+    tds_stack_lf_put(instance, &lf->top, index);
+    TDS_STATS_ADD(instance, operations, 1);
+    return true;
+}
+
+static bool tds_stack_lf_pop(tds_stack_t instance, void* data) {
+    struct tds_stack_lockfree_t* lf    = instance->lockfree;
+    uint32_t                     index = tds_stack_lf_take(instance, &lf->top);
+    if (index == TDS_STACK_LF_NONE) {
+        //printf("[ERROR] Stack is empty!\n");
+        TDS_STATS_ADD(instance, failed_empty, 1);
+        return false;
+    }
+
+    memcpy(data, tds_stack_lf_node(lf, index)->data, instance->elements);
+    tds_stack_lf_put(instance, &lf->free, index);
+    TDS_STATS_ADD(instance, operations, 1);
+    return true;
+}
+
+/**
+ * @brief Copies the top element of a lock-free stack.
+ *
+ * The copy is retried until the tagged top is the same before and after it,
+ * which proves the node was not popped (and possibly reused) meanwhile.
+ */
+static bool tds_stack_lf_peek(tds_stack_t instance, void* data) {
+    struct tds_stack_lockfree_t* lf  = instance->lockfree;
+    uint64_t                     top = atomic_load_explicit(&lf->top, memory_order_acquire);
+    for (;;) {
+        if ((uint32_t) top == TDS_STACK_LF_NONE) {
+            TDS_STATS_ADD(instance, failed_empty, 1);
+            return false;
+        }
+        memcpy(data, tds_stack_lf_node(lf, (uint32_t) top)->data, instance->elements);
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t again = atomic_load_explicit(&lf->top, memory_order_acquire);
+        if (again == top) {
+            TDS_STATS_ADD(instance, operations, 1);
+            return true;
+        }
+        TDS_STATS_ADD(instance, retries, 1);
+        top = again;
+    }
+}
+
+_Static_assert(sizeof(struct tds_stack_lockfree_t) <= TDS_STACK_LOCKFREE_STATE_SIZE, "TDS_STACK_LOCKFREE_STATE_SIZE too small");
+_Static_assert(sizeof(struct tds_stack_lf_node_t) == _Alignof(max_align_t), "TDS_STACK_LOCKFREE_NODE_SIZE out of date");
+
+/**
+ * @brief Computes the node stride of a lock-free stack.
+ *
+ * @return Bytes per node, or 0 if the parameters are invalid or overflow.
+ */
+static size_t tds_stack_lf_layout(uint32_t capacity, size_t element_size) {
+    size_t align = _Alignof(struct tds_stack_lf_node_t);
+    if (capacity == 0 || capacity >= TDS_STACK_LF_NONE || element_size > SIZE_MAX - sizeof(struct tds_stack_lf_node_t) - align) {
+        return 0;
+    }
+
+    size_t stride = (sizeof(struct tds_stack_lf_node_t) + element_size + align - 1) & ~(align - 1);
+    return stride > SIZE_MAX / capacity ? 0 : stride;
+}
+
+/**
+ * @brief Links every node of a lock-free stack into its free list.
+ */
+static void tds_stack_lf_init(struct tds_stack_lockfree_t* lf, uint8_t* nodes, size_t stride, uint32_t capacity) {
+    lf->nodes  = nodes;
+    lf->stride = stride;
+
+    for (uint32_t i = 0; i < capacity; i++) {
+        atomic_init(&tds_stack_lf_node(lf, i)->next, i + 1 < capacity ? i + 1 : TDS_STACK_LF_NONE);
+    }
+    atomic_init(&lf->top, TDS_STACK_LF_NONE);
+    atomic_init(&lf->free, 0);
+}
+
+static struct tds_stack_lockfree_t* tds_stack_lf_create(uint32_t capacity, size_t element_size) {
+    size_t stride = tds_stack_lf_layout(capacity, element_size);
+    if (!stride) {
+        return NULL;
+    }
+
+    struct tds_stack_lockfree_t* lf = (struct tds_stack_lockfree_t*) TDS_MALLOC(sizeof(struct tds_stack_lockfree_t));
+    if (!lf) {
+        return NULL;
+    }
+    uint8_t* nodes = (uint8_t*) TDS_MALLOC((size_t) capacity * stride);
+    if (!nodes) {
+        //printf("[ERROR] Failed to allocate memory for the lock-free nodes.\n");
+        TDS_FREE(lf);
+        return NULL;
+    }
+
+    tds_stack_lf_init(lf, nodes, stride, capacity);
+    return lf;
+}
+
+/**
+ * @brief Validates the parameters shared by create_ex and init_static.
+ */
+static bool tds_stack_check(size_t element_size, const tds_stack_config_t* config) {
+    if (element_size == 0 || element_size > UINT32_MAX) {
+        //printf("[ERROR] Element size is invalid!\n");
+        return false;
+    }
+
+    if (config->mode != TDS_STACK_MODE_LINKED && config->mode != TDS_STACK_MODE_ARRAY && config->mode != TDS_STACK_MODE_LOCKFREE) {
+        //printf("[ERROR] Unknown stack mode %d!\n", config->mode);
+        return false;
+    }
+
+    if (config->allocator && !config->allocator->alloc) {
+        //printf("[ERROR] Allocator callbacks are incomplete!\n");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Fills a stack instance; the array buffer and lock-free state are set by the caller.
+ */
+static void tds_stack_init(tds_stack_t stack, uint32_t capacity, size_t element_size, const tds_stack_config_t* config, bool is_static) {
+    stack->mode      = config->mode;
+    stack->top       = NULL;
+    stack->allocator = config->allocator ? *config->allocator : *tds_allocator_default();
+    stack->buffer    = NULL;
+    stack->allocated = 0;
+    stack->chunk     = 0;
+    stack->lockfree  = NULL;
+    stack->capacity  = capacity;
+    stack->size      = 0;
+    stack->elements  = element_size;
+    stack->is_static = is_static;
+    TDS_STATS_INIT(stack);
+}
+
+/**
+ * @brief Makes room for count more elements in array mode, growing by whole chunks.
+ *
+ * @return Number of elements (at most count) that fit after growing.
+ */
+static uint32_t tds_stack_array_reserve(tds_stack_t instance, uint32_t count) {
+    uint32_t needed = instance->size + count;
+    if (needed > instance->allocated && instance->chunk) {
+        uint64_t slots = (uint64_t) instance->allocated + instance->chunk * (((uint64_t) needed - instance->allocated + instance->chunk - 1) / instance->chunk);
+        if (slots > instance->capacity) {
+            slots = instance->capacity;
+        }
+
+        uint8_t* buffer = (uint8_t*) TDS_REALLOC(instance->buffer, (size_t) slots * instance->elements);
+        if (buffer) {
+            TDS_STATS_ALLOC(instance, (size_t) slots * instance->elements);
+            instance->buffer    = buffer;
+            instance->allocated = (uint32_t) slots;
+        }
+        //printf("[LOG] Stack array grown to %u elements.\n", instance->allocated);
+    }
+
+    return needed > instance->allocated ? instance->allocated - instance->size : count;
+}
+
+/* Public Functions ---------------------------------------------------------*/
+
 /**
  * @brief Creates a new stack instance.
  *
@@ -29,23 +286,140 @@ extern "C" {
  * @return tds_stack_t A handle to the created stack instance.
  */
 tds_stack_t tds_stack_create(uint32_t capacity, size_t element_size) {
+    return tds_stack_create_ex(capacity, element_size, NULL);
+}
+
+/**
+ * @brief Creates a new stack instance with an explicit configuration.
+ *
+ * @param capacity The maximum number of elements the stack can hold.
+ * @param element_size The size of each element in bytes.
+ * @param config Stack configuration, or NULL for TDS_STACK_CONFIG_DEFAULT.
+ * @return tds_stack_t A handle to the created stack instance, or NULL on failure.
+ */
+tds_stack_t tds_stack_create_ex(uint32_t capacity, size_t element_size, const tds_stack_config_t* config) {
+    static const tds_stack_config_t default_config = TDS_STACK_CONFIG_DEFAULT;
+
     //printf("[LOG] Creating stack with capacity %u and element size of %zu bytes...\n", capacity, element_size);
 
-    tds_stack_t stack = (tds_stack_t) malloc(sizeof(struct tds_stack_instance_t));
+    if (!config) {
+        config = &default_config;
+    }
+
+    if (!tds_stack_check(element_size, config)) {
+        return NULL;
+    }
+
+    tds_stack_t stack = (tds_stack_t) TDS_MALLOC(sizeof(struct tds_stack_instance_t));
     if (!stack) {
         //printf("[ERROR] Failed to allocate memory for the stack.\n");
         return NULL;
     }
 
-    stack->top      = NULL;
-    stack->capacity = capacity;
-    stack->size     = 0;
-    stack->elements = element_size;
+    tds_stack_init(stack, capacity, element_size, config, false);
+
+    if (config->mode == TDS_STACK_MODE_ARRAY) {
+        stack->chunk     = config->chunk < capacity ? config->chunk : 0;
+        stack->allocated = stack->chunk ? stack->chunk : capacity;
+        if (element_size > SIZE_MAX / (capacity ? capacity : 1)) {
+            TDS_FREE(stack);
+            return NULL;
+        }
+        if (stack->allocated) {
+            stack->buffer = (uint8_t*) TDS_MALLOC((size_t) stack->allocated * element_size);
+            if (!stack->buffer) {
+                //printf("[ERROR] Failed to allocate memory for the stack array.\n");
+                TDS_FREE(stack);
+                return NULL;
+            }
+            TDS_STATS_ALLOC(stack, (size_t) stack->allocated * element_size);
+        }
+    }
+
+    if (config->mode == TDS_STACK_MODE_LOCKFREE) {
+        stack->lockfree = tds_stack_lf_create(capacity, element_size);
+        if (!stack->lockfree) {
+            TDS_FREE(stack);
+            return NULL;
+        }
+        TDS_STATS_ALLOC(stack, (size_t) capacity * stack->lockfree->stride);
+    }
 
     //printf("[LOG] Stack created successfully!\n");
     return stack;
 }
 
+/**
+ * @brief Builds a stack inside caller-provided storage, without touching the heap.
+ *
+ * @param storage Memory aligned to max_align_t, valid until the stack is destroyed.
+ * @param storage_size Size of storage in bytes.
+ * @param capacity The maximum number of elements the stack can hold.
+ * @param element_size The size of each element in bytes.
+ * @param config Stack configuration, or NULL for TDS_STACK_MODE_ARRAY.
+ * @return tds_stack_t A handle to the stack (pointing into storage), or NULL on failure.
+ */
+tds_stack_t tds_stack_init_static(void* storage, size_t storage_size, uint32_t capacity, size_t element_size, const tds_stack_config_t* config) {
+    static const tds_stack_config_t default_config = {.mode = TDS_STACK_MODE_ARRAY, .allocator = NULL, .chunk = 0};
+    size_t                          header         = TDS_STACK_INSTANCE_SIZE;
+    uint8_t*                        area           = (uint8_t*) storage + header;
+
+    if (!config) {
+        config = &default_config;
+    }
+
+    if (!storage || (uintptr_t) storage % _Alignof(max_align_t) != 0 || storage_size < header || !tds_stack_check(element_size, config)) {
+        //printf("[ERROR] Stack storage is missing, misaligned or too small!\n");
+        return NULL;
+    }
+    storage_size -= header;
+
+    if (config->mode == TDS_STACK_MODE_LINKED && !config->allocator) {
+        //printf("[ERROR] A static linked stack needs an allocator for its nodes!\n");
+        return NULL;
+    }
+
+    if (config->mode == TDS_STACK_MODE_ARRAY && capacity && element_size > storage_size / capacity) {
+        //printf("[ERROR] Stack storage is too small!\n");
+        return NULL;
+    }
+
+    size_t stride = 0;
+    if (config->mode == TDS_STACK_MODE_LOCKFREE) {
+        size_t state = TDS_MEMORY_ROUND(sizeof(struct tds_stack_lockfree_t));
+        stride       = tds_stack_lf_layout(capacity, element_size);
+        if (!stride || storage_size < state || (size_t) capacity > (storage_size - state) / stride) {
+            //printf("[ERROR] Stack storage is too small!\n");
+            return NULL;
+        }
+    }
+
+    tds_stack_t stack = (tds_stack_t) storage;
+    tds_stack_init(stack, capacity, element_size, config, true);
+
+    if (config->mode == TDS_STACK_MODE_ARRAY) {
+        stack->buffer    = capacity ? area : NULL;
+        stack->allocated = capacity;
+    }
+
+    if (config->mode == TDS_STACK_MODE_LOCKFREE) {
+        stack->lockfree = (struct tds_stack_lockfree_t*) area;
+        tds_stack_lf_init(stack->lockfree, area + TDS_MEMORY_ROUND(sizeof(struct tds_stack_lockfree_t)), stride, capacity);
+    }
+
+    return stack;
+}
+
+/**
+ * @brief Returns the size of one stack node holding an element.
+ *
+ * @param element_size The size of each element in bytes.
+ * @return size_t Bytes requested from the allocator per pushed element.
+ */
+size_t tds_stack_node_size(size_t element_size) {
+    return sizeof(struct tds_stack_node_t) + element_size;
+}
+
 /**
  * @brief Pushes a new element onto the stack.
  *
@@ -62,31 +436,46 @@ bool tds_stack_push(tds_stack_t instance, const void *data) {
         //printf("[ERROR] Stack is not initialized!\n");
         return false;
     }
+
+    if (instance->mode == TDS_STACK_MODE_LOCKFREE) {
+        return tds_stack_lf_push(instance, data);
+    }
+
     if (instance->size >= instance->capacity) {
         //printf("[ERROR] Stack is full! Maximum capacity reached (%u elements).\n", instance->capacity);
+        TDS_STATS_ADD(instance, failed_full, 1);
         return false;
     }
 
+    if (instance->mode == TDS_STACK_MODE_ARRAY) {
+        if (instance->size == instance->allocated && tds_stack_array_reserve(instance, 1) == 0) {
+            TDS_STATS_ADD(instance, failed_full, 1);  // Growth failed
+            return false;
+        }
+        memcpy(instance->buffer + (size_t) instance->size * instance->elements, data, instance->elements);
+        instance->size++;
+        TDS_STATS_ADD(instance, operations, 1);
+        TDS_STATS_MAX(instance, high_water, instance->size);
+        return true;
+    }
+
     //printf("[LOG] Inserting element %u into the stack...\n", instance->size + 1);
 
-    struct tds_stack_node_t *new_node = (struct tds_stack_node_t *) malloc(sizeof(struct tds_stack_node_t));
+    struct tds_stack_node_t *new_node = (struct tds_stack_node_t *) instance->allocator.alloc(instance->allocator.context, tds_stack_node_size(instance->elements));
     if (!new_node) {
         //printf("[ERROR] Failed to allocate memory for new node.\n");
+        TDS_STATS_ADD(instance, failed_full, 1);
         return false;
     }
-
-    new_node->data = malloc(instance->elements);
-    if (!new_node->data) {
-        //printf("[ERROR] Failed to allocate memory for the node data.\n");
-        free(new_node);
-        return false;
-    }
+    TDS_STATS_ALLOC(instance, tds_stack_node_size(instance->elements));
 
     memcpy(new_node->data, data, instance->elements);
 
     new_node->next = instance->top;
     instance->top  = new_node;
     instance->size++;
+    TDS_STATS_ADD(instance, operations, 1);
+    TDS_STATS_MAX(instance, high_water, instance->size);
 
     //printf("[LOG] Element inserted successfully! Current stack size: %u\n", instance->size);
     return true;
@@ -108,11 +497,24 @@ bool tds_stack_pop(tds_stack_t instance, void *data) {
         return false;
     }
 
+    if (instance->mode == TDS_STACK_MODE_LOCKFREE) {
+        return tds_stack_lf_pop(instance, data);
+    }
+
     if (instance->size == 0) {
         //printf("[ERROR] Stack is empty!\n");
+        TDS_STATS_ADD(instance, failed_empty, 1);
         return false;
     }
 
+    TDS_STATS_ADD(instance, operations, 1);
+
+    if (instance->mode == TDS_STACK_MODE_ARRAY) {
+        instance->size--;
+        memcpy(data, instance->buffer + (size_t) instance->size * instance->elements, instance->elements);
+        return true;
+    }
+
     struct tds_stack_node_t *node_to_remove = instance->top;  // Node to be removed
 
     // Copy the data from the node to the output buffer
@@ -122,8 +524,7 @@ bool tds_stack_pop(tds_stack_t instance, void *data) {
     instance->top = node_to_remove->next;
 
     // Free the memory of the removed node
-    free(node_to_remove->data);
-    free(node_to_remove);
+    tds_allocator_release(&instance->allocator, node_to_remove);
  
     instance->size--;
 
@@ -132,6 +533,119 @@ bool tds_stack_pop(tds_stack_t instance, void *data) {
     return true;
 }
 
+/**
+ * @brief Pushes up to count elements from a contiguous array.
+ *
+ * @param instance The stack instance.
+ * @param data Pointer to an array of count elements.
+ * @param count Number of elements to push.
+ * @return uint32_t Number of elements pushed, stopping early when the stack is full.
+ */
+uint32_t tds_stack_push_n(tds_stack_t instance, const void *data, uint32_t count) {
+    if (!instance || !data) {
+        //printf("[ERROR] Stack is not initialized!\n");
+        return 0;
+    }
+
+    const uint8_t *src = (const uint8_t *) data;
+    if (instance->mode == TDS_STACK_MODE_LOCKFREE) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (!tds_stack_lf_push(instance, src + (size_t) i * instance->elements)) {
+                return i;
+            }
+        }
+        return count;
+    }
+
+    if (count > instance->capacity - instance->size) {
+        TDS_STATS_ADD(instance, failed_full, 1);
+        count = instance->capacity - instance->size;
+    }
+
+    if (instance->mode == TDS_STACK_MODE_ARRAY) {
+        uint32_t wanted = count;
+        count           = tds_stack_array_reserve(instance, count);
+        if (count < wanted) {
+            TDS_STATS_ADD(instance, failed_full, 1);  // Growth failed
+        }
+        memcpy(instance->buffer + (size_t) instance->size * instance->elements, src, (size_t) count * instance->elements);
+        instance->size += count;
+        TDS_STATS_ADD(instance, operations, count);
+        TDS_STATS_MAX(instance, high_water, instance->size);
+        return count;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        struct tds_stack_node_t *new_node = (struct tds_stack_node_t *) instance->allocator.alloc(instance->allocator.context, tds_stack_node_size(instance->elements));
+        if (!new_node) {
+            //printf("[ERROR] Failed to allocate memory for new node.\n");
+            TDS_STATS_ADD(instance, failed_full, 1);
+            return i;
+        }
+        TDS_STATS_ALLOC(instance, tds_stack_node_size(instance->elements));
+
+        memcpy(new_node->data, src + (size_t) i * instance->elements, instance->elements);
+        new_node->next = instance->top;
+        instance->top  = new_node;
+        instance->size++;
+        TDS_STATS_ADD(instance, operations, 1);
+        TDS_STATS_MAX(instance, high_water, instance->size);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Pops up to count elements into a contiguous array.
+ *
+ * @param instance The stack instance.
+ * @param data Pointer to an array with room for count elements.
+ * @param count Maximum number of elements to pop.
+ * @return uint32_t Number of elements popped, stopping early when the stack is empty.
+ */
+uint32_t tds_stack_pop_n(tds_stack_t instance, void *data, uint32_t count) {
+    if (!instance || !data) {
+        //printf("[ERROR] Stack is not initialized!\n");
+        return 0;
+    }
+
+    // The top element goes last so the output matches the push order
+    uint8_t *dst = (uint8_t *) data;
+    if (instance->mode == TDS_STACK_MODE_LOCKFREE) {
+        uint32_t popped = 0;
+        while (popped < count && tds_stack_lf_pop(instance, dst + (size_t) (count - popped - 1) * instance->elements)) {
+            popped++;
+        }
+        if (popped < count) {
+            memmove(dst, dst + (size_t) (count - popped) * instance->elements, (size_t) popped * instance->elements);
+        }
+        return popped;
+    }
+
+    if (count > instance->size) {
+        TDS_STATS_ADD(instance, failed_empty, 1);
+        count = instance->size;
+    }
+
+    TDS_STATS_ADD(instance, operations, count);
+
+    if (instance->mode == TDS_STACK_MODE_ARRAY) {
+        instance->size -= count;
+        memcpy(dst, instance->buffer + (size_t) instance->size * instance->elements, (size_t) count * instance->elements);
+        return count;
+    }
+
+    for (uint32_t i = count; i > 0; i--) {
+        struct tds_stack_node_t *node_to_remove = instance->top;
+        memcpy(dst + (size_t) (i - 1) * instance->elements, node_to_remove->data, instance->elements);
+        instance->top = node_to_remove->next;
+        tds_allocator_release(&instance->allocator, node_to_remove);
+    }
+    instance->size -= count;
+
+    return count;
+}
+
 /**
  * @brief Checks if the stack is empty.
  *
@@ -147,7 +661,12 @@ bool tds_stack_empty(tds_stack_t instance) {
         return true;  // We consider a non-existing stack as "empty"
     }
 
-    bool is_empty = (instance->size == 0);
+    bool is_empty;
+    if (instance->mode == TDS_STACK_MODE_LOCKFREE) {
+        is_empty = (uint32_t) atomic_load_explicit(&instance->lockfree->top, memory_order_acquire) == TDS_STACK_LF_NONE;
+    } else {
+        is_empty = (instance->size == 0);
+    }
 
     //printf("The stack is %s\n", is_empty == 0 ? "not empty\n" : "empty\n");
 
@@ -170,7 +689,23 @@ bool tds_stack_peek(tds_stack_t instance, void *data) {
         return false;
     }
 
-    memcpy(data, instance->top->data, instance->elements);
+    if (instance->mode == TDS_STACK_MODE_LOCKFREE) {
+        return tds_stack_lf_peek(instance, data);
+    }
+
+    if (instance->size == 0) {
+        //printf("[ERROR] Stack is empty!\n");
+        TDS_STATS_ADD(instance, failed_empty, 1);
+        return false;
+    }
+
+    TDS_STATS_ADD(instance, operations, 1);
+
+    if (instance->mode == TDS_STACK_MODE_ARRAY) {
+        memcpy(data, instance->buffer + (size_t) (instance->size - 1) * instance->elements, instance->elements);
+    } else {
+        memcpy(data, instance->top->data, instance->elements);
+    }
     return true;
 }
 
@@ -197,14 +732,63 @@ static bool tds_stack_remove_pop(tds_stack_t instance) {
 
     struct tds_stack_node_t *node_temp = instance->top;
     instance->top                      = node_temp->next;
-    free(node_temp->data);
-    free(node_temp);
+    tds_allocator_release(&instance->allocator, node_temp);
     instance->size--;
     //printf("[LOG] Element removed successfully! Current stack size: %u\n", instance->size);
 
     return true;
 }
 
+/**
+ * @brief Pushes an element from any thread (lock-free mode only).
+ *
+ * @param instance The stack instance, created with TDS_STACK_MODE_LOCKFREE.
+ * @param data Pointer to the data to be pushed onto the stack.
+ * @return true If the element was pushed.
+ * @return false If the stack is full, or not in lock-free mode.
+ */
+bool tds_stack_push_threadsafe(tds_stack_t instance, const void *data) {
+    if (!instance || !data || instance->mode != TDS_STACK_MODE_LOCKFREE) {
+        //printf("[ERROR] Stack is not initialized or not in lock-free mode!\n");
+        return false;
+    }
+
+    return tds_stack_lf_push(instance, data);
+}
+
+/**
+ * @brief Pops the top element from any thread (lock-free mode only).
+ *
+ * @param instance The stack instance, created with TDS_STACK_MODE_LOCKFREE.
+ * @param data Pointer where the popped element's data will be stored.
+ * @return true If an element was popped.
+ * @return false If the stack is empty, or not in lock-free mode.
+ */
+bool tds_stack_pop_threadsafe(tds_stack_t instance, void *data) {
+    if (!instance || !data || instance->mode != TDS_STACK_MODE_LOCKFREE) {
+        //printf("[ERROR] Stack is not initialized or not in lock-free mode!\n");
+        return false;
+    }
+
+    return tds_stack_lf_pop(instance, data);
+}
+
+/**
+ * @brief Reads the statistics counters of the stack.
+ *
+ * @param instance The stack instance.
+ * @param stats Pointer where the counters will be stored (zeroed when disabled).
+ * @return true If the library was built with TDS_ENABLE_STATS.
+ * @return false If statistics are disabled or an argument is NULL.
+ */
+bool tds_stack_get_stats(tds_stack_t instance, tds_stats_t *stats) {
+    if (!instance || !stats) {
+        return false;
+    }
+
+    return TDS_STATS_READ(instance, stats);
+}
+
 /**
  * @brief Destroys the stack and frees all allocated memory.
  *
@@ -220,13 +804,22 @@ bool tds_stack_destroy(tds_stack_t instance) {
         return false;
     }
 
-    if (instance->size > 0) {
-        while (!instance->top) {
+    if (instance->mode == TDS_STACK_MODE_LOCKFREE) {
+        if (!instance->is_static) {
+            TDS_FREE(instance->lockfree->nodes);
+            TDS_FREE(instance->lockfree);
+        }
+    } else if (instance->size > 0 && instance->allocator.free) {
+        // Nodes from an allocator without free (arena) go away with the region
+        while (instance->top) {
             tds_stack_remove_pop(instance);
         }
     }
 
-    free(instance);
+    if (!instance->is_static) {
+        TDS_FREE(instance->buffer);
+        TDS_FREE(instance);
+    }
     //printf("[LOG] Stack destroyed successfully\n");
     return true;
 }
@@ -3,11 +3,34 @@
 #include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdatomic.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "tds_deque.h"
+#include "tds_hashtable.h"
+#include "tds_heap.h"
+#include "tds_list.h"
+#include "tds_memory.h"
 #include "tds_queue.h"  // Inclua seu cabeçalho da fila
+#include "tds_ringbuffer.h"
+#include "tds_snapshot.h"
+#include "tds_stack.h"
+#include "tds_typed.h"
 
 #define NUM_OPERATIONS 100000
 
+// Contador de falhas, usado como código de saída para o ctest
+static atomic_int failures = 0;
+
+#define CHECK(cond, msg)                                                  \
+    do {                                                                  \
+        if (!(cond)) {                                                    \
+            printf("Erro: %s (%s:%d)\n", msg, __FILE__, __LINE__);        \
+            failures++;                                                   \
+        }                                                                 \
+    } while (0)
+
 // A fila global que será usada na thread única
 tds_queue_t queue;
 
@@ -19,6 +42,7 @@ void test_single_thread_operations() {
     for (int i = 0; i < NUM_OPERATIONS; i++) {
         if (!tds_queue_enqueue(queue, &i)) {
             printf("Falhou ao enfileirar o elemento %d!\n", i);
+            failures++;
         }
     }
 
@@ -30,20 +54,2067 @@ void test_single_thread_operations() {
     for (int i = 0; i < NUM_OPERATIONS; i++) {
         if (!tds_queue_dequeue(queue, &out)) {
             printf("Falhou ao desenfileirar o elemento %d!\n", i);
+            failures++;
         } else if (out != i) {
             // Verificar se os elementos desenfileirados estão na ordem correta
             printf("Erro: Esperado %d, mas desenfileirado %d.\n", i, out);
+            failures++;
         }
     }
 
     // Verificar se a fila está vazia após todas as operações
     if (!tds_queue_empty(queue)) {
         printf("Erro: A fila não está vazia após todas as operações!\n");
+        failures++;
     }
 
     printf("Testes com thread única concluídos com sucesso.\n");
 }
 
+// Testa a fila em modo anel (buffer contíguo), incluindo a volta do índice
+void test_ring_queue() {
+    printf("Iniciando testes da fila em modo anel...\n");
+
+    tds_queue_config_t config = TDS_QUEUE_CONFIG_DEFAULT;
+    config.mode               = TDS_QUEUE_MODE_RING;
+
+    tds_queue_t ring = tds_queue_create_ex(8, sizeof(int), &config);
+    CHECK(ring != NULL, "falha ao criar a fila em anel");
+    if (!ring) {
+        return;
+    }
+
+    int value, out;
+    CHECK(!tds_queue_peek(ring, &out), "peek em fila vazia deveria falhar");
+
+    int next_in = 0, next_out = 0;
+    for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < 6; i++) {
+            value = next_in++;
+            CHECK(tds_queue_enqueue(ring, &value), "falha ao enfileirar no anel");
+        }
+        CHECK(tds_queue_size(ring) == 6, "tamanho incorreto após enfileirar");
+        for (int i = 0; i < 6; i++) {
+            CHECK(tds_queue_peek(ring, &out) && out == next_out, "peek retornou valor incorreto");
+            CHECK(tds_queue_dequeue(ring, &out) && out == next_out, "ordem FIFO incorreta no anel");
+            next_out++;
+        }
+    }
+
+    for (int i = 0; i < 8; i++) {
+        CHECK(tds_queue_enqueue(ring, &i), "falha ao encher o anel");
+    }
+    CHECK(!tds_queue_enqueue(ring, &value), "enfileirar em anel cheio deveria falhar");
+    CHECK(tds_queue_destroy(ring), "falha ao destruir a fila em anel");
+
+    printf("Testes da fila em modo anel concluídos.\n");
+}
+
+// Testa o pool de blocos fixos e seu uso como alocador de nós da fila e da pilha
+void test_pool_allocator() {
+    printf("Iniciando testes do pool de memória...\n");
+
+    tds_pool_t pool = tds_pool_create(tds_queue_node_size(sizeof(int)), 4);
+    CHECK(pool != NULL, "falha ao criar o pool");
+    if (!pool) {
+        return;
+    }
+    CHECK(tds_pool_available(pool) == 4, "pool deveria começar cheio");
+
+    void* blocks[4];
+    for (int i = 0; i < 4; i++) {
+        blocks[i] = tds_pool_alloc(pool);
+        CHECK(blocks[i] != NULL, "falha ao alocar bloco do pool");
+    }
+    CHECK(tds_pool_alloc(pool) == NULL, "pool esgotado deveria retornar NULL");
+    int outside;
+    CHECK(!tds_pool_free(pool, &outside), "bloco fora do pool deveria ser rejeitado");
+    for (int i = 0; i < 4; i++) {
+        CHECK(tds_pool_free(pool, blocks[i]), "falha ao devolver bloco ao pool");
+    }
+
+    tds_allocator_t    allocator    = tds_pool_allocator(pool);
+    tds_queue_config_t queue_config = TDS_QUEUE_CONFIG_DEFAULT;
+    queue_config.allocator          = &allocator;
+
+    tds_queue_t q = tds_queue_create_ex(16, sizeof(int), &queue_config);
+    int         out;
+    for (int i = 0; i < 4; i++) {
+        CHECK(tds_queue_enqueue(q, &i), "falha ao enfileirar com o pool");
+    }
+    CHECK(!tds_queue_enqueue(q, &out), "enfileirar com pool esgotado deveria falhar");
+    CHECK(tds_queue_dequeue(q, &out) && out == 0, "ordem FIFO incorreta com o pool");
+    CHECK(tds_pool_available(pool) == 1, "nó não foi devolvido ao pool");
+    tds_queue_destroy(q);
+    CHECK(tds_pool_available(pool) == 4, "destroy não devolveu os nós ao pool");
+
+    tds_stack_config_t stack_config = TDS_STACK_CONFIG_DEFAULT;
+    stack_config.allocator          = &allocator;
+
+    tds_stack_t s = tds_stack_create_ex(16, sizeof(int), &stack_config);
+    for (int i = 0; i < 3; i++) {
+        CHECK(tds_stack_push(s, &i), "falha ao empilhar com o pool");
+    }
+    CHECK(tds_stack_pop(s, &out) && out == 2, "ordem LIFO incorreta com o pool");
+    tds_stack_destroy(s);
+    CHECK(tds_pool_available(pool) == 4, "destroy da pilha não devolveu os nós");
+
+    tds_pool_destroy(pool);
+    printf("Testes do pool de memória concluídos.\n");
+}
+
+// Produtor da thread SPSC: empurra NUM_OPERATIONS inteiros, alternando simples e em bloco
+static void* spsc_producer(void* arg) {
+    tds_ringbuffer_t rb = (tds_ringbuffer_t) arg;
+    int              batch[16];
+    int              next = 0;
+    while (next < NUM_OPERATIONS) {
+        if (next % 2 == 0) {
+            if (tds_ringbuffer_try_push(rb, &next)) {
+                next++;
+            }
+        } else {
+            int n = 0;
+            while (n < 16 && next + n < NUM_OPERATIONS) {
+                batch[n] = next + n;
+                n++;
+            }
+            next += tds_ringbuffer_push_bulk(rb, batch, n);
+        }
+    }
+    return NULL;
+}
+
+// Testa o ring buffer SPSC em uma thread e depois com produtor e consumidor concorrentes
+void test_spsc_ringbuffer() {
+    printf("Iniciando testes do ring buffer SPSC...\n");
+
+    tds_ringbuffer_t rb = tds_ringbuffer_create(5, sizeof(int));
+    CHECK(rb != NULL, "falha ao criar o ring buffer");
+    if (!rb) {
+        return;
+    }
+    CHECK(tds_ringbuffer_capacity(rb) == 8, "capacidade deveria ser arredondada para 8");
+
+    int values[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int out[10];
+    CHECK(tds_ringbuffer_push_bulk(rb, values, 6) == 6, "push_bulk deveria inserir 6");
+    CHECK(tds_ringbuffer_pop_bulk(rb, out, 4) == 4 && out[3] == 3, "pop_bulk retornou dados incorretos");
+    CHECK(tds_ringbuffer_push_bulk(rb, values, 10) == 6, "push_bulk deveria parar quando cheio");
+    CHECK(tds_ringbuffer_full(rb), "ring buffer deveria estar cheio");
+    CHECK(!tds_ringbuffer_try_push(rb, &values[0]), "try_push em buffer cheio deveria falhar");
+    CHECK(tds_ringbuffer_try_pop(rb, &out[0]) && out[0] == 4, "try_pop retornou valor incorreto");
+    CHECK(tds_ringbuffer_pop_bulk(rb, out, 10) == 7 && out[0] == 5 && out[6] == 5, "pop_bulk após a volta incorreto");
+    CHECK(tds_ringbuffer_empty(rb), "ring buffer deveria estar vazio");
+    tds_ringbuffer_destroy(rb);
+
+    rb = tds_ringbuffer_create(1024, sizeof(int));
+    pthread_t producer;
+    pthread_create(&producer, NULL, spsc_producer, rb);
+
+    int expected = 0;
+    int chunk[32];
+    while (expected < NUM_OPERATIONS) {
+        uint32_t n = tds_ringbuffer_pop_bulk(rb, chunk, 32);
+        for (uint32_t i = 0; i < n; i++, expected++) {
+            if (chunk[i] != expected) {
+                printf("Erro: Esperado %d, mas recebido %d.\n", expected, chunk[i]);
+                failures++;
+                expected = chunk[i];
+            }
+        }
+    }
+    pthread_join(producer, NULL);
+    CHECK(tds_ringbuffer_empty(rb), "ring buffer deveria terminar vazio");
+    tds_ringbuffer_destroy(rb);
+
+    printf("Testes do ring buffer SPSC concluídos.\n");
+}
+
+#define MPMC_THREADS 4
+#define MPMC_PER_THREAD 50000
+
+static tds_queue_t      mpmc_queue;
+static _Atomic uint64_t mpmc_sum;
+static _Atomic int      mpmc_consumed;
+
+// Produtor MPMC: cada valor codifica o id da thread e um contador crescente
+static void* mpmc_producer(void* arg) {
+    uint32_t id = (uint32_t) (uintptr_t) arg;
+    for (uint32_t i = 0; i < MPMC_PER_THREAD; i++) {
+        uint32_t value = (id << 24) | i;
+        while (!tds_queue_enqueue_threadsafe(mpmc_queue, &value)) {
+        }
+    }
+    return NULL;
+}
+
+// Consumidor MPMC: verifica que cada produtor é visto em ordem FIFO
+static void* mpmc_consumer(void* arg) {
+    (void) arg;
+    int32_t  last[MPMC_THREADS] = {-1, -1, -1, -1};
+    uint32_t value;
+    while (atomic_load(&mpmc_consumed) < MPMC_THREADS * MPMC_PER_THREAD) {
+        if (tds_queue_dequeue_threadsafe(mpmc_queue, &value)) {
+            uint32_t id  = value >> 24;
+            int32_t  seq = (int32_t) (value & 0xFFFFFF);
+            if (id >= MPMC_THREADS || seq <= last[id]) {
+                printf("Erro: ordem MPMC violada (produtor %u, %d após %d).\n", id, seq, last[id]);
+                failures++;
+            } else {
+                last[id] = seq;
+            }
+            atomic_fetch_add(&mpmc_sum, value & 0xFFFFFF);
+            atomic_fetch_add(&mpmc_consumed, 1);
+        }
+    }
+    return NULL;
+}
+
+// Testa a fila MPMC com vários produtores e consumidores concorrentes
+void test_mpmc_queue() {
+    printf("Iniciando testes da fila MPMC...\n");
+
+    tds_queue_config_t config = TDS_QUEUE_CONFIG_DEFAULT;
+    config.mode               = TDS_QUEUE_MODE_MPMC;
+
+    mpmc_queue = tds_queue_create_ex(1000, sizeof(uint32_t), &config);
+    CHECK(mpmc_queue != NULL, "falha ao criar a fila MPMC");
+    if (!mpmc_queue) {
+        return;
+    }
+
+    uint32_t value = 7, out = 0;
+    CHECK(tds_queue_enqueue(mpmc_queue, &value), "enqueue simples deveria funcionar em modo MPMC");
+    CHECK(tds_queue_peek(mpmc_queue, &out) && out == 7, "peek MPMC retornou valor incorreto");
+    CHECK(tds_queue_size(mpmc_queue) == 1, "tamanho MPMC incorreto");
+    CHECK(tds_queue_dequeue_threadsafe(mpmc_queue, &out) && out == 7, "dequeue MPMC incorreto");
+    CHECK(!tds_queue_dequeue_threadsafe(mpmc_queue, &out), "dequeue em fila vazia deveria falhar");
+    tds_queue_t linked = tds_queue_create(4, sizeof(uint32_t));
+    CHECK(!tds_queue_enqueue_threadsafe(linked, &value), "fila não MPMC deveria rejeitar a API threadsafe");
+    tds_queue_destroy(linked);
+
+    atomic_store(&mpmc_sum, 0);
+    atomic_store(&mpmc_consumed, 0);
+
+    pthread_t producers[MPMC_THREADS], consumers[MPMC_THREADS];
+    for (uintptr_t i = 0; i < MPMC_THREADS; i++) {
+        pthread_create(&producers[i], NULL, mpmc_producer, (void*) i);
+        pthread_create(&consumers[i], NULL, mpmc_consumer, NULL);
+    }
+    for (int i = 0; i < MPMC_THREADS; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+    }
+
+    uint64_t expected = (uint64_t) MPMC_THREADS * MPMC_PER_THREAD * (MPMC_PER_THREAD - 1) / 2;
+    CHECK(atomic_load(&mpmc_sum) == expected, "soma dos valores MPMC incorreta");
+    CHECK(tds_queue_empty(mpmc_queue), "fila MPMC deveria terminar vazia");
+    tds_queue_destroy(mpmc_queue);
+
+    printf("Testes da fila MPMC concluídos.\n");
+}
+
+// Testa as APIs em lote da fila (todos os modos) e da pilha
+void test_batch_operations() {
+    printf("Iniciando testes das operações em lote...\n");
+
+    int in[20], out[20];
+    for (int i = 0; i < 20; i++) {
+        in[i] = i;
+    }
+
+    const tds_queue_mode_t modes[] = {TDS_QUEUE_MODE_LINKED, TDS_QUEUE_MODE_RING, TDS_QUEUE_MODE_MPMC};
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        tds_queue_config_t config = TDS_QUEUE_CONFIG_DEFAULT;
+        config.mode               = modes[m];
+
+        tds_queue_t q = tds_queue_create_ex(16, sizeof(int), &config);
+        CHECK(tds_queue_enqueue_n(q, in, 10) == 10, "enqueue_n deveria inserir 10");
+        CHECK(tds_queue_dequeue_n(q, out, 7) == 7 && out[6] == 6, "dequeue_n retornou dados incorretos");
+        CHECK(tds_queue_enqueue_n(q, in, 20) == 13, "enqueue_n deveria parar na capacidade");
+        CHECK(tds_queue_dequeue_n(q, out, 20) == 16, "dequeue_n deveria esvaziar a fila");
+        CHECK(out[0] == 7 && out[2] == 9 && out[3] == 0 && out[15] == 12, "ordem FIFO incorreta em lote");
+        CHECK(tds_queue_empty(q), "fila deveria estar vazia após dequeue_n");
+        tds_queue_destroy(q);
+    }
+
+    const tds_stack_mode_t stack_modes[] = {TDS_STACK_MODE_LINKED, TDS_STACK_MODE_ARRAY, TDS_STACK_MODE_LOCKFREE};
+    for (size_t m = 0; m < sizeof(stack_modes) / sizeof(stack_modes[0]); m++) {
+        tds_stack_config_t config = TDS_STACK_CONFIG_DEFAULT;
+        config.mode               = stack_modes[m];
+        config.chunk              = 5;
+
+        tds_stack_t s = tds_stack_create_ex(12, sizeof(int), &config);
+        CHECK(tds_stack_push_n(s, in, 20) == 12, "push_n deveria parar na capacidade");
+        int top;
+        CHECK(tds_stack_peek(s, &top) && top == 11, "topo incorreto após push_n");
+        CHECK(tds_stack_pop_n(s, out, 5) == 5 && out[0] == 7 && out[4] == 11, "pop_n deveria desfazer push_n");
+        CHECK(tds_stack_pop_n(s, out, 20) == 7 && out[0] == 0 && out[6] == 6, "pop_n do restante incorreto");
+        CHECK(tds_stack_empty(s), "pilha deveria estar vazia");
+        tds_stack_destroy(s);
+    }
+
+    printf("Testes das operações em lote concluídos.\n");
+}
+
+// Testa reserve/commit e peek_span/consume na fila em anel e no ring buffer
+void test_zero_copy() {
+    printf("Iniciando testes de acesso sem cópia...\n");
+
+    tds_queue_config_t config = TDS_QUEUE_CONFIG_DEFAULT;
+    config.mode               = TDS_QUEUE_MODE_RING;
+
+    tds_queue_t q = tds_queue_create_ex(6, sizeof(int), &config);
+    uint32_t    n = 0;
+    int*        w = (int*) tds_queue_reserve(q, 4, &n);
+    CHECK(w != NULL && n == 4, "reserve deveria conceder 4 slots");
+    for (uint32_t i = 0; i < n; i++) {
+        w[i] = (int) i;
+    }
+    CHECK(tds_queue_size(q) == 0, "elementos reservados não devem ser visíveis antes do commit");
+    CHECK(!tds_queue_commit(q, 5), "commit maior que a reserva deveria falhar");
+    CHECK(tds_queue_commit(q, 4), "falha no commit");
+
+    const int* r = (const int*) tds_queue_peek_span(q, &n);
+    CHECK(r != NULL && n == 4 && r[3] == 3, "peek_span incorreto");
+    CHECK(tds_queue_consume(q, 3) == 3, "consume deveria liberar 3");
+
+    w = (int*) tds_queue_reserve(q, 10, &n);
+    CHECK(n == 2, "reserve não deveria atravessar o fim do buffer");
+    w[0] = 4;
+    w[1] = 5;
+    tds_queue_commit(q, 2);
+    w = (int*) tds_queue_reserve(q, 10, &n);
+    CHECK(n == 3, "reserve após a volta deveria conceder 3");
+    w[0] = 6;
+    tds_queue_commit(q, 1);
+
+    int out;
+    for (int expected = 3; expected <= 6; expected++) {
+        CHECK(tds_queue_dequeue(q, &out) && out == expected, "ordem incorreta após reserve/commit");
+    }
+    tds_queue_destroy(q);
+
+    // Um enqueue entre reserve e commit cancela a reserva
+    q = tds_queue_create_ex(4, sizeof(int), &config);
+    w = (int*) tds_queue_reserve(q, 4, &n);
+    CHECK(w != NULL && n == 4, "reserve deveria conceder 4 slots");
+    w[0]  = 100;
+    int x = 7;
+    CHECK(tds_queue_enqueue(q, &x), "enqueue com reserva pendente deveria funcionar");
+    CHECK(!tds_queue_commit(q, 4), "commit de reserva cancelada deveria falhar");
+    CHECK(tds_queue_size(q) == 1 && tds_queue_dequeue(q, &out) && out == 7, "reserva cancelada publicou slots");
+    w = (int*) tds_queue_reserve(q, 4, &n);
+    CHECK(w != NULL && n == 3, "reserve após o enqueue deveria conceder 3 slots");
+    CHECK(tds_queue_enqueue_n(q, &x, 1) == 1 && !tds_queue_commit(q, 3), "enqueue_n deveria cancelar a reserva");
+    tds_queue_destroy(q);
+
+    tds_ringbuffer_t rb = tds_ringbuffer_create(8, sizeof(int));
+    int              in[6] = {0, 1, 2, 3, 4, 5};
+    tds_ringbuffer_push_bulk(rb, in, 6);
+    tds_ringbuffer_pop_bulk(rb, in, 6);
+
+    w = (int*) tds_ringbuffer_reserve(rb, 5, &n);
+    CHECK(w != NULL && n == 2, "reserve do ring buffer deveria parar no fim do buffer");
+    w[0] = 10;
+    w[1] = 11;
+    CHECK(tds_ringbuffer_commit(rb, 2), "falha no commit do ring buffer");
+    w = (int*) tds_ringbuffer_reserve(rb, 5, &n);
+    CHECK(n == 5, "reserve após a volta deveria conceder 5");
+    w[0] = 12;
+    tds_ringbuffer_commit(rb, 1);
+
+    r = (const int*) tds_ringbuffer_peek_span(rb, &n);
+    CHECK(r != NULL && n == 2 && r[0] == 10 && r[1] == 11, "peek_span do ring buffer incorreto");
+    CHECK(tds_ringbuffer_consume(rb, n) == 2, "consume do ring buffer incorreto");
+    r = (const int*) tds_ringbuffer_peek_span(rb, &n);
+    CHECK(r != NULL && n == 1 && r[0] == 12, "peek_span após a volta incorreto");
+    tds_ringbuffer_consume(rb, n);
+    CHECK(tds_ringbuffer_empty(rb), "ring buffer deveria estar vazio");
+    tds_ringbuffer_destroy(rb);
+
+    printf("Testes de acesso sem cópia concluídos.\n");
+}
+
+static inline uint64_t u32_hash(uint32_t key) {
+    return tds_hashtable_hash_bytes(&key, sizeof(key));
+}
+#define U32_EQ(a, b) ((a) == (b))
+
+TDS_DEFINE_QUEUE(int_queue, int)
+TDS_DEFINE_STACK(double_stack, double)
+TDS_DEFINE_HASHTABLE(u32_map, uint32_t, uint64_t, u32_hash, U32_EQ)
+
+// Tipo com alinhamento maior que max_align_t
+typedef struct {
+    _Alignas(32) double v[4];
+} vec4_t;
+
+TDS_DEFINE_QUEUE(vec4_queue, vec4_t)
+TDS_DEFINE_STACK(vec4_stack, vec4_t)
+TDS_DEFINE_HASHTABLE(vec4_map, uint32_t, vec4_t, u32_hash, U32_EQ)
+
+// Testa os contêineres tipados gerados por macro
+void test_typed_containers() {
+    printf("Iniciando testes dos contêineres tipados...\n");
+
+    int         storage[4];
+    int_queue_t q;
+    int         out;
+    CHECK(int_queue_init(&q, storage, 4), "falha ao inicializar a fila tipada");
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 3; i++) {
+            CHECK(int_queue_enqueue(&q, round * 10 + i), "falha ao enfileirar na fila tipada");
+        }
+        for (int i = 0; i < 3; i++) {
+            CHECK(int_queue_dequeue(&q, &out) && out == round * 10 + i, "ordem FIFO incorreta na fila tipada");
+        }
+    }
+    CHECK(int_queue_empty(&q), "fila tipada deveria estar vazia");
+
+    double_stack_t* s = double_stack_create(2);
+    double          d;
+    CHECK(double_stack_push(s, 1.5) && double_stack_push(s, 2.5) && !double_stack_push(s, 3.5), "capacidade da pilha tipada incorreta");
+    CHECK(double_stack_pop(s, &d) && d == 2.5, "ordem LIFO incorreta na pilha tipada");
+    double_stack_destroy(s);
+
+    u32_map_t* map = u32_map_create(4);
+    for (uint32_t i = 0; i < 5000; i++) {
+        CHECK(u32_map_put(map, i, (uint64_t) i << 32), "falha ao inserir no mapa tipado");
+    }
+    for (uint32_t i = 0; i < 5000; i += 3) {
+        CHECK(u32_map_remove(map, i), "falha ao remover do mapa tipado");
+    }
+    uint64_t value;
+    for (uint32_t i = 0; i < 5000; i++) {
+        bool found = u32_map_get(map, i, &value);
+        CHECK(found == (i % 3 != 0) && (!found || value == (uint64_t) i << 32), "busca no mapa tipado incorreta");
+    }
+    CHECK(u32_map_size(map) == 3333, "tamanho do mapa tipado incorreto");
+    u32_map_destroy(map);
+
+    // Mapa em memória do chamador: não cresce e reaproveita tombstones no lugar
+    u32_map_slot_t fixed_slots[64];
+    uint8_t        fixed_ctrl[64];
+    u32_map_t      fixed;
+    CHECK(!u32_map_init(&fixed, fixed_slots, fixed_ctrl, 48), "init com contagem que não é potência de dois deveria falhar");
+    CHECK(u32_map_init(&fixed, fixed_slots, fixed_ctrl, 64), "falha ao inicializar o mapa tipado estático");
+    for (uint32_t k = 0; k < 20000; k++) {
+        CHECK(u32_map_put(&fixed, k, k), "falha ao inserir no mapa tipado estático");
+        if (k >= 40) {
+            CHECK(u32_map_remove(&fixed, k - 40), "falha ao remover do mapa tipado estático");
+        }
+        if (k % 97 == 0) {
+            for (uint32_t j = k >= 40 ? k - 39 : 0; j <= k; j++) {
+                CHECK(u32_map_get(&fixed, j, &value) && value == j, "busca no mapa tipado estático incorreta");
+            }
+        }
+    }
+    CHECK(u32_map_size(&fixed) == 40 && fixed.slots == fixed_slots, "mapa tipado estático não deveria crescer");
+    uint32_t k = 20000;
+    while (u32_map_put(&fixed, k, k)) {
+        k++;
+    }
+    CHECK(u32_map_size(&fixed) == 56, "mapa tipado estático deveria encher em 7/8 dos slots");
+
+    // Elementos super-alinhados: o array deve respeitar _Alignof(T)
+    vec4_queue_t* vq = vec4_queue_create(5);
+    vec4_stack_t* vs = vec4_stack_create(5);
+    vec4_map_t*   vm = vec4_map_create(8);
+    CHECK(vq && vs && vm, "falha ao criar contêineres tipados super-alinhados");
+    if (vq && vs && vm) {
+        CHECK((uintptr_t) vq->items % 32 == 0, "array da fila tipada desalinhado");
+        CHECK((uintptr_t) vs->items % 32 == 0, "array da pilha tipada desalinhado");
+        CHECK((uintptr_t) vm->slots % 32 == 0, "slots do mapa tipado desalinhados");
+        vec4_t v;
+        for (uint32_t i = 0; i < 100; i++) {
+            vec4_t item = {{(double) i, 1.0, 2.0, 3.0}};
+            CHECK(vec4_queue_enqueue(vq, item) && vec4_stack_push(vs, item), "falha ao inserir elemento super-alinhado");
+            CHECK(vec4_queue_dequeue(vq, &v) && v.v[0] == (double) i, "fila tipada super-alinhada incorreta");
+            CHECK(vec4_stack_pop(vs, &v) && v.v[0] == (double) i, "pilha tipada super-alinhada incorreta");
+            CHECK(vec4_map_put(vm, i, item), "falha ao inserir no mapa super-alinhado");
+        }
+        CHECK((uintptr_t) vm->slots % 32 == 0, "slots do mapa tipado desalinhados após crescer");
+        CHECK(vec4_map_get(vm, 42, &v) && v.v[0] == 42.0, "mapa tipado super-alinhado incorreto");
+    }
+    vec4_queue_destroy(vq);
+    vec4_stack_destroy(vs);
+    vec4_map_destroy(vm);
+
+    printf("Testes dos contêineres tipados concluídos.\n");
+}
+
+// Hash propositalmente ruim: força todas as chaves no mesmo grupo de sondagem
+static uint64_t colliding_hash(const void* key, size_t key_size) {
+    (void) key_size;
+    return (uint64_t) (*(const uint32_t*) key % 3);
+}
+
+// Testa a hashtable de endereçamento aberto (inserção, busca, remoção e crescimento)
+void test_hashtable() {
+    printf("Iniciando testes da hashtable...\n");
+
+    tds_hashtable_t ht = tds_hashtable_create(16, sizeof(uint32_t), sizeof(uint64_t));
+    CHECK(ht != NULL, "falha ao criar a hashtable");
+    if (!ht) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < 20000; i++) {
+        uint64_t value = (uint64_t) i * 3;
+        CHECK(tds_hashtable_put(ht, &i, &value), "falha ao inserir na hashtable");
+    }
+    CHECK(tds_hashtable_size(ht) == 20000, "tamanho incorreto após inserções");
+
+    uint64_t value;
+    for (uint32_t i = 0; i < 20000; i += 2) {
+        CHECK(tds_hashtable_remove(ht, &i, &value) && value == (uint64_t) i * 3, "falha ao remover da hashtable");
+    }
+    for (uint32_t i = 0; i < 20000; i++) {
+        bool found = tds_hashtable_get(ht, &i, &value);
+        CHECK(found == (i % 2 == 1), "resultado de busca incorreto");
+        CHECK(!found || value == (uint64_t) i * 3, "valor incorreto na hashtable");
+    }
+
+    // Reinserir e sobrescrever para exercitar tombstones e rehash sem crescimento
+    for (uint32_t round = 0; round < 4; round++) {
+        for (uint32_t i = 0; i < 20000; i += 2) {
+            value = round;
+            tds_hashtable_put(ht, &i, &value);
+        }
+        for (uint32_t i = 0; i < 20000; i += 2) {
+            tds_hashtable_remove(ht, &i, NULL);
+        }
+    }
+    CHECK(tds_hashtable_size(ht) == 10000, "tamanho incorreto após ciclos de remoção");
+    uint32_t key = 7;
+    value        = 1;
+    CHECK(tds_hashtable_put(ht, &key, &value) && tds_hashtable_size(ht) == 10000, "sobrescrita não deveria mudar o tamanho");
+    CHECK(tds_hashtable_get(ht, &key, &value) && value == 1, "sobrescrita não aplicada");
+    CHECK(tds_hashtable_clear(ht) && tds_hashtable_size(ht) == 0 && !tds_hashtable_contains(ht, &key), "clear incorreto");
+    tds_hashtable_destroy(ht);
+
+    tds_hashtable_config_t config = TDS_HASHTABLE_CONFIG_DEFAULT;
+    config.hash                   = colliding_hash;
+    config.max_load_factor        = 0.5f;
+    ht                            = tds_hashtable_create_ex(0, sizeof(uint32_t), 0, &config);
+    for (uint32_t i = 0; i < 300; i++) {
+        CHECK(tds_hashtable_put(ht, &i, NULL), "falha ao inserir com colisões");
+    }
+    for (uint32_t i = 0; i < 400; i++) {
+        CHECK(tds_hashtable_contains(ht, &i) == (i < 300), "busca com colisões incorreta");
+    }
+    CHECK(tds_hashtable_capacity(ht) >= 600, "fator de carga não respeitado");
+    tds_hashtable_destroy(ht);
+
+    printf("Testes da hashtable concluídos.\n");
+}
+
+// Testa o rehash incremental (tabelas antiga e nova coexistindo) e o reserve
+void test_hashtable_incremental() {
+    printf("Iniciando testes do rehash incremental...\n");
+
+    tds_hashtable_t ht = tds_hashtable_create(0, sizeof(uint32_t), sizeof(uint32_t));
+    CHECK(ht != NULL, "falha ao criar a hashtable");
+    if (!ht) {
+        return;
+    }
+
+    // Durante cada migração, todas as chaves devem continuar visíveis e as
+    // remoções/sobrescritas devem valer tanto na tabela antiga quanto na nova
+    uint32_t value;
+    for (uint32_t i = 0; i < 5000; i++) {
+        value = i;
+        CHECK(tds_hashtable_put(ht, &i, &value), "falha ao inserir durante a migração");
+        if (i % 7 == 0) {
+            uint32_t victim = i / 2;
+            CHECK(tds_hashtable_remove(ht, &victim, &value) && value == victim, "falha ao remover durante a migração");
+            value = victim + 1;
+            CHECK(tds_hashtable_put(ht, &victim, &value), "falha ao reinserir durante a migração");
+        }
+    }
+    CHECK(tds_hashtable_size(ht) == 5000, "tamanho incorreto após migrações");
+    for (uint32_t i = 0; i < 5000; i++) {
+        uint32_t expected = ((i * 2) % 7 == 0 || (i * 2 + 1) % 7 == 0) && i < 2500 ? i + 1 : i;
+        CHECK(tds_hashtable_get(ht, &i, &value) && value == expected, "valor incorreto após migrações");
+    }
+    tds_hashtable_destroy(ht);
+
+    // Com reserve, nenhuma inserção até o total reservado redimensiona a tabela
+    ht = tds_hashtable_create(0, sizeof(uint32_t), sizeof(uint32_t));
+    CHECK(tds_hashtable_reserve(ht, 50000), "falha no reserve");
+    int capacity = tds_hashtable_capacity(ht);
+    for (uint32_t i = 0; i < 50000; i++) {
+        tds_hashtable_put(ht, &i, &i);
+    }
+    CHECK(tds_hashtable_capacity(ht) == capacity && tds_hashtable_size(ht) == 50000, "reserve não evitou o rehash");
+    CHECK(tds_hashtable_reserve(ht, 10) && tds_hashtable_capacity(ht) == capacity, "reserve não deveria encolher");
+    tds_hashtable_destroy(ht);
+
+    tds_hashtable_config_t config = TDS_HASHTABLE_CONFIG_DEFAULT;
+    config.concurrent             = true;
+    ht                            = tds_hashtable_create_ex(0, sizeof(uint32_t), sizeof(uint32_t), &config);
+    CHECK(tds_hashtable_reserve(ht, 1000), "falha no reserve concorrente");
+    capacity = tds_hashtable_capacity(ht);
+    for (uint32_t i = 0; i < 1000; i++) {
+        tds_hashtable_put(ht, &i, &i);
+    }
+    CHECK(tds_hashtable_capacity(ht) == capacity && tds_hashtable_size(ht) == 1000, "reserve concorrente não evitou o rehash");
+    tds_hashtable_destroy(ht);
+
+    printf("Testes do rehash incremental concluídos.\n");
+}
+
+void test_hashtable_batch() {
+    printf("Iniciando testes da busca em lote da hashtable...\n");
+
+    for (int mode = 0; mode < 2; mode++) {
+        tds_hashtable_config_t config = TDS_HASHTABLE_CONFIG_DEFAULT;
+        config.concurrent             = mode == 1;
+        tds_hashtable_t ht            = tds_hashtable_create_ex(0, sizeof(uint32_t), sizeof(uint32_t), &config);
+        CHECK(ht != NULL, "falha ao criar a hashtable");
+        if (!ht) {
+            return;
+        }
+
+        // Só as chaves pares estão presentes; a tabela ainda está migrando no modo simples
+        for (uint32_t i = 0; i < 3000; i += 2) {
+            uint32_t value = i * 3;
+            tds_hashtable_put(ht, &i, &value);
+        }
+
+        uint32_t keys[100], values[100];
+        uint64_t found[2];
+        for (uint32_t i = 0; i < 100; i++) {
+            keys[i]   = i * 29 % 3100;
+            values[i] = UINT32_MAX;
+        }
+        uint32_t hits = tds_hashtable_get_batch(ht, keys, 100, values, found);
+
+        uint32_t expected = 0;
+        for (uint32_t i = 0; i < 100; i++) {
+            bool present = keys[i] % 2 == 0 && keys[i] < 3000;
+            bool bit     = (found[i / 64] >> (i % 64)) & 1;
+            expected += present;
+            CHECK(bit == present, "máscara de encontrados incorreta");
+            CHECK(present ? values[i] == keys[i] * 3 : values[i] == UINT32_MAX, "valor da busca em lote incorreto");
+        }
+        CHECK(hits == expected, "número de chaves encontradas incorreto");
+        CHECK(found[1] >> 36 == 0, "bits além de count deveriam ficar zerados");
+        CHECK(tds_hashtable_get_batch(ht, keys, 100, NULL, NULL) == expected, "busca em lote sem saídas incorreta");
+        CHECK(tds_hashtable_get_batch(ht, NULL, 0, NULL, NULL) == 0, "lote vazio deveria retornar 0");
+
+        tds_hashtable_destroy(ht);
+    }
+
+    printf("Testes da busca em lote da hashtable concluídos.\n");
+}
+
+// Testa o modo array da pilha (crescimento em blocos)
+void test_stack_modes() {
+    printf("Iniciando testes dos modos da pilha...\n");
+
+    tds_stack_config_t config = TDS_STACK_CONFIG_DEFAULT;
+    config.mode               = TDS_STACK_MODE_ARRAY;
+    config.chunk              = 8;
+
+    tds_stack_t s = tds_stack_create_ex(100, sizeof(uint64_t), &config);
+    CHECK(s != NULL && s->allocated == 8, "pilha em array deveria começar com um bloco");
+    if (!s) {
+        return;
+    }
+    for (uint64_t i = 0; i < 120; i++) {
+        CHECK(tds_stack_push(s, &i) == (i < 100), "push em array incorreto");
+    }
+    CHECK(s->allocated == 100, "pilha em array não deveria passar da capacidade");
+    for (uint64_t i = 100; i-- > 0;) {
+        uint64_t value;
+        CHECK(tds_stack_pop(s, &value) && value == i, "ordem LIFO incorreta em array");
+    }
+    CHECK(tds_stack_empty(s) && !tds_stack_push_threadsafe(s, &config), "threadsafe deveria exigir o modo lock-free");
+    tds_stack_destroy(s);
+
+    printf("Testes dos modos da pilha concluídos.\n");
+}
+
+#define TREIBER_THREADS 4
+#define TREIBER_ROUNDS  100000
+
+static tds_stack_t      treiber_stack;
+static _Atomic uint64_t treiber_sum;
+
+// Cada thread empilha e desempilha valores únicos; a soma final detecta perdas ou duplicações
+static void* treiber_worker(void* arg) {
+    uint32_t id  = (uint32_t) (uintptr_t) arg;
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < TREIBER_ROUNDS; i++) {
+        uint64_t value = ((uint64_t) id << 32) | i;
+        while (!tds_stack_push_threadsafe(treiber_stack, &value)) {
+        }
+        if (tds_stack_pop_threadsafe(treiber_stack, &value)) {
+            sum += value;
+        }
+    }
+    atomic_fetch_add(&treiber_sum, sum);
+    return NULL;
+}
+
+// Testa a pilha de Treiber com várias threads fazendo push/pop concorrentes
+void test_treiber_stack() {
+    printf("Iniciando testes da pilha lock-free...\n");
+
+    tds_stack_config_t config = TDS_STACK_CONFIG_DEFAULT;
+    config.mode               = TDS_STACK_MODE_LOCKFREE;
+
+    // Capacidade pequena: os nós são reutilizados o tempo todo, exercitando o ABA
+    treiber_stack = tds_stack_create_ex(TREIBER_THREADS, sizeof(uint64_t), &config);
+    CHECK(treiber_stack != NULL, "falha ao criar a pilha lock-free");
+    if (!treiber_stack) {
+        return;
+    }
+    atomic_store(&treiber_sum, 0);
+
+    pthread_t threads[TREIBER_THREADS];
+    for (uintptr_t i = 0; i < TREIBER_THREADS; i++) {
+        pthread_create(&threads[i], NULL, treiber_worker, (void*) i);
+    }
+    for (int i = 0; i < TREIBER_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    uint64_t value, sum = atomic_load(&treiber_sum);
+    while (tds_stack_pop(treiber_stack, &value)) {
+        sum += value;
+    }
+
+    uint64_t expected = 0;
+    for (uint64_t id = 0; id < TREIBER_THREADS; id++) {
+        expected += (id << 32) * TREIBER_ROUNDS + (uint64_t) TREIBER_ROUNDS * (TREIBER_ROUNDS - 1) / 2;
+    }
+    CHECK(sum == expected, "valores perdidos ou duplicados na pilha lock-free");
+    tds_stack_destroy(treiber_stack);
+
+    printf("Testes da pilha lock-free concluídos.\n");
+}
+
+// Testa a lista desenrolada contra um array de referência (inserções e remoções aleatórias)
+void test_unrolled_list() {
+    printf("Iniciando testes da lista desenrolada...\n");
+
+    enum { LIST_MAX = 2000 };
+    static uint32_t reference[LIST_MAX];
+    uint32_t        count = 0;
+
+    tds_list_t list = tds_list_create(LIST_MAX, sizeof(uint32_t));
+    CHECK(list != NULL, "falha ao criar a lista");
+    if (!list) {
+        return;
+    }
+
+    srand(12345);
+    for (uint32_t op = 0; op < 20000; op++) {
+        uint32_t value = op;
+        if (count < LIST_MAX && (rand() % 3 != 0 || count == 0)) {
+            uint32_t index = (uint32_t) rand() % (count + 1);
+            CHECK(tds_list_insert(list, index, &value), "falha ao inserir na lista");
+            memmove(&reference[index + 1], &reference[index], (count - index) * sizeof(uint32_t));
+            reference[index] = value;
+            count++;
+        } else {
+            uint32_t index = (uint32_t) rand() % count;
+            CHECK(tds_list_remove(list, index, &value) && value == reference[index], "remoção retornou valor incorreto");
+            memmove(&reference[index], &reference[index + 1], (count - index - 1) * sizeof(uint32_t));
+            count--;
+        }
+    }
+    CHECK(tds_list_size(list) == (int) count, "tamanho da lista incorreto");
+
+    // Percorrer por elemento e por blocos contíguos deve dar a mesma sequência
+    tds_list_iterator_t it    = tds_list_begin(list);
+    uint32_t            seen  = 0;
+    bool                match = true;
+    for (uint32_t* element; (element = (uint32_t*) tds_list_next(&it)) != NULL; seen++) {
+        match = match && seen < count && *element == reference[seen];
+    }
+    CHECK(match && seen == count, "iteração por elemento incorreta");
+
+    it    = tds_list_begin(list);
+    seen  = 0;
+    match = true;
+    uint32_t  span_count;
+    uint32_t* span;
+    while ((span = (uint32_t*) tds_list_next_span(&it, &span_count)) != NULL) {
+        for (uint32_t i = 0; i < span_count; i++, seen++) {
+            match = match && seen < count && span[i] == reference[seen];
+        }
+    }
+    CHECK(match && seen == count, "iteração por blocos incorreta");
+
+    uint32_t value;
+    CHECK(tds_list_get(list, count / 2, &value) && value == reference[count / 2], "get incorreto");
+    CHECK(tds_list_find(list, &reference[count - 1]) == (int) count - 1, "find não achou o último elemento");
+    value = UINT32_MAX;
+    CHECK(tds_list_find(list, &value) == -1, "find achou elemento inexistente");
+    CHECK(!tds_list_insert(list, count + 1, &value) && !tds_list_remove(list, count, NULL), "índices fora do intervalo aceitos");
+
+    CHECK(tds_list_clear(list) && tds_list_empty(list), "clear da lista incorreto");
+    value = 1;
+    CHECK(tds_list_push_back(list, &value), "push_back falhou");
+    value = 0;
+    CHECK(tds_list_push_front(list, &value), "push_front falhou");
+    CHECK(tds_list_get(list, 0, &value) && value == 0 && tds_list_get(list, 1, &value) && value == 1, "ordem incorreta após push_front");
+    tds_list_destroy(list);
+
+    // Nós vindos de um pool de blocos fixos
+    tds_pool_t      pool      = tds_pool_create(tds_list_node_size(sizeof(uint64_t)), 8);
+    tds_allocator_t allocator = tds_pool_allocator(pool);
+
+    tds_list_config_t config = TDS_LIST_CONFIG_DEFAULT;
+    config.allocator         = &allocator;
+    list                     = tds_list_create_ex(1000, sizeof(uint64_t), &config);
+    uint64_t big             = 0;
+    while (tds_list_push_back(list, &big)) {
+        big++;
+    }
+    CHECK(big >= 8 && tds_pool_available(pool) == 0, "lista deveria esgotar o pool");
+    tds_list_destroy(list);
+    CHECK(tds_pool_available(pool) == 8, "nós da lista não devolvidos ao pool");
+    tds_pool_destroy(pool);
+
+    printf("Testes da lista desenrolada concluídos.\n");
+}
+
+typedef struct {
+    uint32_t         id;
+    tds_list_link_t  link;   // lista duplamente encadeada
+    tds_slist_link_t slink;  // lista simplesmente encadeada
+} intrusive_item_t;
+
+// Testa as listas intrusivas: objetos vindos de um pool, sem alocação pela lista
+void test_intrusive_list() {
+    printf("Iniciando testes das listas intrusivas...\n");
+
+    tds_pool_t pool = tds_pool_create(sizeof(intrusive_item_t), 10);
+    CHECK(pool != NULL, "falha ao criar o pool");
+    if (!pool) {
+        return;
+    }
+
+    tds_list_link_t  head;
+    tds_slist_link_t shead;
+    tds_list_link_init(&head);
+    tds_slist_init(&shead);
+    CHECK(tds_list_link_empty(&head) && tds_slist_empty(&shead) && !tds_list_link_first(&head), "listas deveriam começar vazias");
+
+    intrusive_item_t* items[10];
+    for (uint32_t i = 0; i < 10; i++) {
+        items[i]     = (intrusive_item_t*) tds_pool_alloc(pool);
+        items[i]->id = i;
+        tds_list_link_push_back(&head, &items[i]->link);
+        tds_slist_push_front(&shead, &items[i]->slink);
+    }
+
+    // Remover os pares durante a iteração (duplamente encadeada)
+    intrusive_item_t *item, *next;
+    TDS_LIST_FOREACH_ENTRY_SAFE(item, next, &head, intrusive_item_t, link) {
+        if (item->id % 2 == 0) {
+            tds_list_link_remove(&item->link);
+            CHECK(!tds_list_link_linked(&item->link), "link removido ainda marcado como ligado");
+        }
+    }
+    uint32_t expected = 1, count = 0;
+    TDS_LIST_FOREACH_ENTRY(item, &head, intrusive_item_t, link) {
+        CHECK(item->id == expected, "ordem incorreta na lista intrusiva");
+        expected += 2;
+        count++;
+    }
+    CHECK(count == 5, "remoção durante a iteração incorreta");
+    CHECK(TDS_CONTAINER_OF(tds_list_link_last(&head), intrusive_item_t, link)->id == 9, "último elemento incorreto");
+
+    // Remover os múltiplos de 3 da lista simples (ordem inversa de inserção)
+    tds_slist_link_t *prev, *pos;
+    TDS_SLIST_FOREACH_SAFE(prev, pos, &shead) {
+        if (TDS_CONTAINER_OF(pos, intrusive_item_t, slink)->id % 3 == 0) {
+            tds_slist_remove_after(prev);
+        }
+    }
+    uint32_t sum = 0;
+    count        = 0;
+    TDS_SLIST_FOREACH_SAFE(prev, pos, &shead) {
+        sum += TDS_CONTAINER_OF(pos, intrusive_item_t, slink)->id;
+        count++;
+    }
+    CHECK(count == 6 && sum == 1 + 2 + 4 + 5 + 7 + 8, "remoção na lista simples incorreta");
+
+    // Esvaziar as duas listas e devolver todos os objetos ao pool
+    tds_slist_link_t* link;
+    count = 0;
+    while ((link = tds_slist_pop_front(&shead)) != NULL) {
+        count++;
+    }
+    tds_list_link_t *lpos, *ltmp;
+    TDS_LIST_FOREACH_SAFE(lpos, ltmp, &head) {
+        tds_list_link_remove(lpos);
+        count++;
+    }
+    CHECK(count == 11 && tds_list_link_empty(&head) && tds_slist_empty(&shead), "esvaziamento das listas incorreto");
+    for (uint32_t i = 0; i < 10; i++) {
+        tds_pool_free(pool, items[i]);
+    }
+    CHECK(tds_pool_available(pool) == 10, "objetos não devolvidos ao pool");
+    tds_pool_destroy(pool);
+
+    printf("Testes das listas intrusivas concluídos.\n");
+}
+
+#define CONC_WRITERS 2
+#define CONC_READERS 4
+#define CONC_KEYS    20000
+
+typedef struct {
+    uint64_t a;
+    uint64_t b;  // sempre igual a "a": detecta leituras rasgadas
+} conc_value_t;
+
+static tds_hashtable_t conc_table;
+static _Atomic int     conc_writers_done;
+
+// Escritor concorrente: insere, sobrescreve e remove chaves da sua faixa
+static void* conc_writer(void* arg) {
+    uint32_t id = (uint32_t) (uintptr_t) arg;
+    for (uint32_t version = 1; version <= 3; version++) {
+        for (uint32_t k = id; k < CONC_KEYS; k += CONC_WRITERS) {
+            conc_value_t value = {(uint64_t) k * 10 + version, (uint64_t) k * 10 + version};
+            if (!tds_hashtable_put(conc_table, &k, &value)) {
+                printf("Erro: falha ao inserir a chave %u concorrentemente.\n", k);
+                failures++;
+            }
+        }
+    }
+    for (uint32_t k = id; k < CONC_KEYS; k += CONC_WRITERS) {
+        if (k % 5 == 0) {
+            tds_hashtable_remove(conc_table, &k, NULL);
+        }
+    }
+    atomic_fetch_add(&conc_writers_done, 1);
+    return NULL;
+}
+
+// Leitor concorrente: toda leitura encontrada deve ser consistente
+static void* conc_reader(void* arg) {
+    (void) arg;
+    conc_value_t value;
+    uint32_t     k = 0;
+    while (atomic_load(&conc_writers_done) < CONC_WRITERS) {
+        k = (k + 7919) % CONC_KEYS;
+        if (tds_hashtable_get(conc_table, &k, &value) && (value.a != value.b || value.a / 10 != k)) {
+            printf("Erro: leitura inconsistente da chave %u.\n", k);
+            failures++;
+        }
+    }
+    return NULL;
+}
+
+// Alocador que conta os bytes vivos (tamanho guardado antes de cada bloco)
+typedef struct {
+    size_t live;
+} counting_alloc_t;
+
+static void* counting_alloc(void* context, size_t size) {
+    counting_alloc_t* counter = (counting_alloc_t*) context;
+    max_align_t*      block   = (max_align_t*) malloc(sizeof(max_align_t) + size);
+    if (!block) {
+        return NULL;
+    }
+    memcpy(block, &size, sizeof(size));
+    counter->live += size;
+    return block + 1;
+}
+
+static void counting_free(void* context, void* ptr) {
+    counting_alloc_t* counter = (counting_alloc_t*) context;
+    max_align_t*      block   = (max_align_t*) ptr - 1;
+    size_t            size;
+    memcpy(&size, block, sizeof(size));
+    counter->live -= size;
+    free(block);
+}
+
+#define CHURN_KEYS   400000
+#define CHURN_WINDOW 870  // Abaixo de metade do limite de ocupação: força purgas no mesmo tamanho
+
+static _Atomic uint32_t churn_inserted;
+
+// Leitor durante as purgas: uma chave que ficou na janela durante toda a busca deve ser encontrada
+static void* churn_reader(void* arg) {
+    (void) arg;
+    uint32_t value;
+    while (!atomic_load(&conc_writers_done)) {
+        uint32_t inserted = atomic_load(&churn_inserted);
+        if (inserted < 16) {
+            continue;
+        }
+        uint32_t k     = inserted - 16;
+        bool     found = tds_hashtable_get(conc_table, &k, &value);
+        if ((found && value != k) || (!found && atomic_load(&churn_inserted) - 1 < k + CHURN_WINDOW)) {
+            printf("Erro: chave %u perdida durante uma purga.\n", k);
+            failures++;
+        }
+    }
+    return NULL;
+}
+
+// Testa a hashtable em modo concorrente: leitores sem lock e escritores com stripes
+void test_concurrent_hashtable() {
+    printf("Iniciando testes da hashtable concorrente...\n");
+
+    tds_hashtable_config_t config = TDS_HASHTABLE_CONFIG_DEFAULT;
+    config.concurrent             = true;
+
+    conc_table = tds_hashtable_create_ex(16, sizeof(uint32_t), sizeof(conc_value_t), &config);
+    CHECK(conc_table != NULL, "falha ao criar a hashtable concorrente");
+    if (!conc_table) {
+        return;
+    }
+    atomic_store(&conc_writers_done, 0);
+
+    pthread_t writers[CONC_WRITERS], readers[CONC_READERS];
+    for (uintptr_t i = 0; i < CONC_READERS; i++) {
+        pthread_create(&readers[i], NULL, conc_reader, NULL);
+    }
+    for (uintptr_t i = 0; i < CONC_WRITERS; i++) {
+        pthread_create(&writers[i], NULL, conc_writer, (void*) i);
+    }
+    for (int i = 0; i < CONC_WRITERS; i++) {
+        pthread_join(writers[i], NULL);
+    }
+    for (int i = 0; i < CONC_READERS; i++) {
+        pthread_join(readers[i], NULL);
+    }
+
+    conc_value_t value;
+    for (uint32_t k = 0; k < CONC_KEYS; k++) {
+        bool found = tds_hashtable_get(conc_table, &k, &value);
+        CHECK(found == (k % 5 != 0), "presença incorreta após escrita concorrente");
+        CHECK(!found || value.a == (uint64_t) k * 10 + 3, "valor final incorreto após escrita concorrente");
+    }
+    CHECK(tds_hashtable_size(conc_table) == CONC_KEYS - CONC_KEYS / 5, "tamanho incorreto após escrita concorrente");
+    CHECK(tds_hashtable_clear(conc_table) && tds_hashtable_size(conc_table) == 0, "clear concorrente incorreto");
+    tds_hashtable_destroy(conc_table);
+
+    // Janela deslizante de chaves vivas abaixo de metade do limite: as purgas
+    // de tombstones não podem reter tabelas antigas
+    counting_alloc_t       counter   = {0};
+    tds_allocator_t        allocator = {counting_alloc, counting_free, &counter};
+    tds_hashtable_config_t cconfig   = TDS_HASHTABLE_CONFIG_DEFAULT;
+    cconfig.concurrent               = true;
+    cconfig.allocator                = &allocator;
+    tds_hashtable_t churn            = tds_hashtable_create_ex(1024, sizeof(uint32_t), sizeof(uint32_t), &cconfig);
+    CHECK(churn != NULL, "falha ao criar a hashtable concorrente com alocador");
+    if (churn) {
+        size_t    baseline = counter.live;
+        pthread_t readers[CONC_READERS];
+        conc_table         = churn;
+        atomic_store(&churn_inserted, 0);
+        atomic_store(&conc_writers_done, 0);
+        for (int i = 0; i < CONC_READERS; i++) {
+            pthread_create(&readers[i], NULL, churn_reader, NULL);
+        }
+        for (uint32_t k = 0; k < CHURN_KEYS; k++) {
+            tds_hashtable_put(churn, &k, &k);
+            atomic_store(&churn_inserted, k + 1);
+            if (k >= CHURN_WINDOW) {
+                uint32_t old = k - CHURN_WINDOW;
+                CHECK(tds_hashtable_remove(churn, &old, NULL), "falha ao remover na janela deslizante");
+            }
+        }
+        atomic_store(&conc_writers_done, 1);
+        for (int i = 0; i < CONC_READERS; i++) {
+            pthread_join(readers[i], NULL);
+        }
+        CHECK(tds_hashtable_size(churn) == CHURN_WINDOW, "tamanho incorreto após a janela deslizante");
+        CHECK(counter.live == baseline, "purgas de tombstones retiveram tabelas antigas");
+        tds_hashtable_destroy(churn);
+        CHECK(counter.live == 0, "memória da hashtable concorrente não liberada");
+    }
+
+    printf("Testes da hashtable concorrente concluídos.\n");
+}
+
+void test_stats() {
+    printf("Iniciando testes das estatísticas...\n");
+
+    tds_queue_config_t qconfig = TDS_QUEUE_CONFIG_DEFAULT;
+    qconfig.mode               = TDS_QUEUE_MODE_RING;
+    tds_queue_t      q         = tds_queue_create_ex(4, sizeof(int), &qconfig);
+    tds_stack_t      s         = tds_stack_create(4, sizeof(int));
+    tds_ringbuffer_t rb        = tds_ringbuffer_create(4, sizeof(int));
+    tds_hashtable_t  ht        = tds_hashtable_create(8, sizeof(int), sizeof(int));
+    tds_list_t       list      = tds_list_create(4, sizeof(int));
+    tds_pool_t       pool      = tds_pool_create(sizeof(int), 2);
+    CHECK(q && s && rb && ht && list && pool, "falha ao criar as instâncias das estatísticas");
+    if (!q || !s || !rb || !ht || !list || !pool) {
+        return;
+    }
+
+    int value = 0;
+    for (int i = 0; i < 5; i++) {
+        tds_queue_enqueue(q, &i);
+        tds_stack_push(s, &i);
+        tds_ringbuffer_try_push(rb, &i);
+        tds_hashtable_put(ht, &i, &i);
+        tds_list_push_back(list, &i);
+    }
+    for (int i = 0; i < 6; i++) {
+        tds_queue_dequeue(q, &value);
+        tds_stack_pop(s, &value);
+        tds_ringbuffer_try_pop(rb, &value);
+    }
+    int missing = 99;
+    tds_hashtable_get(ht, &missing, &value);
+    CHECK(tds_list_find(list, &missing) == -1, "find achou elemento inexistente");
+    void* a = tds_pool_alloc(pool);
+    void* b = tds_pool_alloc(pool);
+    CHECK(tds_pool_alloc(pool) == NULL, "pool deveria estar esgotado");
+    tds_pool_free(pool, a);
+    tds_pool_free(pool, b);
+
+    tds_stats_t stats;
+    bool        enabled = tds_queue_get_stats(q, &stats);
+    CHECK(enabled == (TDS_ENABLE_STATS != 0), "get_stats deveria refletir TDS_ENABLE_STATS");
+    CHECK(!tds_queue_get_stats(NULL, &stats) && !tds_queue_get_stats(q, NULL), "get_stats deveria rejeitar argumentos nulos");
+
+    if (enabled) {
+        CHECK(stats.operations == 8 && stats.failed_full == 1 && stats.failed_empty == 2, "contadores da fila incorretos");
+        CHECK(stats.high_water == 4 && stats.allocations == 1 && stats.allocated_bytes == 4 * sizeof(int), "memória/ocupação da fila incorreta");
+
+        CHECK(tds_stack_get_stats(s, &stats), "get_stats da pilha falhou");
+        CHECK(stats.operations == 8 && stats.failed_full == 1 && stats.failed_empty == 2 && stats.high_water == 4, "contadores da pilha incorretos");
+        CHECK(stats.allocations == 4 && stats.allocated_bytes == 4 * tds_stack_node_size(sizeof(int)), "alocações da pilha incorretas");
+
+        CHECK(tds_ringbuffer_get_stats(rb, &stats), "get_stats do ring buffer falhou");
+        CHECK(stats.operations == 8 && stats.failed_full == 1 && stats.failed_empty == 2 && stats.high_water == 4, "contadores do ring buffer incorretos");
+
+        CHECK(tds_hashtable_get_stats(ht, &stats), "get_stats da hashtable falhou");
+        CHECK(stats.operations == 5 && stats.failed_empty == 1 && stats.high_water == 5 && stats.allocations >= 1, "contadores da hashtable incorretos");
+
+        CHECK(tds_list_get_stats(list, &stats), "get_stats da lista falhou");
+        CHECK(stats.operations == 5 && stats.failed_full == 1 && stats.failed_empty == 0 && stats.high_water == 4 && stats.allocations >= 1,
+              "contadores da lista incorretos");
+
+        CHECK(tds_pool_get_stats(pool, &stats), "get_stats do pool falhou");
+        CHECK(stats.operations == 4 && stats.failed_empty == 1 && stats.high_water == 2 && stats.allocations == 1, "contadores do pool incorretos");
+
+        // Falha de alocação de nó também conta como failed_full
+        tds_pool_t         node_pool  = tds_pool_create(tds_stack_node_size(sizeof(int)), 1);
+        tds_allocator_t    node_alloc = tds_pool_allocator(node_pool);
+        tds_stack_config_t sconfig    = {.mode = TDS_STACK_MODE_LINKED, .allocator = &node_alloc, .chunk = 0};
+        tds_stack_t        limited    = tds_stack_create_ex(4, sizeof(int), &sconfig);
+        CHECK(limited && tds_stack_push(limited, &value) && !tds_stack_push(limited, &value) && tds_stack_push_n(limited, &value, 1) == 0,
+              "pilha com pool esgotado deveria falhar");
+        CHECK(tds_stack_get_stats(limited, &stats) && stats.failed_full == 2, "falha de alocação da pilha não contada");
+        tds_stack_destroy(limited);
+        tds_pool_destroy(node_pool);
+    } else {
+        CHECK(stats.operations == 0 && stats.high_water == 0, "estatísticas desativadas deveriam vir zeradas");
+        CHECK(!tds_stack_get_stats(s, &stats) && !tds_ringbuffer_get_stats(rb, &stats) && !tds_hashtable_get_stats(ht, &stats) &&
+                  !tds_list_get_stats(list, &stats) && !tds_pool_get_stats(pool, &stats),
+              "get_stats deveria falhar sem TDS_ENABLE_STATS");
+    }
+
+    tds_queue_destroy(q);
+    tds_stack_destroy(s);
+    tds_ringbuffer_destroy(rb);
+    tds_hashtable_destroy(ht);
+    tds_list_destroy(list);
+    tds_pool_destroy(pool);
+
+    printf("Testes das estatísticas concluídos.\n");
+}
+
+void test_arena() {
+    printf("Iniciando testes da arena...\n");
+
+    tds_arena_t arena = tds_arena_create(256);
+    CHECK(arena != NULL, "falha ao criar a arena");
+    if (!arena) {
+        return;
+    }
+
+    uint8_t* a = (uint8_t*) tds_arena_alloc(arena, 3);
+    uint8_t* b = (uint8_t*) tds_arena_alloc(arena, 5);
+    CHECK(a && b && b > a && (uintptr_t) b % _Alignof(max_align_t) == 0, "alocações da arena desalinhadas");
+    CHECK(tds_arena_alloc(arena, 0) == NULL, "alocação de 0 bytes deveria falhar");
+
+    // Pedido maior que o bloco recebe um bloco próprio
+    uint8_t* big = (uint8_t*) tds_arena_alloc(arena, 1000);
+    CHECK(big != NULL, "alocação grande na arena falhou");
+    if (big) {
+        memset(big, 0xAB, 1000);
+    }
+    size_t used = tds_arena_used(arena);
+    CHECK(used >= 1008, "bytes em uso incorretos na arena");
+
+    CHECK(tds_arena_reset(arena) && tds_arena_used(arena) == 0, "reset da arena incorreto");
+    CHECK(tds_arena_alloc(arena, 3) == a, "reset deveria reaproveitar o primeiro bloco");
+    tds_arena_reset(arena);
+
+    // Contêineres cujos nós vêm da arena: destroy não libera nó a nó
+    tds_allocator_t    allocator = tds_arena_allocator(arena);
+    tds_stack_config_t sconfig   = TDS_STACK_CONFIG_DEFAULT;
+    tds_queue_config_t qconfig   = TDS_QUEUE_CONFIG_DEFAULT;
+    tds_list_config_t  lconfig   = TDS_LIST_CONFIG_DEFAULT;
+    sconfig.allocator            = &allocator;
+    qconfig.allocator            = &allocator;
+    lconfig.allocator            = &allocator;
+    CHECK(allocator.free == NULL, "alocador da arena não deveria ter free");
+
+    for (int frame = 0; frame < 3; frame++) {
+        tds_stack_t s = tds_stack_create_ex(100, sizeof(int), &sconfig);
+        tds_queue_t q = tds_queue_create_ex(100, sizeof(int), &qconfig);
+        tds_list_t  l = tds_list_create_ex(100, sizeof(int), &lconfig);
+        CHECK(s && q && l, "falha ao criar contêineres sobre a arena");
+        if (!s || !q || !l) {
+            break;
+        }
+
+        for (int i = 0; i < 100; i++) {
+            tds_stack_push(s, &i);
+            tds_queue_enqueue(q, &i);
+            tds_list_push_back(l, &i);
+        }
+        int value = -1, sum = 0;
+        for (int i = 0; i < 50; i++) {
+            tds_stack_pop(s, &value);
+            sum += value;
+            tds_queue_dequeue(q, &value);
+            sum += value;
+            tds_list_remove(l, 0, &value);
+            sum += value;
+        }
+        CHECK(sum == (50 + 99) * 50 / 2 + 2 * (49 * 50 / 2), "valores incorretos nos contêineres sobre a arena");
+        CHECK(tds_arena_used(arena) > 0, "nós deveriam vir da arena");
+
+        CHECK(tds_stack_destroy(s) && tds_queue_destroy(q) && tds_list_destroy(l), "destroy sobre a arena falhou");
+        tds_arena_reset(arena);
+    }
+
+    tds_arena_destroy(arena);
+    printf("Testes da arena concluídos.\n");
+}
+
+void test_static_init() {
+    printf("Iniciando testes de inicialização estática...\n");
+
+    enum { CAP = 64 };
+    static _Alignas(max_align_t) uint8_t pool_mem[TDS_POOL_STORAGE_SIZE(64, 2 * CAP)];
+    static _Alignas(max_align_t) uint8_t arena_mem[TDS_ARENA_STORAGE_SIZE(4096)];
+    static _Alignas(max_align_t) uint8_t ring_mem[TDS_QUEUE_STORAGE_SIZE(CAP, sizeof(int))];
+    static _Alignas(max_align_t) uint8_t mpmc_mem[TDS_QUEUE_MPMC_STORAGE_SIZE(CAP, sizeof(int))];
+    static _Alignas(max_align_t) uint8_t lqueue_mem[TDS_QUEUE_INSTANCE_SIZE];
+    static _Alignas(max_align_t) uint8_t astack_mem[TDS_STACK_STORAGE_SIZE(CAP, sizeof(int))];
+    static _Alignas(max_align_t) uint8_t lfstack_mem[TDS_STACK_LOCKFREE_STORAGE_SIZE(CAP, sizeof(int))];
+    static _Alignas(max_align_t) uint8_t rb_mem[TDS_RINGBUFFER_STORAGE_SIZE(CAP, sizeof(int))];
+    static _Alignas(max_align_t) uint8_t list_mem[TDS_LIST_INSTANCE_SIZE];
+    static _Alignas(max_align_t) uint8_t ht_mem[TDS_HASHTABLE_INSTANCE_SIZE];
+
+    tds_pool_t  pool  = tds_pool_init_static(pool_mem, sizeof(pool_mem), 64, 2 * CAP);
+    tds_arena_t arena = tds_arena_init_static(arena_mem, sizeof(arena_mem));
+    CHECK(pool && arena, "falha ao criar pool/arena estáticos");
+    if (!pool || !arena) {
+        return;
+    }
+    CHECK(tds_pool_init_static(pool_mem + 1, sizeof(pool_mem) - 1, 64, 2 * CAP) == NULL, "armazenamento desalinhado deveria falhar");
+    CHECK(tds_pool_init_static(pool_mem, sizeof(pool_mem) - 1, 64, 2 * CAP) == NULL, "armazenamento pequeno deveria falhar");
+
+    // A arena estática não cresce: esgota e falha
+    CHECK(tds_arena_alloc(arena, 8192) == NULL, "arena estática não deveria crescer");
+    tds_arena_reset(arena);
+
+    tds_allocator_t    pool_alloc  = tds_pool_allocator(pool);
+    tds_allocator_t    arena_alloc = tds_arena_allocator(arena);
+    tds_queue_config_t qconfig     = {.mode = TDS_QUEUE_MODE_MPMC, .allocator = NULL};
+    tds_queue_config_t lqconfig    = {.mode = TDS_QUEUE_MODE_LINKED, .allocator = &pool_alloc};
+    tds_stack_config_t lfconfig    = {.mode = TDS_STACK_MODE_LOCKFREE, .allocator = NULL, .chunk = 0};
+    tds_list_config_t  lconfig     = {.allocator = &arena_alloc};
+
+    tds_queue_t ring   = tds_queue_init_static(ring_mem, sizeof(ring_mem), CAP, sizeof(int), NULL);
+    tds_queue_t mpmc   = tds_queue_init_static(mpmc_mem, sizeof(mpmc_mem), CAP, sizeof(int), &qconfig);
+    tds_queue_t lqueue = tds_queue_init_static(lqueue_mem, sizeof(lqueue_mem), CAP, sizeof(int), &lqconfig);
+    tds_stack_t astack = tds_stack_init_static(astack_mem, sizeof(astack_mem), CAP, sizeof(int), NULL);
+    tds_stack_t lstack = tds_stack_init_static(lfstack_mem, sizeof(lfstack_mem), CAP, sizeof(int), &lfconfig);
+    tds_list_t  list   = tds_list_init_static(list_mem, sizeof(list_mem), CAP, sizeof(int), &lconfig);
+    tds_ringbuffer_t rb = tds_ringbuffer_init_static(rb_mem, sizeof(rb_mem), CAP, sizeof(int));
+    CHECK(ring && mpmc && lqueue && astack && lstack && list && rb, "falha ao criar contêineres estáticos");
+
+    CHECK(tds_queue_init_static(ring_mem, sizeof(ring_mem) - 1, CAP, sizeof(int), NULL) == NULL, "fila em armazenamento pequeno deveria falhar");
+    CHECK(tds_queue_init_static(lqueue_mem, sizeof(lqueue_mem), CAP, sizeof(int), &(tds_queue_config_t) TDS_QUEUE_CONFIG_DEFAULT) == NULL,
+          "fila encadeada estática sem alocador deveria falhar");
+    CHECK(tds_stack_init_static(astack_mem, sizeof(astack_mem) - 1, CAP, sizeof(int), NULL) == NULL, "pilha em armazenamento pequeno deveria falhar");
+    CHECK(tds_stack_init_static(lfstack_mem, sizeof(lfstack_mem), 2 * CAP, sizeof(int), &lfconfig) == NULL, "pilha lock-free grande demais deveria falhar");
+    CHECK(tds_ringbuffer_init_static(rb_mem, sizeof(rb_mem), CAP - 1, sizeof(int)) == NULL, "capacidade não potência de dois deveria falhar");
+    CHECK(tds_list_init_static(list_mem, sizeof(list_mem), CAP, sizeof(int), NULL) == NULL, "lista estática sem alocador deveria falhar");
+    if (!ring || !mpmc || !lqueue || !astack || !lstack || !list || !rb) {
+        return;
+    }
+
+    int value = 0, sum = 0;
+    for (int i = 0; i < CAP; i++) {
+        CHECK(tds_queue_enqueue(ring, &i) && tds_queue_enqueue(mpmc, &i) && tds_queue_enqueue(lqueue, &i), "enfileirar em fila estática falhou");
+        CHECK(tds_stack_push(astack, &i) && tds_stack_push(lstack, &i), "empilhar em pilha estática falhou");
+        CHECK(tds_list_push_back(list, &i) && tds_ringbuffer_try_push(rb, &i), "inserir em lista/ring buffer estático falhou");
+    }
+    CHECK(!tds_queue_enqueue(ring, &value) && !tds_stack_push(astack, &value) && !tds_ringbuffer_try_push(rb, &value),
+          "contêineres estáticos deveriam estar cheios");
+
+    for (int i = 0; i < CAP / 2; i++) {
+        tds_queue_dequeue(ring, &value);
+        sum += value;
+        tds_queue_dequeue(mpmc, &value);
+        sum += value;
+        tds_queue_dequeue(lqueue, &value);
+        sum += value;
+        tds_stack_pop(astack, &value);
+        sum -= value;
+        tds_stack_pop(lstack, &value);
+        sum -= value;
+        tds_ringbuffer_try_pop(rb, &value);
+        sum += value;
+    }
+    // 4 filas FIFO retiram 0..31, 2 pilhas LIFO retiram 63..32
+    CHECK(sum == 4 * (31 * 32 / 2) - 2 * ((32 + 63) * 32 / 2), "valores incorretos nos contêineres estáticos");
+
+    // Hashtable estática: tabelas vêm da arena
+    tds_hashtable_config_t hconfig = TDS_HASHTABLE_CONFIG_DEFAULT;
+    hconfig.allocator              = &arena_alloc;
+    tds_hashtable_t ht             = tds_hashtable_init_static(ht_mem, sizeof(ht_mem), 16, sizeof(int), sizeof(int), &hconfig);
+    CHECK(ht != NULL, "falha ao criar hashtable estática");
+    if (ht) {
+        for (int i = 0; i < 32; i++) {
+            int v = i * 3;
+            CHECK(tds_hashtable_put(ht, &i, &v), "put na hashtable estática falhou");
+        }
+        int key = 17;
+        CHECK(tds_hashtable_get(ht, &key, &value) && value == 51, "get na hashtable estática incorreto");
+        CHECK(tds_hashtable_destroy(ht), "destroy da hashtable estática falhou");
+    }
+    hconfig.concurrent = true;
+    CHECK(tds_hashtable_init_static(ht_mem, sizeof(ht_mem), 16, sizeof(int), sizeof(int), &hconfig) == NULL, "hashtable estática concorrente deveria falhar");
+
+    CHECK(tds_queue_destroy(ring) && tds_queue_destroy(mpmc) && tds_queue_destroy(lqueue), "destroy de fila estática falhou");
+    CHECK(tds_stack_destroy(astack) && tds_stack_destroy(lstack), "destroy de pilha estática falhou");
+    CHECK(tds_list_destroy(list) && tds_ringbuffer_destroy(rb), "destroy de lista/ring buffer estático falhou");
+    CHECK(tds_pool_destroy(pool) && tds_arena_destroy(arena), "destroy de pool/arena estáticos falhou");
+    printf("Testes de inicialização estática concluídos.\n");
+}
+
+static int heap_compare_int(const void* a, const void* b) {
+    int x = *(const int*) a, y = *(const int*) b;
+    return (x > y) - (x < y);
+}
+
+// Retira todos os elementos e verifica a ordem crescente
+static bool heap_drain_sorted(tds_heap_t heap, uint32_t expected) {
+    int      last = INT32_MIN, value;
+    uint32_t count = 0;
+    while (tds_heap_pop(heap, &value)) {
+        if (value < last) {
+            return false;
+        }
+        last = value;
+        count++;
+    }
+    return count == expected;
+}
+
+void test_heap() {
+    printf("Iniciando testes do heap d-ário...\n");
+
+    CHECK(tds_heap_create(16, sizeof(int), NULL) == NULL, "heap sem comparador deveria falhar");
+    tds_heap_config_t bad = {.compare = heap_compare_int, .arity = 1};
+    CHECK(tds_heap_create_ex(16, sizeof(int), &bad) == NULL, "aridade 1 deveria falhar");
+
+    const uint32_t arities[] = {0, 2, 16};
+    for (size_t a = 0; a < sizeof(arities) / sizeof(arities[0]); a++) {
+        tds_heap_config_t config = {.compare = heap_compare_int, .arity = arities[a]};
+        tds_heap_t        heap   = tds_heap_create_ex(1000, sizeof(int), &config);
+        CHECK(heap != NULL, "falha ao criar o heap");
+        if (!heap) {
+            return;
+        }
+
+        int value = 0;
+        CHECK(!tds_heap_pop(heap, &value) && !tds_heap_peek(heap, &value), "pop/peek em heap vazio deveriam falhar");
+
+        // Valores pseudoaleatórios com repetições
+        tds_heap_handle_t handles[1000];
+        for (int i = 0; i < 1000; i++) {
+            value = (i * 7919) % 503;
+            CHECK(tds_heap_push(heap, &value, &handles[i]), "push no heap falhou");
+        }
+        CHECK(!tds_heap_push(heap, &value, NULL), "push em heap cheio deveria falhar");
+        CHECK(tds_heap_peek(heap, &value) && value == 0, "topo do heap incorreto");
+
+        // Decrease-key leva o elemento ao topo; increase-key o afasta
+        value = -5;
+        CHECK(tds_heap_update(heap, handles[500], &value), "update do heap falhou");
+        CHECK(tds_heap_peek(heap, &value) && value == -5, "decrease-key não chegou ao topo");
+        value = 1000;
+        CHECK(tds_heap_update(heap, handles[500], &value), "increase-key falhou");
+        CHECK(tds_heap_peek(heap, &value) && value == 0, "increase-key deveria sair do topo");
+
+        // Remoção por handle e handle inválido depois dela
+        CHECK(tds_heap_remove(heap, handles[500], &value) && value == 1000, "remove por handle incorreto");
+        CHECK(!tds_heap_remove(heap, handles[500], NULL) && !tds_heap_update(heap, handles[500], &value), "handle removido deveria ser inválido");
+        CHECK(!tds_heap_update(heap, TDS_HEAP_INVALID_HANDLE, &value), "handle inválido deveria falhar");
+        CHECK(tds_heap_size(heap) == 999, "tamanho do heap incorreto");
+        CHECK(heap_drain_sorted(heap, 999), "heap não retirou em ordem");
+        CHECK(tds_heap_empty(heap), "heap deveria estar vazio");
+
+        // Heapify em massa sobre um heap já ocupado
+        int bulk[600];
+        for (int i = 0; i < 600; i++) {
+            bulk[i] = 600 - i;
+        }
+        value = 300;
+        tds_heap_push(heap, &value, NULL);
+        CHECK(tds_heap_heapify(heap, bulk, 600, handles), "heapify falhou");
+        CHECK(!tds_heap_heapify(heap, bulk, 600, NULL) && tds_heap_size(heap) == 601, "heapify além da capacidade deveria falhar sem inserir");
+        value = -1;
+        CHECK(tds_heap_update(heap, handles[0], &value) && tds_heap_peek(heap, &value) && value == -1, "handle do heapify não acompanha o elemento");
+        CHECK(heap_drain_sorted(heap, 601), "heap não retirou em ordem após heapify");
+
+        tds_heap_push(heap, &value, NULL);
+        CHECK(tds_heap_clear(heap) && tds_heap_empty(heap), "clear do heap falhou");
+        CHECK(tds_heap_destroy(heap), "destroy do heap falhou");
+    }
+
+    // Heap em memória do chamador
+    static _Alignas(max_align_t) uint8_t heap_mem[TDS_HEAP_STORAGE_SIZE(64, sizeof(int))];
+    tds_heap_config_t                    config = {.compare = heap_compare_int, .arity = 0};
+    CHECK(tds_heap_init_static(heap_mem, sizeof(heap_mem) - 1, 64, sizeof(int), &config) == NULL, "heap em armazenamento pequeno deveria falhar");
+    tds_heap_t heap = tds_heap_init_static(heap_mem, sizeof(heap_mem), 64, sizeof(int), &config);
+    CHECK(heap != NULL, "falha ao criar heap estático");
+    if (heap) {
+        for (int i = 64; i > 0; i--) {
+            tds_heap_push(heap, &i, NULL);
+        }
+        CHECK(heap_drain_sorted(heap, 64) && tds_heap_destroy(heap), "heap estático incorreto");
+    }
+
+    printf("Testes do heap d-ário concluídos.\n");
+}
+
+#define CACHE_THREADS 4
+#define CACHE_ROUNDS  20000
+
+static tds_cache_t cache_shared;
+static tds_queue_t cache_handoff;
+
+// Cada thread aloca blocos, entrega-os pela fila e libera os que receber (em geral de outra thread)
+static void* cache_worker(void* arg) {
+    uint32_t id = (uint32_t) (uintptr_t) arg;
+    for (uint32_t i = 0; i < CACHE_ROUNDS; i++) {
+        uint32_t* block = (uint32_t*) tds_cache_alloc(cache_shared);
+        if (!block) {
+            continue;
+        }
+        block[0] = id;
+        block[1] = i;
+        while (!tds_queue_enqueue_threadsafe(cache_handoff, &block)) {
+            uint32_t* other;
+            if (tds_queue_dequeue_threadsafe(cache_handoff, &other)) {
+                tds_cache_free(cache_shared, other);
+            }
+        }
+        uint32_t* other;
+        if (tds_queue_dequeue_threadsafe(cache_handoff, &other)) {
+            tds_cache_free(cache_shared, other);
+        }
+    }
+    tds_cache_flush(cache_shared);
+    return NULL;
+}
+
+void test_cache() {
+    printf("Iniciando testes do cache de blocos por thread...\n");
+
+    tds_cache_t cache = tds_cache_create(24, 4);
+    CHECK(cache != NULL && tds_cache_block_size(cache) >= 24, "falha ao criar o cache");
+
+    void* blocks[100];
+    bool  distinct = true;
+    for (int i = 0; i < 100; i++) {
+        blocks[i] = tds_cache_alloc(cache);
+        CHECK(blocks[i] != NULL, "alocação do cache falhou");
+        memset(blocks[i], i, 24);
+        for (int j = 0; j < i; j++) {
+            distinct = distinct && blocks[j] != blocks[i];
+        }
+    }
+    CHECK(distinct, "cache entregou o mesmo bloco duas vezes");
+    for (int i = 0; i < 100; i++) {
+        CHECK(tds_cache_free(cache, blocks[i]), "liberação no cache falhou");
+    }
+    void* again = tds_cache_alloc(cache);
+    CHECK(again == blocks[99], "cache deveria reutilizar o último bloco liberado");
+    tds_cache_free(cache, again);
+
+    tds_allocator_t allocator = tds_cache_allocator(cache);
+    CHECK(allocator.alloc(allocator.context, 4096) == NULL, "pedido maior que o bloco deveria falhar");
+
+    // Nós de uma pilha encadeada vindos do cache
+    tds_stack_config_t config = TDS_STACK_CONFIG_DEFAULT;
+    config.mode               = TDS_STACK_MODE_LINKED;
+    config.allocator          = &allocator;
+    tds_cache_destroy(cache);
+    cache              = tds_cache_create(64, 0);
+    allocator          = tds_cache_allocator(cache);
+    tds_stack_t stack  = tds_stack_create_ex(64, sizeof(int), &config);
+    int         value  = 0;
+    for (int i = 0; i < 64; i++) {
+        CHECK(tds_stack_push(stack, &i), "push com nós do cache falhou");
+    }
+    CHECK(tds_stack_pop(stack, &value) && value == 63, "pop com nós do cache incorreto");
+    tds_stack_destroy(stack);
+    CHECK(tds_cache_flush(cache) && tds_cache_destroy(cache), "flush/destroy do cache falhou");
+
+    // Alocações e liberações cruzadas entre threads
+    tds_queue_config_t qconfig = TDS_QUEUE_CONFIG_DEFAULT;
+    qconfig.mode               = TDS_QUEUE_MODE_MPMC;
+    cache_shared               = tds_cache_create(2 * sizeof(uint32_t), 8);
+    cache_handoff              = tds_queue_create_ex(64, sizeof(void*), &qconfig);
+
+    pthread_t threads[CACHE_THREADS];
+    for (uint32_t i = 0; i < CACHE_THREADS; i++) {
+        pthread_create(&threads[i], NULL, cache_worker, (void*) (uintptr_t) i);
+    }
+    for (uint32_t i = 0; i < CACHE_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    uint32_t* left;
+    while (tds_queue_dequeue_threadsafe(cache_handoff, &left)) {
+        CHECK(left[0] < CACHE_THREADS && left[1] < CACHE_ROUNDS, "bloco corrompido após troca entre threads");
+        tds_cache_free(cache_shared, left);
+    }
+
+    tds_stats_t stats;
+    if (tds_cache_get_stats(cache_shared, &stats)) {
+        CHECK(stats.operations == 2 * (uint64_t) CACHE_THREADS * CACHE_ROUNDS && stats.failed_empty == 0, "estatísticas do cache incorretas");
+        CHECK(stats.high_water <= CACHE_THREADS * 2 * 8 + 64 + 4 * 8 * 2, "cache criou blocos demais");
+    }
+
+    tds_queue_destroy(cache_handoff);
+    tds_cache_destroy(cache_shared);
+    printf("Testes do cache de blocos concluídos.\n");
+}
+
+#define BROADCAST_CONSUMERS 3
+
+static tds_ringbuffer_t broadcast_rb;
+static _Atomic uint8_t* broadcast_seen;
+static int              broadcast_errors[BROADCAST_CONSUMERS];
+
+// Consumidores 0 e 1 marcam cada elemento; o 2 só pode vê-lo depois de ambos
+static void* broadcast_consumer(void* arg) {
+    uint32_t id       = (uint32_t) (uintptr_t) arg;
+    int      expected = 0;
+    while (expected < NUM_OPERATIONS) {
+        uint32_t   n;
+        const int* span = (const int*) tds_ringbuffer_broadcast_peek_span(broadcast_rb, id, &n);
+        if (!span) {
+            continue;
+        }
+        for (uint32_t i = 0; i < n; i++, expected++) {
+            if (span[i] != expected) {
+                broadcast_errors[id]++;
+                expected = span[i];
+            }
+            if (id < 2) {
+                atomic_fetch_add_explicit(&broadcast_seen[span[i]], 1, memory_order_relaxed);
+            } else if (atomic_load_explicit(&broadcast_seen[span[i]], memory_order_relaxed) != 2) {
+                broadcast_errors[id]++;
+            }
+        }
+        tds_ringbuffer_broadcast_consume(broadcast_rb, id, n);
+    }
+    return NULL;
+}
+
+void test_broadcast_ringbuffer() {
+    printf("Iniciando testes do ring buffer broadcast...\n");
+
+    uint32_t         depends[BROADCAST_CONSUMERS] = {0, 0, 0x3};
+    uint32_t         cyclic[2]                    = {0x2, 0};
+    tds_ringbuffer_t rb                           = tds_ringbuffer_create_broadcast(4, sizeof(int), BROADCAST_CONSUMERS, depends);
+    CHECK(rb != NULL, "falha ao criar ring buffer broadcast");
+    CHECK(tds_ringbuffer_create_broadcast(4, sizeof(int), 2, cyclic) == NULL, "dependência de índice maior deveria falhar");
+    CHECK(tds_ringbuffer_create_broadcast(4, sizeof(int), TDS_RINGBUFFER_MAX_CONSUMERS + 1, NULL) == NULL,
+          "consumidores demais deveria falhar");
+    if (!rb) {
+        return;
+    }
+
+    int values[4] = {10, 11, 12, 13};
+    int value;
+    CHECK(tds_ringbuffer_push_bulk(rb, values, 4) == 4 && tds_ringbuffer_full(rb), "buffer broadcast deveria encher com 4");
+    CHECK(!tds_ringbuffer_broadcast_pop(rb, 2, &value), "consumidor dependente não deveria ver nada ainda");
+    CHECK(tds_ringbuffer_broadcast_pop(rb, 0, &value) && value == 10, "consumidor 0 leu valor incorreto");
+    CHECK(tds_ringbuffer_broadcast_pop(rb, 0, &value) && value == 11, "consumidor 0 leu valor incorreto");
+    CHECK(!tds_ringbuffer_broadcast_pop(rb, 2, &value), "consumidor 2 deveria esperar o consumidor 1");
+    CHECK(tds_ringbuffer_broadcast_consume(rb, 1, 1) == 1, "consumidor 1 deveria liberar 1");
+
+    uint32_t   n;
+    const int* span = (const int*) tds_ringbuffer_broadcast_peek_span(rb, 2, &n);
+    CHECK(span != NULL && n == 1 && span[0] == 10, "consumidor 2 deveria ver só o elemento liberado por ambos");
+    CHECK(tds_ringbuffer_broadcast_consume(rb, 2, 4) == 1, "consume deveria parar no limite das dependências");
+    CHECK(tds_ringbuffer_size(rb) == 3, "tamanho deveria seguir o consumidor mais lento");
+    CHECK(tds_ringbuffer_try_push(rb, &values[0]) && !tds_ringbuffer_try_push(rb, &values[1]),
+          "produtor deveria esperar só pelo consumidor mais lento");
+    CHECK(tds_ringbuffer_try_pop(rb, &value) && value == 12, "API SPSC deveria usar o consumidor 0");
+    CHECK(!tds_ringbuffer_broadcast_pop(rb, BROADCAST_CONSUMERS, &value), "índice de consumidor inválido deveria falhar");
+    tds_ringbuffer_destroy(rb);
+
+    // Um produtor, três consumidores em threads, o terceiro depende dos dois primeiros
+    broadcast_rb   = tds_ringbuffer_create_broadcast(256, sizeof(int), BROADCAST_CONSUMERS, depends);
+    broadcast_seen = (_Atomic uint8_t*) calloc(NUM_OPERATIONS, sizeof(uint8_t));
+    CHECK(broadcast_rb != NULL && broadcast_seen != NULL, "falha ao criar ring buffer broadcast");
+    if (!broadcast_rb || !broadcast_seen) {
+        free((void*) broadcast_seen);
+        tds_ringbuffer_destroy(broadcast_rb);
+        return;
+    }
+
+    pthread_t producer, consumers[BROADCAST_CONSUMERS];
+    for (uintptr_t i = 0; i < BROADCAST_CONSUMERS; i++) {
+        pthread_create(&consumers[i], NULL, broadcast_consumer, (void*) i);
+    }
+    pthread_create(&producer, NULL, spsc_producer, broadcast_rb);
+    pthread_join(producer, NULL);
+    for (int i = 0; i < BROADCAST_CONSUMERS; i++) {
+        pthread_join(consumers[i], NULL);
+        CHECK(broadcast_errors[i] == 0, "consumidor broadcast recebeu dados fora de ordem");
+    }
+    CHECK(tds_ringbuffer_empty(broadcast_rb), "ring buffer broadcast deveria terminar vazio");
+
+    free((void*) broadcast_seen);
+    tds_ringbuffer_destroy(broadcast_rb);
+    printf("Testes do ring buffer broadcast concluídos.\n");
+}
+
+#define DEQUE_THIEVES 3
+#define DEQUE_ITEMS   200000
+
+static tds_deque_t      deque_shared;
+static atomic_bool      deque_done;
+static _Atomic uint64_t deque_sum;
+static _Atomic uint32_t deque_count;
+
+static void* deque_thief(void* arg) {
+    (void) arg;
+    uint32_t value;
+    for (;;) {
+        bool done = atomic_load(&deque_done);
+        if (tds_deque_steal(deque_shared, &value)) {
+            atomic_fetch_add(&deque_sum, value);
+            atomic_fetch_add(&deque_count, 1);
+        } else if (done) {
+            return NULL;
+        }
+    }
+}
+
+void test_deque() {
+    printf("Iniciando testes do deque de roubo de trabalho...\n");
+
+    tds_deque_t d = tds_deque_create(2, sizeof(int));
+    CHECK(d != NULL && tds_deque_capacity(d) == 2, "falha ao criar deque");
+
+    int value;
+    for (int i = 0; i < 10; i++) {
+        CHECK(tds_deque_push(d, &i), "push no deque falhou");
+    }
+    CHECK(tds_deque_size(d) == 10 && tds_deque_capacity(d) == 16, "deque deveria crescer para 16");
+    CHECK(tds_deque_pop(d, &value) && value == 9, "pop deveria retirar o mais novo");
+    CHECK(tds_deque_steal(d, &value) && value == 0, "steal deveria retirar o mais antigo");
+    CHECK(tds_deque_steal(d, &value) && value == 1, "steal retornou valor incorreto");
+    for (int expected = 8; expected >= 2; expected--) {
+        CHECK(tds_deque_pop(d, &value) && value == expected, "ordem LIFO do dono incorreta");
+    }
+    CHECK(!tds_deque_pop(d, &value) && !tds_deque_steal(d, &value) && tds_deque_empty(d), "deque deveria estar vazio");
+    CHECK(tds_deque_destroy(d), "destroy do deque falhou");
+
+    // Dono empilha (e às vezes desempilha) enquanto ladrões roubam; o array cresce durante os roubos
+    deque_shared = tds_deque_create(4, sizeof(uint32_t));
+    atomic_store(&deque_done, false);
+    atomic_store(&deque_sum, 0);
+    atomic_store(&deque_count, 0);
+
+    pthread_t thieves[DEQUE_THIEVES];
+    for (int i = 0; i < DEQUE_THIEVES; i++) {
+        pthread_create(&thieves[i], NULL, deque_thief, NULL);
+    }
+
+    uint64_t owner_sum = 0;
+    uint32_t owner_count = 0, item;
+    for (uint32_t i = 0; i < DEQUE_ITEMS; i++) {
+        CHECK(tds_deque_push(deque_shared, &i), "push concorrente no deque falhou");
+        if (i % 3 == 0 && tds_deque_pop(deque_shared, &item)) {
+            owner_sum += item;
+            owner_count++;
+        }
+    }
+    while (tds_deque_pop(deque_shared, &item)) {
+        owner_sum += item;
+        owner_count++;
+    }
+    atomic_store(&deque_done, true);
+    for (int i = 0; i < DEQUE_THIEVES; i++) {
+        pthread_join(thieves[i], NULL);
+    }
+
+    CHECK(owner_count + atomic_load(&deque_count) == DEQUE_ITEMS, "elementos perdidos ou duplicados no deque");
+    CHECK(owner_sum + atomic_load(&deque_sum) == (uint64_t) DEQUE_ITEMS * (DEQUE_ITEMS - 1) / 2, "soma do deque incorreta");
+    tds_deque_destroy(deque_shared);
+
+    printf("Testes do deque concluídos.\n");
+}
+
+#if TDS_QUEUE_BLOCKING
+#define BLOCKING_THREADS 2
+#define BLOCKING_PER_THREAD 20000
+
+static tds_queue_t      blocking_queue;
+static _Atomic uint64_t blocking_sum;
+
+static uint64_t blocking_now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000u + (uint64_t) now.tv_nsec / 1000000u;
+}
+
+// Produtor bloqueante: a fila pequena obriga a esperar por espaço
+static void* blocking_producer(void* arg) {
+    (void) arg;
+    for (uint32_t i = 0; i < BLOCKING_PER_THREAD; i++) {
+        if (!tds_queue_enqueue_wait(blocking_queue, &i, TDS_QUEUE_WAIT_FOREVER)) {
+            printf("Erro: enqueue_wait sem timeout falhou.\n");
+            failures++;
+        }
+    }
+    return NULL;
+}
+
+// Consumidor bloqueante: dorme na fila vazia em vez de girar
+static void* blocking_consumer(void* arg) {
+    (void) arg;
+    uint32_t value;
+    for (uint32_t i = 0; i < BLOCKING_PER_THREAD; i++) {
+        if (tds_queue_dequeue_wait(blocking_queue, &value, TDS_QUEUE_WAIT_FOREVER)) {
+            atomic_fetch_add(&blocking_sum, value);
+        } else {
+            printf("Erro: dequeue_wait sem timeout falhou.\n");
+            failures++;
+        }
+    }
+    return NULL;
+}
+
+// Consumidor que fica estacionado até a thread principal enfileirar
+static void* blocking_late_consumer(void* arg) {
+    uint32_t* out = (uint32_t*) arg;
+    if (!tds_queue_dequeue_wait(blocking_queue, out, 5000)) {
+        *out = 0;
+    }
+    return NULL;
+}
+
+void test_blocking_queue() {
+    printf("Iniciando testes da fila bloqueante...\n");
+
+    tds_queue_config_t config = {.mode = TDS_QUEUE_MODE_MPMC, .allocator = NULL};
+    blocking_queue            = tds_queue_create_ex(8, sizeof(uint32_t), &config);
+    CHECK(blocking_queue != NULL, "falha ao criar a fila bloqueante");
+    if (!blocking_queue) {
+        return;
+    }
+
+    uint32_t value = 0;
+    uint64_t start = blocking_now_ms();
+    CHECK(!tds_queue_dequeue_wait(blocking_queue, &value, 30), "dequeue_wait em fila vazia deveria expirar");
+    CHECK(blocking_now_ms() - start >= 25, "dequeue_wait retornou antes do timeout");
+    CHECK(!tds_queue_dequeue_wait(blocking_queue, &value, 0), "timeout 0 deveria só tentar uma vez");
+
+    for (uint32_t i = 0; i < 8; i++) {
+        tds_queue_enqueue(blocking_queue, &i);
+    }
+    CHECK(!tds_queue_enqueue_wait(blocking_queue, &value, 10), "enqueue_wait em fila cheia deveria expirar");
+    CHECK(tds_queue_size(blocking_queue) == 8, "fila cheia alterada pelo timeout");
+    uint32_t drain[8];
+    tds_queue_dequeue_n(blocking_queue, drain, 8);
+
+    tds_queue_t ring = tds_queue_create_ex(8, sizeof(uint32_t), NULL);
+    CHECK(!tds_queue_dequeue_wait(ring, &value, 10), "fila não MPMC deveria rejeitar dequeue_wait");
+    tds_queue_destroy(ring);
+
+    // Consumidor estacionado é acordado por um enqueue comum
+    uint32_t  late = 0;
+    pthread_t waiter;
+    pthread_create(&waiter, NULL, blocking_late_consumer, &late);
+    struct timespec pause = {0, 50 * 1000000L};
+    nanosleep(&pause, NULL);
+    value = 42;
+    tds_queue_enqueue(blocking_queue, &value);
+    pthread_join(waiter, NULL);
+    CHECK(late == 42, "consumidor estacionado não foi acordado");
+
+    atomic_store(&blocking_sum, 0);
+    pthread_t producers[BLOCKING_THREADS], consumers[BLOCKING_THREADS];
+    for (int i = 0; i < BLOCKING_THREADS; i++) {
+        pthread_create(&producers[i], NULL, blocking_producer, NULL);
+        pthread_create(&consumers[i], NULL, blocking_consumer, NULL);
+    }
+    for (int i = 0; i < BLOCKING_THREADS; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+    }
+    uint64_t expected = (uint64_t) BLOCKING_THREADS * BLOCKING_PER_THREAD * (BLOCKING_PER_THREAD - 1) / 2;
+    CHECK(atomic_load(&blocking_sum) == expected, "soma da fila bloqueante incorreta");
+    CHECK(tds_queue_empty(blocking_queue), "fila bloqueante deveria terminar vazia");
+
+    tds_queue_destroy(blocking_queue);
+    printf("Testes da fila bloqueante concluídos.\n");
+}
+#endif
+
+#if TDS_RINGBUFFER_MMAP
+void test_mapped_ringbuffer() {
+    printf("Iniciando testes do ring buffer mapeado em arquivo...\n");
+
+    FILE* file = tmpfile();
+    CHECK(file != NULL, "falha ao criar arquivo temporário");
+    if (!file) {
+        return;
+    }
+
+    tds_ringbuffer_t rb = tds_ringbuffer_create_mapped(fileno(file), 100, sizeof(int));
+    CHECK(rb != NULL, "falha ao criar ring buffer mapeado");
+    if (!rb) {
+        fclose(file);
+        return;
+    }
+    int cap = tds_ringbuffer_capacity(rb);
+    CHECK(cap >= 128 && (cap & (cap - 1)) == 0, "capacidade do ring buffer mapeado incorreta");
+
+    // Levar as posições para perto do fim do buffer
+    int value;
+    for (int i = 0; i < cap - 10; i++) {
+        tds_ringbuffer_try_push(rb, &i);
+        tds_ringbuffer_try_pop(rb, &value);
+    }
+
+    int in[40], out[40];
+    for (int i = 0; i < 40; i++) {
+        in[i] = i;
+    }
+    CHECK(tds_ringbuffer_push_bulk(rb, in, 40) == 40, "push_bulk atravessando o fim deveria inserir 40");
+
+    uint32_t   n;
+    const int* r = (const int*) tds_ringbuffer_peek_span(rb, &n);
+    CHECK(r != NULL && n == 40 && r[9] == 9 && r[10] == 10 && r[39] == 39, "peek_span deveria ser contíguo após a volta");
+
+    int* w = (int*) tds_ringbuffer_reserve(rb, (uint32_t) cap, &n);
+    CHECK(w != NULL && n == (uint32_t) cap - 40, "reserve deveria conceder todo o espaço livre");
+
+    // Segundo mapeamento do mesmo arquivo (outro processo ou reinício)
+    tds_ringbuffer_t other = tds_ringbuffer_attach(fileno(file));
+    CHECK(other != NULL && tds_ringbuffer_size(other) == 40, "attach deveria ver os elementos existentes");
+    CHECK(tds_ringbuffer_pop_bulk(other, out, 20) == 20 && out[0] == 0 && out[19] == 19, "pop pelo segundo mapeamento incorreto");
+    CHECK(tds_ringbuffer_size(rb) == 20, "posições deveriam ser compartilhadas entre mapeamentos");
+    CHECK(tds_ringbuffer_destroy(other), "destroy do segundo mapeamento falhou");
+
+    // Reinício: o conteúdo não lido continua no arquivo
+    CHECK(tds_ringbuffer_destroy(rb), "destroy do ring buffer mapeado falhou");
+    rb = tds_ringbuffer_attach(fileno(file));
+    CHECK(rb != NULL && tds_ringbuffer_pop_bulk(rb, out, 40) == 20 && out[0] == 20 && out[19] == 39, "reabertura deveria preservar os dados");
+    CHECK(tds_ringbuffer_empty(rb), "ring buffer mapeado deveria terminar vazio");
+    tds_ringbuffer_destroy(rb);
+    fclose(file);
+
+    file = tmpfile();
+    if (file) {
+        fwrite(in, sizeof(in), 1, file);
+        fflush(file);
+        CHECK(tds_ringbuffer_attach(fileno(file)) == NULL, "attach de arquivo inválido deveria falhar");
+        fclose(file);
+    }
+
+    printf("Testes do ring buffer mapeado concluídos.\n");
+}
+#endif
+
+#if TDS_SNAPSHOT
+static uint64_t snapshot_other_hash(const void* key, size_t key_size) {
+    return tds_hashtable_hash_bytes(key, key_size) ^ 0x55;
+}
+
+// Grava o snapshot num arquivo temporário; path recebe o nome
+static bool snapshot_save(char* path, bool (*save)(void*, int), void* instance) {
+    strcpy(path, "/tmp/tds_snapshotXXXXXX");
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = save(instance, fd);
+    close(fd);
+    return ok;
+}
+
+// Lê o cabeçalho de 64 bytes de um snapshot gravado
+static bool snapshot_read_header(const char* path, tds_snapshot_header_t* header) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    bool ok = fread(header, sizeof(*header), 1, file) == 1;
+    fclose(file);
+    return ok;
+}
+
+static bool snapshot_queue(void* instance, int fd) {
+    return tds_queue_snapshot((tds_queue_t) instance, fd);
+}
+
+static bool snapshot_ringbuffer(void* instance, int fd) {
+    return tds_ringbuffer_snapshot((tds_ringbuffer_t) instance, fd);
+}
+
+static bool snapshot_hashtable(void* instance, int fd) {
+    return tds_hashtable_snapshot((tds_hashtable_t) instance, fd);
+}
+
+void test_snapshot() {
+    printf("Iniciando testes de snapshot/load...\n");
+    char path[32];
+    int  value;
+
+    // Fila: os três modos, com o anel já tendo dado a volta
+    const tds_queue_mode_t modes[] = {TDS_QUEUE_MODE_LINKED, TDS_QUEUE_MODE_RING, TDS_QUEUE_MODE_MPMC};
+    for (int m = 0; m < 3; m++) {
+        tds_queue_config_t config = TDS_QUEUE_CONFIG_DEFAULT;
+        config.mode               = modes[m];
+        tds_queue_t q             = tds_queue_create_ex(100, sizeof(int), &config);
+        for (int i = 0; i < 80; i++) {
+            tds_queue_enqueue(q, &i);
+        }
+        for (int i = 0; i < 50; i++) {
+            tds_queue_dequeue(q, &value);
+        }
+        for (int i = 80; i < 140; i++) {
+            tds_queue_enqueue(q, &i);
+        }
+        CHECK(snapshot_save(path, snapshot_queue, q), "falha ao gravar snapshot da fila");
+        tds_queue_destroy(q);
+
+        tds_snapshot_header_t header;
+        CHECK(snapshot_read_header(path, &header) && header.queue_mode == (uint32_t) modes[m] && header.key_size == 0 &&
+                  header.slot_size == 0 && header.consumers == 0,
+              "cabeçalho da fila deveria usar só os campos de fila");
+
+        q = tds_queue_load(path, NULL);
+        CHECK(q != NULL && tds_queue_size(q) == 90, "fila carregada com tamanho incorreto");
+        bool in_order = true;
+        for (int i = 50; q && i < 140; i++) {
+            in_order = in_order && tds_queue_dequeue(q, &value) && value == i;
+        }
+        CHECK(in_order, "fila carregada fora de ordem");
+        tds_queue_destroy(q);
+
+        tds_queue_config_t ring = {.mode = TDS_QUEUE_MODE_RING, .allocator = NULL};
+        q                       = tds_queue_load(path, &ring);
+        CHECK(q != NULL && tds_queue_peek(q, &value) && value == 50, "load com outro modo deveria funcionar");
+        tds_queue_destroy(q);
+        CHECK(tds_ringbuffer_load(path) == NULL && tds_hashtable_load(path, NULL) == NULL, "load de outro tipo deveria falhar");
+        unlink(path);
+    }
+
+    // Ring buffer broadcast: cada consumidor retoma de onde parou
+    uint32_t         depends[2] = {0, 0x1};
+    tds_ringbuffer_t rb         = tds_ringbuffer_create_broadcast(8, sizeof(int), 2, depends);
+    for (int i = 0; i < 6; i++) {
+        tds_ringbuffer_try_push(rb, &i);
+        tds_ringbuffer_broadcast_pop(rb, 0, &value);
+        tds_ringbuffer_broadcast_pop(rb, 1, &value);
+    }
+    for (int i = 6; i < 14; i++) {
+        tds_ringbuffer_try_push(rb, &i);
+    }
+    for (int i = 0; i < 5; i++) {
+        tds_ringbuffer_broadcast_pop(rb, 0, &value);
+    }
+    tds_ringbuffer_broadcast_consume(rb, 1, 2);
+    CHECK(snapshot_save(path, snapshot_ringbuffer, rb), "falha ao gravar snapshot do ring buffer");
+    tds_ringbuffer_destroy(rb);
+    tds_snapshot_header_t header;
+    CHECK(snapshot_read_header(path, &header) && header.consumers == 2 && header.queue_mode == 0 && header.slot_size == 0,
+          "cabeçalho do ring buffer deveria usar só os campos de ring buffer");
+
+    rb = tds_ringbuffer_load(path);
+    CHECK(rb != NULL && tds_ringbuffer_size(rb) == 6, "ring buffer carregado com tamanho incorreto");
+    CHECK(rb && tds_ringbuffer_broadcast_pop(rb, 0, &value) && value == 11, "consumidor 0 deveria retomar em 11");
+    CHECK(rb && tds_ringbuffer_broadcast_pop(rb, 1, &value) && value == 8, "consumidor 1 deveria retomar em 8");
+    int left = 0;
+    while (rb && tds_ringbuffer_broadcast_pop(rb, 1, &value)) {
+        left++;
+    }
+    CHECK(left == 3 && value == 11, "consumidor 1 deveria parar no consumidor 0");
+    tds_ringbuffer_destroy(rb);
+    unlink(path);
+
+    // Hashtable: com tombstones, nos dois modos, sem reinserir
+    for (int mode = 0; mode < 2; mode++) {
+        tds_hashtable_config_t config = TDS_HASHTABLE_CONFIG_DEFAULT;
+        config.concurrent             = mode == 1;
+        tds_hashtable_t ht            = tds_hashtable_create_ex(0, sizeof(uint32_t), sizeof(uint64_t), &config);
+        for (uint32_t i = 0; i < 5000; i++) {
+            uint64_t v = (uint64_t) i * 7;
+            tds_hashtable_put(ht, &i, &v);
+        }
+        for (uint32_t i = 0; i < 5000; i += 3) {
+            tds_hashtable_remove(ht, &i, NULL);
+        }
+        int capacity = tds_hashtable_capacity(ht);
+        CHECK(snapshot_save(path, snapshot_hashtable, ht), "falha ao gravar snapshot da hashtable");
+        tds_hashtable_destroy(ht);
+        CHECK(snapshot_read_header(path, &header) && header.key_size == sizeof(uint32_t) && header.slot_size >= sizeof(uint32_t) + sizeof(uint64_t) &&
+                  header.tombstones > 0 && header.queue_mode == 0 && header.consumers == 0,
+              "cabeçalho da hashtable deveria usar só os campos de hashtable");
+
+        ht = tds_hashtable_load(path, &config);
+        CHECK(ht != NULL && tds_hashtable_size(ht) == 3333 && tds_hashtable_capacity(ht) == capacity, "hashtable carregada com tamanho incorreto");
+        bool correct = true;
+        for (uint32_t i = 0; ht && i < 5000; i++) {
+            uint64_t v     = 0;
+            bool     found = tds_hashtable_get(ht, &i, &v);
+            correct        = correct && (i % 3 == 0 ? !found : found && v == (uint64_t) i * 7);
+        }
+        CHECK(correct, "hashtable carregada com conteúdo incorreto");
+        uint32_t key = 9;
+        uint64_t v   = 1;
+        CHECK(ht && tds_hashtable_put(ht, &key, &v) && tds_hashtable_size(ht) == 3334, "hashtable carregada deveria aceitar inserções");
+        tds_hashtable_destroy(ht);
+
+        config.hash = snapshot_other_hash;
+        CHECK(tds_hashtable_load(path, &config) == NULL, "load com outra função de hash deveria falhar");
+        unlink(path);
+    }
+
+    CHECK(tds_queue_load("/nonexistent/tds_snapshot", NULL) == NULL, "load de arquivo inexistente deveria falhar");
+    printf("Testes de snapshot/load concluídos.\n");
+}
+#endif
+
 int main() {
     // Criar a fila com capacidade suficiente para armazenar todos os elementos
     queue = tds_queue_create(NUM_OPERATIONS, sizeof(int));
@@ -62,5 +2133,42 @@ int main() {
         printf("Fila destruída com sucesso.\n");
     }
 
+    test_ring_queue();
+    test_pool_allocator();
+    test_spsc_ringbuffer();
+    test_mpmc_queue();
+    test_batch_operations();
+    test_zero_copy();
+    test_hashtable();
+    test_hashtable_incremental();
+    test_hashtable_batch();
+    test_typed_containers();
+    test_concurrent_hashtable();
+    test_stack_modes();
+    test_treiber_stack();
+    test_unrolled_list();
+    test_intrusive_list();
+    test_stats();
+    test_arena();
+    test_static_init();
+    test_heap();
+    test_deque();
+    test_cache();
+    test_broadcast_ringbuffer();
+#if TDS_QUEUE_BLOCKING
+    test_blocking_queue();
+#endif
+#if TDS_RINGBUFFER_MMAP
+    test_mapped_ringbuffer();
+#endif
+#if TDS_SNAPSHOT
+    test_snapshot();
+#endif
+
+    if (failures > 0) {
+        printf("%d falha(s) encontrada(s).\n", failures);
+        return 1;
+    }
+
     return 0;
 }
@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "tds_hashtable.h"
+#include "tds_heap.h"
+#include "tds_list.h"
+#include "tds_memory.h"
+#include "tds_queue.h"
+#include "tds_ringbuffer.h"
+#include "tds_stack.h"
+#include "tds_typed.h"
+
+// Compilado com TDS_NO_MALLOC=1 (tests/CMakeLists.txt): nada aqui pode depender do heap
+#if !TDS_NO_MALLOC
+#error "test_no_malloc precisa ser compilado com TDS_NO_MALLOC=1"
+#endif
+
+// Contador de falhas, usado como código de saída para o ctest
+static atomic_int failures = 0;
+
+#define CHECK(cond, msg)                                                  \
+    do {                                                                  \
+        if (!(cond)) {                                                    \
+            printf("Erro: %s (%s:%d)\n", msg, __FILE__, __LINE__);        \
+            failures++;                                                   \
+        }                                                                 \
+    } while (0)
+
+enum { CAP = 64 };
+
+static int heap_compare_int(const void* a, const void* b) {
+    int x = *(const int*) a, y = *(const int*) b;
+    return (x > y) - (x < y);
+}
+
+static inline uint64_t u32_hash(uint32_t key) {
+    return tds_hashtable_hash_bytes(&key, sizeof(key));
+}
+#define U32_EQ(a, b) ((a) == (b))
+
+TDS_DEFINE_QUEUE(int_queue, int)
+TDS_DEFINE_STACK(int_stack, int)
+TDS_DEFINE_HASHTABLE(u32_map, uint32_t, uint32_t, u32_hash, U32_EQ)
+
+// Sem heap, todo tds_*_create deve falhar em vez de alocar
+static void test_create_fails() {
+    printf("Iniciando testes de criação sem heap...\n");
+
+    CHECK(tds_queue_create(CAP, sizeof(int)) == NULL, "tds_queue_create deveria falhar sem heap");
+    CHECK(tds_stack_create(CAP, sizeof(int)) == NULL, "tds_stack_create deveria falhar sem heap");
+    CHECK(tds_ringbuffer_create(CAP, sizeof(int)) == NULL, "tds_ringbuffer_create deveria falhar sem heap");
+    CHECK(tds_list_create(CAP, sizeof(int)) == NULL, "tds_list_create deveria falhar sem heap");
+    CHECK(tds_hashtable_create(16, sizeof(int), sizeof(int)) == NULL, "tds_hashtable_create deveria falhar sem heap");
+    CHECK(tds_pool_create(64, CAP) == NULL, "tds_pool_create deveria falhar sem heap");
+    CHECK(tds_arena_create(4096) == NULL, "tds_arena_create deveria falhar sem heap");
+    CHECK(int_queue_create(CAP) == NULL && int_stack_create(CAP) == NULL && u32_map_create(CAP) == NULL,
+          "contêineres tipados deveriam falhar sem heap");
+
+    printf("Testes de criação sem heap concluídos.\n");
+}
+
+static void test_static_containers() {
+    printf("Iniciando testes de contêineres estáticos sem heap...\n");
+
+    static _Alignas(max_align_t) uint8_t pool_mem[TDS_POOL_STORAGE_SIZE(64, 2 * CAP)];
+    static _Alignas(max_align_t) uint8_t arena_mem[TDS_ARENA_STORAGE_SIZE(8192)];
+    static _Alignas(max_align_t) uint8_t ring_mem[TDS_QUEUE_STORAGE_SIZE(CAP, sizeof(int))];
+    static _Alignas(max_align_t) uint8_t mpmc_mem[TDS_QUEUE_MPMC_STORAGE_SIZE(CAP, sizeof(int))];
+    static _Alignas(max_align_t) uint8_t lqueue_mem[TDS_QUEUE_INSTANCE_SIZE];
+    static _Alignas(max_align_t) uint8_t astack_mem[TDS_STACK_STORAGE_SIZE(CAP, sizeof(int))];
+    static _Alignas(max_align_t) uint8_t lfstack_mem[TDS_STACK_LOCKFREE_STORAGE_SIZE(CAP, sizeof(int))];
+    static _Alignas(max_align_t) uint8_t rb_mem[TDS_RINGBUFFER_STORAGE_SIZE(CAP, sizeof(int))];
+    static _Alignas(max_align_t) uint8_t list_mem[TDS_LIST_INSTANCE_SIZE];
+    static _Alignas(max_align_t) uint8_t ht_mem[TDS_HASHTABLE_INSTANCE_SIZE];
+    static _Alignas(max_align_t) uint8_t heap_mem[TDS_HEAP_STORAGE_SIZE(CAP, sizeof(int))];
+
+    tds_pool_t  pool  = tds_pool_init_static(pool_mem, sizeof(pool_mem), 64, 2 * CAP);
+    tds_arena_t arena = tds_arena_init_static(arena_mem, sizeof(arena_mem));
+    CHECK(pool && arena, "falha ao criar pool/arena estáticos");
+    if (!pool || !arena) {
+        return;
+    }
+
+    tds_allocator_t    pool_alloc  = tds_pool_allocator(pool);
+    tds_allocator_t    arena_alloc = tds_arena_allocator(arena);
+    tds_queue_config_t qconfig     = {.mode = TDS_QUEUE_MODE_MPMC, .allocator = NULL};
+    tds_queue_config_t lqconfig    = {.mode = TDS_QUEUE_MODE_LINKED, .allocator = &pool_alloc};
+    tds_stack_config_t lfconfig    = {.mode = TDS_STACK_MODE_LOCKFREE, .allocator = NULL, .chunk = 0};
+    tds_list_config_t  lconfig     = {.allocator = &arena_alloc};
+    tds_heap_config_t  hpconfig    = {.compare = heap_compare_int, .arity = 0};
+
+    tds_queue_t      ring   = tds_queue_init_static(ring_mem, sizeof(ring_mem), CAP, sizeof(int), NULL);
+    tds_queue_t      mpmc   = tds_queue_init_static(mpmc_mem, sizeof(mpmc_mem), CAP, sizeof(int), &qconfig);
+    tds_queue_t      lqueue = tds_queue_init_static(lqueue_mem, sizeof(lqueue_mem), CAP, sizeof(int), &lqconfig);
+    tds_stack_t      astack = tds_stack_init_static(astack_mem, sizeof(astack_mem), CAP, sizeof(int), NULL);
+    tds_stack_t      lstack = tds_stack_init_static(lfstack_mem, sizeof(lfstack_mem), CAP, sizeof(int), &lfconfig);
+    tds_list_t       list   = tds_list_init_static(list_mem, sizeof(list_mem), CAP, sizeof(int), &lconfig);
+    tds_ringbuffer_t rb     = tds_ringbuffer_init_static(rb_mem, sizeof(rb_mem), CAP, sizeof(int));
+    tds_heap_t       heap   = tds_heap_init_static(heap_mem, sizeof(heap_mem), CAP, sizeof(int), &hpconfig);
+    CHECK(ring && mpmc && lqueue && astack && lstack && list && rb && heap, "falha ao criar contêineres estáticos");
+    if (!ring || !mpmc || !lqueue || !astack || !lstack || !list || !rb || !heap) {
+        return;
+    }
+
+    int value = 0, sum = 0;
+    for (int i = 0; i < CAP; i++) {
+        CHECK(tds_queue_enqueue(ring, &i) && tds_queue_enqueue(mpmc, &i) && tds_queue_enqueue(lqueue, &i), "enfileirar em fila estática falhou");
+        CHECK(tds_stack_push(astack, &i) && tds_stack_push(lstack, &i), "empilhar em pilha estática falhou");
+        CHECK(tds_list_push_back(list, &i) && tds_ringbuffer_try_push(rb, &i), "inserir em lista/ring buffer estático falhou");
+        int reversed = CAP - 1 - i;
+        CHECK(tds_heap_push(heap, &reversed, NULL), "inserir no heap estático falhou");
+    }
+    // A pilha em array não pode crescer sem heap
+    CHECK(!tds_queue_enqueue(ring, &value) && !tds_stack_push(astack, &value) && !tds_ringbuffer_try_push(rb, &value),
+          "contêineres estáticos deveriam estar cheios");
+
+    for (int i = 0; i < CAP / 2; i++) {
+        tds_queue_dequeue(ring, &value);
+        sum += value;
+        tds_queue_dequeue(mpmc, &value);
+        sum += value;
+        tds_queue_dequeue(lqueue, &value);
+        sum += value;
+        tds_stack_pop(astack, &value);
+        sum -= value;
+        tds_stack_pop(lstack, &value);
+        sum -= value;
+        tds_ringbuffer_try_pop(rb, &value);
+        sum += value;
+        tds_list_remove(list, 0, &value);
+        sum += value;
+        CHECK(tds_heap_pop(heap, &value) && value == i, "heap estático fora de ordem");
+    }
+    // 5 contêineres FIFO retiram 0..31, 2 pilhas LIFO retiram 63..32
+    CHECK(sum == 5 * (31 * 32 / 2) - 2 * ((32 + 63) * 32 / 2), "valores incorretos nos contêineres estáticos");
+
+    // Hashtable estática: tabelas e redimensionamentos vêm da arena
+    tds_hashtable_config_t hconfig = TDS_HASHTABLE_CONFIG_DEFAULT;
+    hconfig.allocator              = &arena_alloc;
+    tds_hashtable_t ht             = tds_hashtable_init_static(ht_mem, sizeof(ht_mem), 16, sizeof(int), sizeof(int), &hconfig);
+    CHECK(ht != NULL, "falha ao criar hashtable estática");
+    if (ht) {
+        for (int i = 0; i < 64; i++) {
+            int v = i * 3;
+            CHECK(tds_hashtable_put(ht, &i, &v), "put na hashtable estática falhou");
+        }
+        int key = 41;
+        CHECK(tds_hashtable_get(ht, &key, &value) && value == 123, "get na hashtable estática incorreto");
+        CHECK(tds_hashtable_destroy(ht), "destroy da hashtable estática falhou");
+    }
+
+    CHECK(tds_queue_destroy(ring) && tds_queue_destroy(mpmc) && tds_queue_destroy(lqueue), "destroy de fila estática falhou");
+    CHECK(tds_stack_destroy(astack) && tds_stack_destroy(lstack), "destroy de pilha estática falhou");
+    CHECK(tds_list_destroy(list) && tds_ringbuffer_destroy(rb) && tds_heap_destroy(heap), "destroy de lista/ring buffer/heap estático falhou");
+    CHECK(tds_pool_destroy(pool) && tds_arena_destroy(arena), "destroy de pool/arena estáticos falhou");
+    printf("Testes de contêineres estáticos sem heap concluídos.\n");
+}
+
+static void test_typed_init() {
+    printf("Iniciando testes de contêineres tipados sem heap...\n");
+
+    int            queue_items[CAP], stack_items[CAP];
+    u32_map_slot_t slots[CAP];
+    uint8_t        ctrl[CAP];
+    int_queue_t    queue;
+    int_stack_t    stack;
+    u32_map_t      map;
+    CHECK(int_queue_init(&queue, queue_items, CAP) && int_stack_init(&stack, stack_items, CAP) && u32_map_init(&map, slots, ctrl, CAP),
+          "falha ao inicializar contêineres tipados em memória do chamador");
+
+    for (int i = 0; i < CAP; i++) {
+        CHECK(int_queue_enqueue(&queue, i) && int_stack_push(&stack, i), "inserir em contêiner tipado estático falhou");
+    }
+    CHECK(!int_queue_enqueue(&queue, 0) && !int_stack_push(&stack, 0), "contêineres tipados estáticos não deveriam crescer");
+    int out = -1;
+    CHECK(int_queue_dequeue(&queue, &out) && out == 0, "fila tipada estática incorreta");
+    CHECK(int_stack_pop(&stack, &out) && out == CAP - 1, "pilha tipada estática incorreta");
+
+    // Janela deslizante: as lápides são removidas no lugar, sem crescer
+    for (uint32_t k = 0; k < 1000; k++) {
+        CHECK(u32_map_put(&map, k, k * 2), "falha ao inserir no mapa tipado estático");
+        if (k >= 40) {
+            CHECK(u32_map_remove(&map, k - 40), "falha ao remover do mapa tipado estático");
+        }
+    }
+    uint32_t value = 0;
+    CHECK(u32_map_size(&map) == 40 && u32_map_get(&map, 999, &value) && value == 1998, "mapa tipado estático incorreto");
+    CHECK(map.slots == slots, "mapa tipado estático não deveria crescer");
+
+    printf("Testes de contêineres tipados sem heap concluídos.\n");
+}
+
+int main() {
+    test_create_fails();
+    test_static_containers();
+    test_typed_init();
+
+    if (failures > 0) {
+        printf("%d falha(s) encontrada(s).\n", failures);
+        return 1;
+    }
+    return 0;
+}